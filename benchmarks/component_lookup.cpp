@@ -0,0 +1,143 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+// Compares component lookups through type ids and pools against the previous
+// unordered_map keyed by typeid(T).name(), on the same objects.
+
+#include "engine/object.h"
+#include "engine/component.h"
+
+#include <chrono>
+#include <memory>
+#include <stdio.h>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	template<uint32_t N>
+	class BenchComponent : public mge::Component
+	{
+	public:
+		float value = float(N + 1);
+
+	protected:
+		void preUpdate(double _dt) override {}
+		void postUpdate(double _dt) override {}
+	};
+
+	typedef BenchComponent<0> ComponentA;
+	typedef BenchComponent<1> ComponentB;
+	typedef BenchComponent<2> ComponentC;
+
+	/// Lookup as Object did before components had type ids.
+	///
+	struct MapComponents
+	{
+		std::unordered_map<std::string, std::shared_ptr<mge::Component>> components;
+
+		template<typename T>
+		std::shared_ptr<T> getComponent() const
+		{
+			auto it = components.find(typeid(T).name());
+			if (it != components.end())
+			{
+				return std::static_pointer_cast<T>(it->second);
+			}
+
+			return nullptr;
+		}
+	};
+
+	template<typename Func>
+	double measure(const char* _name, uint32_t _numItems, Func _func)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		const float sum = _func();
+		auto end = std::chrono::high_resolution_clock::now();
+
+		const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+		printf("%-32s: %8.3f ms, %6.2f ns per component (checksum %.0f)\n", _name, ms, ms * 1e6 / double(_numItems), sum);
+		return ms;
+	}
+}
+
+int main(int _argc, char** _argv)
+{
+	const uint32_t numObjects = 10000;
+	const uint32_t numFrames = 100;
+	const uint32_t numLookups = numObjects * numFrames * 3;
+
+	// Same components reachable both ways
+	std::vector<std::shared_ptr<mge::Object>> objects;
+	std::vector<MapComponents> maps(numObjects);
+	objects.reserve(numObjects);
+
+	for (uint32_t ii = 0; ii < numObjects; ++ii)
+	{
+		std::shared_ptr<mge::Object> object = std::make_shared<mge::Object>();
+		object->addComponent<ComponentA>();
+		object->addComponent<ComponentB>();
+		object->addComponent<ComponentC>();
+
+		maps[ii].components[typeid(ComponentA).name()] = object->getComponent<ComponentA>();
+		maps[ii].components[typeid(ComponentB).name()] = object->getComponent<ComponentB>();
+		maps[ii].components[typeid(ComponentC).name()] = object->getComponent<ComponentC>();
+
+		objects.push_back(object);
+	}
+
+	printf("%u objects, 3 components each, %u frames\n\n", numObjects, numFrames);
+
+	const double mapMs = measure("unordered_map<std::string>", numLookups, [&]()
+	{
+		float sum = 0.0f;
+		for (uint32_t frame = 0; frame < numFrames; ++frame)
+		{
+			for (const MapComponents& map : maps)
+			{
+				sum += map.getComponent<ComponentA>()->value;
+				sum += map.getComponent<ComponentB>()->value;
+				sum += map.getComponent<ComponentC>()->value;
+			}
+		}
+		return sum;
+	});
+
+	const double idMs = measure("Component type id", numLookups, [&]()
+	{
+		float sum = 0.0f;
+		for (uint32_t frame = 0; frame < numFrames; ++frame)
+		{
+			for (const std::shared_ptr<mge::Object>& object : objects)
+			{
+				sum += object->getComponent<ComponentA>()->value;
+				sum += object->getComponent<ComponentB>()->value;
+				sum += object->getComponent<ComponentC>()->value;
+			}
+		}
+		return sum;
+	});
+
+	// Visiting every component of a type, the way World::update gathers them
+	measure("Component pool iteration", numObjects * numFrames, [&]()
+	{
+		float sum = 0.0f;
+		const mge::ComponentPool* pool = mge::getComponentPool<ComponentA>();
+		for (uint32_t frame = 0; frame < numFrames; ++frame)
+		{
+			for (uint32_t ii = 0; ii < pool->getNumComponents(); ++ii)
+			{
+				sum += static_cast<const ComponentA*>(pool->getComponent(ii))->value;
+			}
+		}
+		return sum;
+	});
+
+	printf("\nType id lookup is %.1fx faster than the map\n", mapMs / idMs);
+	return 0;
+}
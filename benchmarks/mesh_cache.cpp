@@ -0,0 +1,119 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+// Vertex cache efficiency of every mesh in a scene before and after
+// optimizeModel, the same reordering optimizeScene saves. The scene file is
+// not modified. Without a path a grid with shuffled triangles is used.
+
+#include "objects/scene_format.h"
+#include "renderer/mesh_optimizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <utility>
+
+namespace
+{
+	static constexpr uint32_t kGridSize = 64; // Quads per side of the generated grid
+
+	mge::SceneModelData createShuffledGrid()
+	{
+		mge::SceneModelData model = {};
+		model.name = "shuffled grid";
+		model.vertexFormat = mge::VertexFormat::Full;
+
+		for (uint32_t yy = 0; yy <= kGridSize; ++yy)
+		{
+			for (uint32_t xx = 0; xx <= kGridSize; ++xx)
+			{
+				mge::Vertex vertex = {};
+				vertex.position = mge::Vec3(float(xx), 0.0f, float(yy));
+				vertex.normal = mge::Vec3(0.0f, 1.0f, 0.0f);
+				model.vertices.push_back(vertex);
+			}
+		}
+
+		std::vector<uint32_t> indices;
+		for (uint32_t yy = 0; yy < kGridSize; ++yy)
+		{
+			for (uint32_t xx = 0; xx < kGridSize; ++xx)
+			{
+				const uint32_t v0 = yy * (kGridSize + 1) + xx;
+				const uint32_t v1 = v0 + 1;
+				const uint32_t v2 = v0 + kGridSize + 1;
+				const uint32_t v3 = v2 + 1;
+
+				const uint32_t quad[] = { v0, v2, v1, v1, v2, v3 };
+				indices.insert(indices.end(), quad, quad + 6);
+			}
+		}
+
+		// Triangles in random order, close to the worst case for the cache
+		std::vector<uint32_t> triangles(indices.size() / 3);
+		for (uint32_t ii = 0; ii < (uint32_t)triangles.size(); ++ii)
+		{
+			triangles[ii] = ii;
+		}
+		std::shuffle(triangles.begin(), triangles.end(), std::mt19937(1));
+
+		mge::SceneSubMeshData submesh = {};
+		submesh.material = UINT32_MAX;
+		for (uint32_t triangle : triangles)
+		{
+			submesh.indices.insert(submesh.indices.end(), &indices[triangle * 3], &indices[triangle * 3] + 3);
+		}
+		model.submeshes.push_back(std::move(submesh));
+
+		return model;
+	}
+}
+
+int main(int _argc, char** _argv)
+{
+	mge::SceneData data;
+	if (_argc > 1)
+	{
+		if (!mge::readScene(_argv[1], data))
+		{
+			printf("Failed to read scene %s\n", _argv[1]);
+			return 1;
+		}
+	}
+	else
+	{
+		data.models.push_back(createShuffledGrid());
+	}
+
+	printf("%-32s %10s %16s %16s %10s\n", "Mesh", "Triangles", "ACMR", "ATVR", "Time");
+
+	mge::VertexCacheStats totalBefore = {};
+	mge::VertexCacheStats totalAfter = {};
+	for (mge::SceneModelData& model : data.models)
+	{
+		const mge::VertexCacheStats before = mge::analyzeModel(model);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		mge::optimizeModel(model);
+		auto end = std::chrono::high_resolution_clock::now();
+
+		const mge::VertexCacheStats after = mge::analyzeModel(model);
+		const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+		printf("%-32s %10u %7.3f -> %5.3f %7.3f -> %5.3f %7.2f ms\n", model.name.c_str(), before.numTriangles
+			, before.getAcmr(), after.getAcmr()
+			, before.getAtvr(), after.getAtvr()
+			, ms);
+
+		mge::addVertexCacheStats(totalBefore, before);
+		mge::addVertexCacheStats(totalAfter, after);
+	}
+
+	printf("%-32s %10u %7.3f -> %5.3f %7.3f -> %5.3f\n", "Total", totalBefore.numTriangles
+		, totalBefore.getAcmr(), totalAfter.getAcmr()
+		, totalBefore.getAtvr(), totalAfter.getAtvr());
+	return 0;
+}
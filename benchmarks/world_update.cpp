@@ -0,0 +1,105 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+// Times World::update on a synthetic world with the job system disabled and
+// enabled, see Settings::Scene::parallelUpdate.
+
+#include "engine/world.h"
+#include "engine/object.h"
+#include "engine/component.h"
+#include "engine/settings.h"
+#include "engine/job_system.h"
+
+#include <chrono>
+#include <math.h>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace
+{
+	static constexpr uint32_t kWorkIterations = 32; // Math per update, roughly a small gameplay component
+
+	static float work(float _value)
+	{
+		for (uint32_t ii = 0; ii < kWorkIterations; ++ii)
+		{
+			_value = sinf(_value) * 0.5f + cosf(_value * 0.25f);
+		}
+		return _value;
+	}
+
+	class BenchComponent : public mge::Component
+	{
+	public:
+		float value = 1.0f;
+
+		mge::UpdateMode::Enum getUpdateMode() const override { return mge::UpdateMode::Parallel; }
+
+	protected:
+		void preUpdate(double _dt) override { value = work(value + float(_dt)); }
+		void postUpdate(double _dt) override { value = work(value - float(_dt)); }
+	};
+
+	class BenchComponentB : public BenchComponent
+	{
+	};
+
+	class BenchObject : public mge::Object
+	{
+	public:
+		float value = 1.0f;
+
+		mge::UpdateMode::Enum getUpdateMode() const override { return mge::UpdateMode::Parallel; }
+
+	protected:
+		void update(double _dt) override { value = work(value + float(_dt)); }
+	};
+
+	double measure(mge::World& _world, uint32_t _numFrames, bool _parallel)
+	{
+		mge::getSettings().scene.parallelUpdate = _parallel;
+
+		// Warm up, first frames grow the update lists and start the workers
+		for (uint32_t ii = 0; ii < 4; ++ii)
+		{
+			_world.update();
+		}
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (uint32_t ii = 0; ii < _numFrames; ++ii)
+		{
+			_world.update();
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+
+		const double ms = std::chrono::duration<double, std::milli>(end - start).count() / double(_numFrames);
+		printf("%-10s: %8.3f ms per frame\n", _parallel ? "Parallel" : "Serial", ms);
+		return ms;
+	}
+}
+
+int main(int _argc, char** _argv)
+{
+	const uint32_t numObjects = _argc > 1 ? uint32_t(atoi(_argv[1])) : 20000;
+	const uint32_t numFrames = 100;
+
+	std::shared_ptr<mge::World> world = std::make_shared<mge::World>();
+	for (uint32_t ii = 0; ii < numObjects; ++ii)
+	{
+		std::shared_ptr<BenchObject> object = world->makeObject<BenchObject>();
+		object->addComponent<BenchComponent>();
+		object->addComponent<BenchComponentB>();
+	}
+
+	printf("%u objects, 2 components each, %u frames, %u workers\n\n",
+		numObjects, numFrames, mge::getJobSystem().getNumWorkers());
+
+	const double serialMs = measure(*world, numFrames, false);
+	const double parallelMs = measure(*world, numFrames, true);
+
+	printf("\nParallel update is %.1fx faster than serial\n", serialMs / parallelMs);
+	return 0;
+}
@@ -6,28 +6,184 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
 
 namespace mge
 {
+	class Object;
+
+	/// How an object or component is scheduled by `World::update`.
+	/// 
+	struct UpdateMode
+	{
+		enum Enum
+		{
+			Serial,   //!< Updated on the main thread after all parallel updates of the same group, preUpdate, update and postUpdate of each object back to back.
+			Parallel, //!< Updated on worker threads. Must only modify its own object and itself.
+		};
+	};
+
+	/// Dense index of a component type, assigned the first time the type is used.
+	/// 
+	typedef uint16_t ComponentTypeId;
+
 	/// Object Component.
 	///
 	class Component
 	{
 		friend class Object;
+		friend class World;
+		friend class ComponentPool;
 
 	public:
+		Component();
+
 		/// Get the owner of this component.
 		/// 
 		/// @returns Shared owner.
 		///
 		std::shared_ptr<Object> getOwner();
 
+		/// Get how this component can be scheduled.
+		/// 
+		/// @returns Update mode, serial by default.
+		/// 
+		virtual UpdateMode::Enum getUpdateMode() const { return UpdateMode::Serial; }
+
+		/// Get the update group of this component. Groups are updated in 
+		/// ascending order, so a component that depends on the result of 
+		/// another component must be in a higher group.
+		/// 
+		/// @returns Update group, 0 by default.
+		/// 
+		virtual uint32_t getUpdateGroup() const { return 0; }
+
 	protected:
 		virtual void preUpdate(double _dt) = 0;
 		virtual void postUpdate(double _dt) = 0;
 
 	private:
 		std::shared_ptr<Object> m_owner;
+		uint32_t m_poolIndex; // Index in the pool component list
+	};
+
+	/// Storage for all components of one type.
+	/// 
+	/// Components are constructed in fixed size chunks so components of the 
+	/// same type are close in memory, and live components are kept in a dense 
+	/// list for iteration.
+	/// 
+	/// @remark Allocating and freeing is thread safe. The component list must 
+	/// not be iterated while components are added or removed.
+	/// 
+	class ComponentPool
+	{
+	public:
+		ComponentPool(ComponentTypeId _type, uint32_t _size, uint32_t _align);
+		~ComponentPool();
+
+		/// Allocate uninitialized memory for one component.
+		/// 
+		/// @returns Pointer to memory.
+		/// 
+		void* alloc();
+
+		/// Free memory of a component that has been destroyed.
+		/// 
+		/// @param[in] _ptr Pointer returned by `alloc`.
+		/// 
+		void free(void* _ptr);
+
+		/// Add a constructed component to the component list.
+		/// 
+		/// @param[in] _component Component allocated from this pool.
+		/// 
+		void insert(Component* _component);
+
+		/// Remove a component from the component list before it is destroyed.
+		/// 
+		/// @param[in] _component Component allocated from this pool.
+		/// 
+		void erase(Component* _component);
+
+		/// Get the type of components in this pool.
+		/// 
+		/// @returns Component type id.
+		/// 
+		ComponentTypeId getType() const;
+
+		/// Get number of live components.
+		/// 
+		/// @returns Number of components.
+		/// 
+		uint32_t getNumComponents() const;
+
+		/// Get live component.
+		/// 
+		/// @param[in] _idx Index in range [0, getNumComponents()).
+		/// 
+		/// @returns Component.
+		/// 
+		Component* getComponent(uint32_t _idx) const;
+
+	private:
+		ComponentTypeId m_type;
+		uint32_t m_stride;
+		uint32_t m_align;
+
+		std::vector<uint8_t*> m_chunks;
+		std::vector<void*> m_free;
+		std::vector<Component*> m_components;
+		std::mutex m_mutex;
 	};
 
+	/// Create the pool for a new component type.
+	/// 
+	/// @remark Use `getComponentPool<T>` instead.
+	/// 
+	/// @param[in] _size Size of the component type.
+	/// @param[in] _align Alignment of the component type.
+	/// 
+	/// @returns Component pool.
+	/// 
+	ComponentPool* createComponentPool(uint32_t _size, uint32_t _align);
+
+	/// Get number of component types that have been used.
+	/// 
+	/// @returns Number of component types.
+	/// 
+	uint32_t getNumComponentTypes();
+
+	/// Get the pool of a component type.
+	/// 
+	/// @param[in] _type Component type id.
+	/// 
+	/// @returns Component pool.
+	/// 
+	ComponentPool* getComponentPool(ComponentTypeId _type);
+
+	/// Get the pool of a component type.
+	/// 
+	/// @returns Component pool.
+	/// 
+	template<typename T>
+	ComponentPool* getComponentPool()
+	{
+		static ComponentPool* s_pool = createComponentPool(uint32_t(sizeof(T)), uint32_t(alignof(T)));
+		return s_pool;
+	}
+
+	/// Get the type id of a component type.
+	/// 
+	/// @returns Component type id.
+	/// 
+	template<typename T>
+	ComponentTypeId getComponentTypeId()
+	{
+		static const ComponentTypeId s_type = getComponentPool<T>()->getType();
+		return s_type;
+	}
+
 } // namespace mge
\ No newline at end of file
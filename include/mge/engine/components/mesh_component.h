@@ -18,6 +18,7 @@ namespace mge
 	class MeshComponent : public Component
 	{
 		friend class Scene;
+		friend class World;
 		friend class GBuffer;
 		friend class ShadowMapping;
 
@@ -25,6 +26,8 @@ namespace mge
 		MeshComponent(std::shared_ptr<Mesh> _mesh);
 		~MeshComponent();
 
+		UpdateMode::Enum getUpdateMode() const override { return UpdateMode::Parallel; }
+
 	protected:
 		void preUpdate(double _dt) override;
 		void postUpdate(double _dt) override;
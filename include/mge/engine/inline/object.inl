@@ -3,9 +3,9 @@
  * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
  */
 
+#include <new>
 #include <utility>
 #include <type_traits>
-#include <typeinfo>
 
 namespace mge
 {
@@ -15,16 +15,29 @@ namespace mge
         static_assert(std::is_base_of<Component, T>::value,
             "T must be a subclass of Component");
 
-        const char* name = typeid(T).name();
+        ComponentPool* pool = getComponentPool<T>();
+        const ComponentTypeId type = pool->getType();
 
-        auto it = m_components.find(name);
-        if (it != m_components.end())
+        if (type < m_components.size() && m_components[type] != nullptr)
         {
             return;
         }
 
-        m_components[name] = std::make_shared<T>(std::forward<Args>(_args)...);
-        m_components[name]->m_owner = shared_from_this();
+        if (type >= m_components.size())
+        {
+            m_components.resize(type + 1);
+        }
+
+        T* component = new (pool->alloc()) T(std::forward<Args>(_args)...);
+        component->m_owner = shared_from_this();
+        pool->insert(component);
+
+        m_components[type] = std::shared_ptr<T>(component, [pool](T* _component)
+            {
+                pool->erase(_component);
+                _component->~T();
+                pool->free(_component);
+            });
     }
    
     template<typename T>
@@ -33,12 +46,11 @@ namespace mge
         static_assert(std::is_base_of<Component, T>::value,
             "T must be a subclass of Component");
 
-        const char* name = typeid(T).name();
+        const ComponentTypeId type = getComponentTypeId<T>();
 
-        auto it = m_components.find(name);
-        if (it != m_components.end())
+        if (type < m_components.size())
         {
-            return std::static_pointer_cast<T>(it->second);
+            return std::static_pointer_cast<T>(m_components[type]);
         }
 
         return nullptr;
@@ -12,6 +12,7 @@ namespace mge
     {
         std::shared_ptr<T> object = std::make_shared<T>(std::forward<Args>(_args)...);
         m_objects.push_back(object);
+        registerObject(object);
         return object;
     }
 
@@ -647,5 +647,39 @@ namespace mge
         return quat_from_cols(c0, c1, c2);
     }
 
+    /// Axis Aligned Bounding Box
+    struct Aabb
+    {
+        Aabb()
+            : min(Vec3()), max(Vec3())
+        {}
+
+        Aabb(Vec3 _min, Vec3 _max)
+            : min(_min), max(_max)
+        {}
+
+        Vec3 min, max;
+    };
+
+    ///
+    static inline Vec3 aabb_center(Aabb b)
+    {
+        return (b.min + b.max) * 0.5f;
+    }
+
+    ///
+    static inline Vec3 aabb_extents(Aabb b)
+    {
+        return (b.max - b.min) * 0.5f;
+    }
+
+    ///
+    static inline Aabb aabb_expand(Aabb b, Vec3 p)
+    {
+        return Aabb(
+            Vec3(minf(b.min.x, p.x), minf(b.min.y, p.y), minf(b.min.z, p.z)),
+            Vec3(maxf(b.max.x, p.x), maxf(b.max.y, p.y), maxf(b.max.z, p.z)));
+    }
+
 } // namespace mge
 
@@ -16,6 +16,15 @@ namespace mge
 {
 	class Material;
 
+	/// Range of vertices or indices in the shared geometry buffers.
+	/// 
+	struct GeometryRange
+	{
+		uint16_t page; // UINT16_MAX if empty
+		uint32_t first;
+		uint32_t count;
+	};
+
 	/// Sub Mesh.
 	/// 
 	class SubMesh
@@ -23,9 +32,13 @@ namespace mge
 		friend class Scene;
 		friend class GBuffer;
 		friend class ShadowMapping;
+		friend class GeometryArena;
 
 	public:
 		SubMesh(const std::vector<uint32_t>& _indices, std::shared_ptr<Material> _material = nullptr);
+		SubMesh(const std::vector<uint16_t>& _indices, std::shared_ptr<Material> _material = nullptr);
+		SubMesh(const uint32_t* _indices, uint32_t _numIndices, std::shared_ptr<Material> _material, std::shared_ptr<const void> _storage);
+		SubMesh(const uint16_t* _indices, uint32_t _numIndices, std::shared_ptr<Material> _material, std::shared_ptr<const void> _storage);
 		~SubMesh();
 
 		/// Create a Sub Mesh.
@@ -33,19 +46,71 @@ namespace mge
 		/// @param[in] _indices List of indices to shared vertices in parent mesh.
 		/// @param[in] _material Material to be used to render this sub mesh. 
 		/// 
+		/// @remark Indices are stored as 16-bit if every index fits.
+		/// 
 		/// @returns Shared Sub Mesh.
 		/// 
 		friend std::shared_ptr<SubMesh> createSubMesh(const std::vector<uint32_t>& _indices, std::shared_ptr<Material> _material = nullptr);
 
+		/// Create a Sub Mesh with 16-bit indices.
+		/// 
+		/// @param[in] _indices List of indices to shared vertices in parent mesh.
+		/// @param[in] _material Material to be used to render this sub mesh. 
+		/// 
+		/// @returns Shared Sub Mesh.
+		/// 
+		friend std::shared_ptr<SubMesh> createSubMesh(const std::vector<uint16_t>& _indices, std::shared_ptr<Material> _material = nullptr);
+
 		/// Set the material for this sub mesh.
 		/// 
 		/// @param[in] _material Shared material to be used for rendering this sub mesh.
 		/// 
 		void setMaterial(std::shared_ptr<Material> _material);
 
+		/// Get the number of levels of detail.
+		/// 
+		/// @returns Number of levels, the first is the sub mesh itself.
+		/// 
+		uint32_t getNumLods() const;
+
+		/// Get how far a level of detail deviates from the sub mesh.
+		/// 
+		/// @param[in] _lod Level of detail.
+		/// 
+		/// @returns Error relative to the size of the parent mesh.
+		/// 
+		float getLodError(uint32_t _lod) const;
+
 	private:
-		bgfx::IndexBufferHandle m_ibh;
-		std::vector<uint32_t> m_indices;
+		struct Lod
+		{
+			GeometryRange indexRange;
+			std::shared_ptr<const void> storage; // Keeps indices alive
+			const void* indexData; // Same index width as the sub mesh
+			uint32_t numIndices;
+			float error;
+		};
+
+		void upload();
+
+		/// Add a coarser level of detail, indices are copied.
+		void addLod(const std::vector<uint32_t>& _indices, float _error);
+
+		/// Add a coarser level of detail referencing external indices.
+		void addLod(const void* _indices, uint32_t _numIndices, float _error, std::shared_ptr<const void> _storage);
+
+		/// Get index of a level of detail, regardless of index width.
+		uint32_t getIndex(uint32_t _lod, uint32_t _idx) const;
+		uint32_t getNumIndices(uint32_t _lod) const;
+
+		GeometryRange m_indexRange;
+		std::vector<uint32_t> m_indices32; // Empty if indices are 16-bit or external
+		std::vector<uint16_t> m_indices16; // Empty if indices are 32-bit or external
+		std::shared_ptr<const void> m_storage; // Keeps external indices alive
+		const void* m_indexData;
+		uint32_t m_numIndices;
+		bool m_index32;
+		std::vector<Lod> m_lods; // Coarser levels of detail, finest first
 		std::shared_ptr<Material> m_material;
 	};
 
@@ -56,10 +121,12 @@ namespace mge
 		friend class Scene;
 		friend class GBuffer;
 		friend class ShadowMapping;
+		friend class GeometryArena;
 
 	public:
-		Mesh(const std::vector<Vertex>& _vertices, const std::vector<std::shared_ptr<SubMesh>>& _submeshes);
+		Mesh(const std::vector<Vertex>& _vertices, const std::vector<std::shared_ptr<SubMesh>>& _submeshes, VertexFormat::Enum _format = VertexFormat::Full);
 		Mesh(const std::vector<Vertex>& _vertices, const std::vector<uint32_t>& _indices);
+		Mesh(const Vertex* _vertices, uint32_t _numVertices, const std::vector<std::shared_ptr<SubMesh>>& _submeshes, std::shared_ptr<const void> _storage, VertexFormat::Enum _format = VertexFormat::Full);
 		~Mesh();
 
 		/// Create a mesh from a list of vertices and sub-meshes.
@@ -97,9 +164,23 @@ namespace mge
 		/// 
 		void setMaterial(std::shared_ptr<Material> _material, uint32_t _idx);
 
+		/// Get the bounding box of the mesh.
+		/// 
+		/// @returns Bounding box enclosing all vertices in local space.
+		/// 
+		const Aabb& getBounds() const;
+
 	private:
-		bgfx::VertexBufferHandle m_vbh;
-		std::vector<Vertex> m_vertices;
+		void upload();
+
+		GeometryRange m_vertexRange;
+		VertexFormat::Enum m_vertexFormat;
+		std::vector<PackedVertex> m_packedVertices; // Uploaded instead if the format is packed
+		Aabb m_bounds;
+		std::vector<Vertex> m_vertices; // Empty if vertices are external
+		std::shared_ptr<const void> m_storage; // Keeps external vertices alive
+		const Vertex* m_vertexData;
+		uint32_t m_numVertices;
 		std::vector<std::shared_ptr<SubMesh>> m_submeshes;
 	};
 
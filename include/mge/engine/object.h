@@ -7,10 +7,10 @@
 
 #include "engine/math.h"
 #include "engine/component.h"
+#include "engine/transform.h"
 
 #include <memory>
-#include <string>
-#include <unordered_map>
+#include <vector>
 
 namespace mge
 {
@@ -22,9 +22,6 @@ namespace mge
 	{
 		friend class World;
 
-		void preUpdate(double _dt);
-		void postUpdate(double _dt);
-
 	public:
 		Object();
 		~Object();
@@ -70,6 +67,27 @@ namespace mge
 		/// 
 		Vec3 getScale() const;
 
+		/// Set the parent of the object. The transform of the object becomes 
+		/// relative to the parent.
+		/// 
+		/// @param[in] _parent The new parent, or nullptr to detach.
+		/// 
+		void setParent(std::shared_ptr<Object> _parent);
+
+		/// Get the world transform matrix of the object.
+		/// 
+		/// @remark Updated once per frame before rendering.
+		/// 
+		/// @returns World matrix.
+		/// 
+		const float* getWorldMatrix() const;
+
+		/// Get the handle to the transform of the object.
+		/// 
+		/// @returns Transform handle.
+		/// 
+		TransformHandle getTransform() const;
+
 		/// Add component of type.
 		/// 
 		/// @param[in] _args Component arguments.
@@ -84,14 +102,26 @@ namespace mge
 		template<typename T>
 		std::shared_ptr<T> getComponent() const;  
 
+		/// Get how this object can be scheduled.
+		/// 
+		/// @returns Update mode, serial by default.
+		/// 
+		virtual UpdateMode::Enum getUpdateMode() const { return UpdateMode::Serial; }
+
+		/// Get the update group of this object, see `Component::getUpdateGroup`.
+		/// 
+		/// @returns Update group, 0 by default.
+		/// 
+		virtual uint32_t getUpdateGroup() const { return 0; }
+
 	protected:
 		virtual void update(double _dt) {};
 
+		World* m_world; // World this object is updated in
+
 	private:
-		std::unordered_map<std::string, std::shared_ptr<Component>> m_components;
-		Vec3 m_position;
-		Quat m_rotation;
-		Vec3 m_scale;
+		std::vector<std::shared_ptr<Component>> m_components; // Indexed by component type id
+		TransformHandle m_transform;
 	};
 
 	/// Create a world object of type.
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#pragma once
+
+#include "engine/object.h"
+
+#include <memory>
+
+namespace mge
+{
+	class World;
+
+	struct LightType
+	{
+		enum Enum
+		{
+			Point,
+			Spot, // Shines along -Z of the object
+
+			Count
+		};
+	};
+
+	/// Local light, positioned by the object transform.
+	///
+	class Light : public Object
+	{
+		friend class World;
+
+	public:
+		Light(LightType::Enum _type);
+		~Light();
+
+		/// Create a point light.
+		///
+		/// @param[in] _world The world the light should exist in.
+		///
+		/// @returns Shared Light.
+		///
+		friend std::shared_ptr<Light> createPointLight(std::shared_ptr<World> _world);
+
+		/// Create a spot light.
+		///
+		/// @param[in] _world The world the light should exist in.
+		///
+		/// @returns Shared Light.
+		///
+		friend std::shared_ptr<Light> createSpotLight(std::shared_ptr<World> _world);
+
+		/// Get the type of the light.
+		///
+		/// @returns Light type.
+		///
+		LightType::Enum getType() const;
+
+		/// Set the color of the light.
+		///
+		/// @param[in] _color Linear color.
+		///
+		void setColor(const Vec3& _color);
+
+		/// Get the color of the light.
+		///
+		/// @returns Linear color.
+		///
+		Vec3 getColor() const;
+
+		/// Set the intensity of the light, multiplied with the color.
+		///
+		/// @param[in] _intensity Intensity.
+		///
+		void setIntensity(float _intensity);
+
+		/// Get the intensity of the light.
+		///
+		/// @returns Intensity.
+		///
+		float getIntensity() const;
+
+		/// Set the distance the light reaches. Light fades out towards it and
+		/// nothing past it is lit.
+		///
+		/// @param[in] _range Distance in world units.
+		///
+		void setRange(float _range);
+
+		/// Get the distance the light reaches.
+		///
+		/// @returns Distance in world units.
+		///
+		float getRange() const;
+
+		/// Set the cone of a spot light.
+		///
+		/// @param[in] _innerAngle Half angle of the fully lit cone (in degrees).
+		/// @param[in] _outerAngle Half angle the light has faded out at (in degrees).
+		///
+		void setSpotAngles(float _innerAngle, float _outerAngle);
+
+		/// Get the half angle of the fully lit cone.
+		///
+		/// @returns Angle in degrees.
+		///
+		float getSpotInnerAngle() const;
+
+		/// Get the half angle the light has faded out at.
+		///
+		/// @returns Angle in degrees.
+		///
+		float getSpotOuterAngle() const;
+
+	private:
+		LightType::Enum m_type;
+		Vec3 m_color;
+		float m_intensity;
+		float m_range;
+		float m_innerAngle;
+		float m_outerAngle;
+		uint32_t m_lightProxy; // Index in world lights
+	};
+
+} // namespace mge
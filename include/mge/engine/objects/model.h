@@ -18,6 +18,8 @@ namespace mge
 	/// 
 	class Model : public Object
 	{
+		friend class World;
+
 	public:
 		Model();
 		~Model();
@@ -35,6 +37,11 @@ namespace mge
 		/// @param[in] _mesh The mesh to be added.
 		/// 
 		void addMesh(std::shared_ptr<Mesh> _mesh);
+
+		UpdateMode::Enum getUpdateMode() const override { return UpdateMode::Parallel; }
+
+	private:
+		uint32_t m_renderProxy; // Index in world render proxies
 	};
 
 } // namespace mge
\ No newline at end of file
@@ -22,6 +22,9 @@ namespace mge
 	class Model;
 	class Material;
 	class Texture;
+	class MappedFile;
+	class Scene;
+	struct SceneData;
 
 	/// Maya Bridge Session.
 	/// 
@@ -29,13 +32,13 @@ namespace mge
 	{
 		friend class Scene;
 
-		void begin(std::unordered_map<std::string, std::shared_ptr<Model>>& _models);
-		void update(std::unordered_map<std::string, std::shared_ptr<Model>>& _models);
+		void begin(Scene& _scene);
+		void update(Scene& _scene);
 		void end();
 		bool isValid();
 
-		void modelAdded(std::unordered_map<std::string, std::shared_ptr<Model>>& _models, const mb::Model& _model);
-		void materialAdded(std::unordered_map<std::string, std::shared_ptr<Model>>& _models, const mb::Material& _material);
+		void modelAdded(Scene& _scene, const mb::Model& _model);
+		void materialAdded(Scene& _scene, const mb::Material& _material);
 
 	public:
 		MayaSession(const char* _filepath);
@@ -53,17 +56,17 @@ namespace mge
 	/// 
 	class Scene : public Object
 	{
+		friend class World;
 		friend class GBuffer;
 		friend class ShadowMapping;
+		friend class MayaSession;
 
-		void write(FILE* _file);
-		void read(FILE* _file);
-
-		void writeTexture(FILE* _file, std::shared_ptr<Texture> _texture);
-		std::shared_ptr<Texture> readTexture(FILE* _file);
-
-		void writeString(FILE* _file, const std::string& _str);
-		std::string readString(FILE* _file);
+		void setModel(const std::string& _name, std::shared_ptr<Model> _model);
+		void clearModels();
+		void write(FILE* _file, bool _optimizeMeshes);
+		void read(const char* _filepath);
+		void readMapped(std::shared_ptr<MappedFile> _file);
+		void readData(const SceneData& _data);
 
 	public:
 		Scene();
@@ -94,10 +97,12 @@ namespace mge
 		/// Save the scene.
 		/// 
 		/// @param[in] _filepath Path to save scene to.
+		/// @param[in] _optimizeMeshes Reorder triangles and vertices of saved meshes, 
+		/// see optimizeScene.
 		/// 
 		/// @remark If a path is passed as nullptr, it will save to loaded path.
 		/// 
-		void save(const char* _filepath);
+		void save(const char* _filepath, bool _optimizeMeshes = false);
 
 		/// Begin maya session.
 		/// 
@@ -124,4 +129,54 @@ namespace mge
 		std::unique_ptr<MayaSession> m_mayaSession;
 	};
 
+	/// Convert a scene file saved in the version 1 format, written before 
+	/// scenes became a single mappable blob, to the current format.
+	/// 
+	/// @param[in] _srcFilepath Path of the version 1 scene.
+	/// @param[in] _dstFilepath Path to write the converted scene to.
+	/// 
+	/// @remark Does not require a renderer, textures are only referenced by path.
+	/// 
+	/// @returns True if the scene was converted.
+	/// 
+	bool convertScene(const char* _srcFilepath, const char* _dstFilepath);
+
+	/// Cook the textures referenced by a scene to GPU compressed formats with 
+	/// full mip chains. Scenes loaded afterwards use the cooked textures.
+	/// 
+	/// @param[in] _filepath Path of the scene.
+	/// @param[in] _highQuality Use BC7 for color textures, much slower to cook.
+	/// 
+	/// @remark Does not require a renderer. Cooked textures are cached by content 
+	/// hash, so cooking again only cooks textures that changed.
+	/// 
+	/// @returns True if every texture was cooked.
+	/// 
+	bool cookScene(const char* _filepath, bool _highQuality = false);
+
+	/// Vertex cache efficiency of the meshes in a scene, before and after 
+	/// optimizeScene. ACMR is vertices transformed per triangle, ATVR vertices 
+	/// transformed per unique vertex.
+	/// 
+	struct MeshCacheReport
+	{
+		float acmrBefore;
+		float acmrAfter;
+		float atvrBefore;
+		float atvrAfter;
+	};
+
+	/// Optimize the meshes of a scene for rendering and save it in place. 
+	/// Triangles are reordered for the post-transform vertex cache and 
+	/// then for less overdraw, vertices in the order they are fetched.
+	/// 
+	/// @param[in] _filepath Path of the scene.
+	/// @param[out] _report Vertex cache efficiency before and after, can be nullptr.
+	/// 
+	/// @remark Does not require a renderer. Per mesh results are traced.
+	/// 
+	/// @returns True if the scene was optimized and saved.
+	/// 
+	bool optimizeScene(const char* _filepath, MeshCacheReport* _report = nullptr);
+
 } // namespace mge
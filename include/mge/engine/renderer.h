@@ -17,11 +17,14 @@ namespace mge
 	struct CommonResources;
 
 	class Window;
+	class World;
 	class Camera;
 	class ShadowMapping;
 	class GBuffer;
+	class Deferred;
 	class Skybox;
 	class ToneMapping;
+	class TemporalAA;
 	class Imgui;
 
 	/// Renderer.
@@ -32,6 +35,7 @@ namespace mge
 		friend class Imgui;
 
 		void dbgTextPrintStats(const bgfx::Stats* _stats);
+		void updateResolutionScale(const bgfx::Stats* _stats);
 
 		void update(std::shared_ptr<World> _world, std::shared_ptr<Camera> _camera);
 		void postUpdate();
@@ -64,9 +68,21 @@ namespace mge
 		std::shared_ptr<CommonResources> m_common;
 		std::shared_ptr<ShadowMapping> m_shadowmapping;
 		std::shared_ptr<GBuffer> m_gbuffer;
+		std::shared_ptr<Deferred> m_deferred;
 		std::shared_ptr<Skybox> m_skybox;
 		std::shared_ptr<ToneMapping> m_tonemapping;
+		std::shared_ptr<TemporalAA> m_temporalaa;
 		std::shared_ptr<Imgui> m_imgui;
+
+		uint32_t m_resolutionFrames;
+		float m_resolutionGpuTime;
+		uint32_t m_frameIndex;
+
+		// Configuration frames were submitted with, GPU stats lag behind submission
+		uint32_t m_statsLayout;
+		uint16_t m_statsWidth;
+		uint16_t m_statsHeight;
+		uint32_t m_statsStableFrames; // Submitted in a row with the same configuration
 	};
 
 } // namespace mge
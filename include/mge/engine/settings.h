@@ -15,6 +15,12 @@ namespace mge
 	{
 		struct Scene
 		{
+			Scene()
+				: parallelUpdate(true)
+			{
+			}
+
+			bool parallelUpdate; // Update parallel objects and components on worker threads
 
 		} scene;
 
@@ -26,11 +32,57 @@ namespace mge
 		struct Renderer
 		{
 			Renderer()
-				: shadowMapRes(512)
+				: shadowMapRes(1024)
+				, shadowCascades(4)
+				, shadowDistance(150.0f)
+				, shadowSplitLambda(0.75f)
+				, shadowCaching(true)
+				, depthPrepass(true)
+				, compactGBuffer(true)
+				, lightDistance(250.0f)
+				, sunIntensity(3.0f)
+				, ambientIntensity(0.2f)
+				, exposure(1.0f)
+				, dynamicResolution(false)
+				, gpuFrameBudget(16.0f)
+				, minResolutionScale(0.5f)
+				, maxResolutionScale(1.0f)
+				, temporalAA(true)
+				, temporalBlend(0.1f)
+				, instancing(true)
+				, parallelSubmit(true)
+				, textureUploadBudget(8 << 20)
+				, textureDecodeThreads(2)
+				, textureBudget(1024)
+				, lodThreshold(1.0f)
+				, shadowLodBias(4.0f)
 			{
 			}
 
-			uint32_t shadowMapRes;
+			uint32_t shadowMapRes; // Resolution of each shadow cascade
+			uint32_t shadowCascades; // Shadow cascades splitting the view frustum, at most ShadowMapping::kMaxCascades
+			float shadowDistance; // Distance from the camera shadows are rendered to
+			float shadowSplitLambda; // Blend between uniform (0) and logarithmic (1) cascade splits
+			bool shadowCaching; // Keep static casters in a cached shadow map, redrawn when the light or static models change
+			bool depthPrepass; // Lay down opaque depth first so the GBuffer pass only shades visible fragments
+			bool compactGBuffer; // Smaller GBuffer attachments, Fresnel reflectance is derived when lighting
+			float lightDistance; // Distance from the camera point and spot lights are drawn to
+			float sunIntensity; // Radiance of the directional light
+			float ambientIntensity; // Irradiance of the constant ambient light
+			float exposure; // Multiplier on the lit HDR buffer before tone mapping
+			bool dynamicResolution; // Scale the render resolution to keep the GPU frame time within budget
+			float gpuFrameBudget; // Milliseconds of GPU time per frame dynamic resolution aims for
+			float minResolutionScale; // Lowest render resolution relative to the window
+			float maxResolutionScale; // Highest render resolution relative to the window
+			bool temporalAA; // Jitter the projection and accumulate frames, reconstructs to the window when scaled down
+			float temporalBlend; // Weight of the current frame blended into the history
+			bool instancing; // Batch duplicated meshes sharing a material into instanced draws
+			bool parallelSubmit; // Record draws from worker threads using bgfx encoders
+			uint32_t textureUploadBudget; // Bytes of decoded texture data uploaded per frame
+			uint32_t textureDecodeThreads; // Threads reading and decoding texture files, read on renderer creation
+			uint32_t textureBudget; // Megabytes of streamed textures kept in GPU memory
+			float lodThreshold; // Pixels a simplified mesh may deviate on screen, 0 always draws full meshes
+			float shadowLodBias; // Shadow casters allow this many times the error of the camera
 
 		} renderer;
 
@@ -47,6 +99,7 @@ namespace mge
 				Normal,     
 				FresnelMetallic,   
 				EmissiveOcclusion, 
+				Velocity,
 				Depth,    
 
 			} buffer;
@@ -7,6 +7,7 @@
 
 #include <bgfx/bgfx.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -19,6 +20,19 @@ namespace mge
         friend class Scene;
         friend class GBuffer;
         friend class Skybox;
+        friend class TextureStreamer;
+        friend class TextureResidency;
+
+        struct Residency
+        {
+            enum Enum
+            {
+                Evicted,  //!< Not in GPU memory
+                Pending,  //!< Queued for streaming
+                Resident, //!< In GPU memory
+                Failed,   //!< File could not be loaded
+            };
+        };
 
     public:
         Texture();
@@ -38,6 +52,9 @@ namespace mge
         /// @param[in] _filepath Path of texture file.
         /// 
         /// @remark If texture is already loaded, will just return reference to existing texture.
+        /// @remark The texture is loaded in the background and is invalid until 
+        /// it has been uploaded, see `Settings::Renderer::textureUploadBudget`.
+        /// It can be evicted again to stay within `Settings::Renderer::textureBudget`.
         /// 
         /// @returns Shared Texture.
         /// 
@@ -46,6 +63,12 @@ namespace mge
     private:
         std::string m_filepath;
         bgfx::TextureHandle m_th;
+        Residency::Enum m_residency;
+        std::atomic<uint32_t> m_lastUsed; // Frame the texture was last bound
+        uint32_t m_size; // Bytes in GPU memory
+        uint32_t m_fullSize; // Bytes in GPU memory with all mips
+        uint8_t m_numMips;
+        uint8_t m_skipMips; // Top mips dropped to stay within budget
     };
 
 } // namespace mge
\ No newline at end of file
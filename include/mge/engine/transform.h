@@ -0,0 +1,125 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#pragma once
+
+#include "engine/math.h"
+
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+namespace mge
+{
+	/// Handle to a transform in the transform storage.
+	/// 
+	struct TransformHandle
+	{
+		uint32_t idx;
+	};
+
+	static constexpr TransformHandle kInvalidTransform = { UINT32_MAX };
+
+	inline bool isValid(TransformHandle _handle)
+	{
+		return _handle.idx != UINT32_MAX;
+	}
+
+	/// Transform storage.
+	/// 
+	/// Local transforms are stored in separate arrays (SoA) together with the 
+	/// cached world matrix. World matrices are only recomputed for transforms 
+	/// that have been marked dirty, and their children.
+	/// 
+	/// @remark Setting position, rotation and scale of different transforms is 
+	/// thread safe. Create, destroy and parenting must be done on the main thread.
+	/// 
+	class TransformStorage
+	{
+		void markDirty(uint32_t _idx);
+		void updateWorld(uint32_t _idx);
+		void detach(uint32_t _idx);
+
+	public:
+		TransformStorage();
+
+		/// Allocate an identity transform.
+		/// 
+		/// @returns Transform handle.
+		/// 
+		TransformHandle create();
+
+		/// Free a transform. Children are detached and become roots.
+		/// 
+		/// @param[in] _handle Transform to free.
+		/// 
+		void destroy(TransformHandle _handle);
+
+		/// Set the parent of a transform.
+		/// 
+		/// @param[in] _handle Transform to modify.
+		/// @param[in] _parent New parent, or `kInvalidTransform` to detach.
+		/// 
+		void setParent(TransformHandle _handle, TransformHandle _parent);
+
+		void setPosition(TransformHandle _handle, const Vec3& _position);
+		void setRotation(TransformHandle _handle, const Quat& _rotation);
+		void setScale(TransformHandle _handle, const Vec3& _scale);
+
+		const Vec3& getPosition(TransformHandle _handle) const;
+		const Quat& getRotation(TransformHandle _handle) const;
+		const Vec3& getScale(TransformHandle _handle) const;
+
+		/// Get the cached world matrix.
+		/// 
+		/// @remark Only valid after `update`.
+		/// 
+		/// @returns World matrix (bx convention).
+		/// 
+		const float* getWorldMatrix(TransformHandle _handle) const;
+
+		/// Get how many times the world matrix has been recomputed. Can be
+		/// used to cache data derived from the world matrix.
+		/// 
+		uint32_t getVersion(TransformHandle _handle) const;
+
+		/// Recompute world matrices of all dirty transforms.
+		/// 
+		void update();
+
+		/// Get the number of world matrices recomputed by the last `update`.
+		/// 
+		uint32_t getNumUpdated() const;
+
+	private:
+		struct Matrix
+		{
+			float m[16];
+		};
+
+		// Local
+		std::vector<Vec3> m_positions;
+		std::vector<Quat> m_rotations;
+		std::vector<Vec3> m_scales;
+
+		// World
+		std::vector<Matrix> m_world;
+		std::vector<uint32_t> m_versions;
+
+		// Hierarchy
+		std::vector<uint32_t> m_parent;
+		std::vector<uint32_t> m_firstChild;
+		std::vector<uint32_t> m_nextSibling;
+
+		std::vector<uint8_t> m_dirty;
+		std::vector<uint32_t> m_dirtyList;
+		std::vector<uint32_t> m_freeList;
+		std::mutex m_dirtyMutex;
+		uint32_t m_numUpdated;
+	};
+
+	TransformStorage& getTransformStorage();
+
+} // namespace mge
@@ -13,12 +13,26 @@
 
 namespace mge
 {
+	/// Vertex formats a mesh can be uploaded with.
+	///
+	struct VertexFormat
+	{
+		enum Enum
+		{
+			Full,   //!< Vertex
+			Packed, //!< PackedVertex
+
+			Count
+		};
+	};
+
 	/// Vertex data layout
 	///
 	struct Vertex
 	{
 		friend class Renderer;
 		friend class Mesh;
+		friend class GeometryArena;
 
 		Vec3 position;
 		Vec3 normal;
@@ -34,4 +48,45 @@ namespace mge
 		static bgfx::VertexLayout ms_layout;
 	};
 
+	/// Packed vertex data layout for static geometry.
+	/// 
+	/// Positions are quantized to 16 bits relative to the mesh bounds. Normals 
+	/// and tangents are octahedral encoded, with the bitangent sign stored in 
+	/// position.w. Texcoords and displacement are half floats and weights unorm8.
+	///
+	struct PackedVertex
+	{
+		friend class Renderer;
+		friend class GeometryArena;
+
+		int16_t position[4]; // .w = bitangent sign
+		int16_t normal[4]; // .xy = normal, .zw = tangent
+		uint16_t texcoord[2];
+		uint8_t weights[4];
+		uint8_t indices[4];
+		uint16_t displacement[2];
+
+	private:
+		static void init();
+		static bgfx::VertexLayout ms_layout;
+	};
+
+	/// Pack vertices.
+	/// 
+	/// @param[out] _dst Packed vertices.
+	/// @param[in] _src Vertices.
+	/// @param[in] _numVertices Number of vertices.
+	/// @param[in] _bounds Bounds of the vertices, positions are quantized relative to it.
+	/// 
+	void packVertices(PackedVertex* _dst, const Vertex* _src, uint32_t _numVertices, const Aabb& _bounds);
+
+	/// Choose the format a mesh is uploaded with.
+	/// 
+	/// @param[in] _vertices Vertices of the mesh.
+	/// @param[in] _numVertices Number of vertices.
+	/// 
+	/// @returns Packed, unless quantizing would lose too much precision.
+	/// 
+	VertexFormat::Enum chooseVertexFormat(const Vertex* _vertices, uint32_t _numVertices);
+
 } // namespace mge
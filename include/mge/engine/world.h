@@ -16,8 +16,27 @@ namespace mge
 {
 	class Renderer;
 	class Object;
+	class Component;
+	class Model;
+	class Light;
+	class Mesh;
 	class Texture;
 
+	/// Flat render data of a model, stored contiguously in the world so render
+	/// passes don't have to walk the object graph.
+	/// 
+	struct RenderProxy
+	{
+		Model* model; // Transform
+		std::shared_ptr<Mesh> mesh; // Geometry and materials, can be null
+		Aabb bounds; // World space bounds, cached per transform version
+		uint32_t boundsVersion;
+		uint32_t stillFrames; // Frames since the bounds last changed
+		bool isStatic; // Still long enough for its shadow to be cached
+		float mtx[16]; // World matrix as of the last update
+		float prevMtx[16]; // World matrix the frame before, for motion vectors
+	};
+
 	/// World.
 	/// 
 	class World : public std::enable_shared_from_this<World>
@@ -26,6 +45,30 @@ namespace mge
 		friend class GBuffer;
 		friend class Skybox;
 		friend class ShadowMapping;
+		friend class Deferred;
+		friend class Imgui;
+		friend class Model;
+		friend class Light;
+		friend class Scene;
+		friend class LightClusters;
+
+		struct UpdateItem
+		{
+			Object* object;
+			Component* component; // Null for object updates
+			uint32_t group;
+			uint32_t phase; // Only used by serial items, parallel items run phase by phase
+		};
+
+		static void runUpdate(const UpdateItem& _item, uint32_t _phase, double _dt);
+		void runUpdates(const std::vector<UpdateItem>& _items, uint32_t _begin, uint32_t _end, uint32_t _phase, double _dt);
+
+		void registerObject(std::shared_ptr<Object> _object);
+		void registerModel(Model* _model);
+		void unregisterModel(Model* _model);
+		void registerLight(Light* _light);
+		void unregisterLight(Light* _light);
+		void updateRenderProxy(Model* _model);
 
 	public:
 		World();
@@ -79,6 +122,12 @@ namespace mge
 		Vec3 m_directionalLight; // @todo Turn into class with more settings?
 
 		std::vector<std::shared_ptr<Object>> m_objects;
+		std::vector<RenderProxy> m_renderProxies;
+		uint32_t m_staticVersion; // Bumped when static render proxies are added, moved or removed
+		std::vector<Light*> m_lights; // Point and spot lights
+		std::vector<UpdateItem> m_objectUpdates; // Parallel
+		std::vector<UpdateItem> m_componentUpdates; // Parallel
+		std::vector<UpdateItem> m_serialUpdates; // In object order, preUpdate, update and postUpdate of each object back to back
 
 		SampleData m_sdTotal;
 		SampleData m_sdGame;
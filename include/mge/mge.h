@@ -11,6 +11,7 @@
 #include "engine/components/camera_fly_component.h"
 
 #include "engine/objects/model.h"
+#include "engine/objects/light.h"
 #include "engine/objects/scene.h"
 
 #include "engine/camera.h"
@@ -23,6 +24,7 @@
 #include "engine/renderer.h"
 #include "engine/sampledata.h"
 #include "engine/texture.h"
+#include "engine/transform.h"
 #include "engine/vertex.h"
 #include "engine/window.h"
 #include "engine/world.h"
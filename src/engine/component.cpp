@@ -5,11 +5,126 @@
 
 #include "engine/component.h"
 
+#include <new>
+
 namespace mge
 {
+	static constexpr uint32_t kComponentsPerChunk = 64;
+
+	static std::vector<std::unique_ptr<ComponentPool>> s_pools;
+	static std::mutex s_poolsMutex;
+
+	Component::Component()
+		: m_owner(nullptr)
+		, m_poolIndex(UINT32_MAX)
+	{
+	}
+
 	std::shared_ptr<Object> Component::getOwner()
 	{
 		return m_owner;
 	}
 
-} // namespace mge
\ No newline at end of file
+	ComponentPool::ComponentPool(ComponentTypeId _type, uint32_t _size, uint32_t _align)
+		: m_type(_type)
+		, m_stride((_size + _align - 1) / _align * _align)
+		, m_align(_align)
+	{
+	}
+
+	ComponentPool::~ComponentPool()
+	{
+		for (uint8_t* chunk : m_chunks)
+		{
+			::operator delete(chunk, std::align_val_t(m_align));
+		}
+	}
+
+	void* ComponentPool::alloc()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (m_free.empty())
+		{
+			uint8_t* chunk = (uint8_t*)::operator new(m_stride * kComponentsPerChunk, std::align_val_t(m_align));
+			m_chunks.push_back(chunk);
+
+			// Reversed so components are handed out in memory order
+			for (uint32_t ii = kComponentsPerChunk; ii > 0; --ii)
+			{
+				m_free.push_back(chunk + (ii - 1) * m_stride);
+			}
+		}
+
+		void* ptr = m_free.back();
+		m_free.pop_back();
+		return ptr;
+	}
+
+	void ComponentPool::free(void* _ptr)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_free.push_back(_ptr);
+	}
+
+	void ComponentPool::insert(Component* _component)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		_component->m_poolIndex = (uint32_t)m_components.size();
+		m_components.push_back(_component);
+	}
+
+	void ComponentPool::erase(Component* _component)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// Swap and pop to keep the list dense
+		const uint32_t idx = _component->m_poolIndex;
+		const uint32_t last = (uint32_t)m_components.size() - 1;
+
+		if (idx != last)
+		{
+			m_components[idx] = m_components[last];
+			m_components[idx]->m_poolIndex = idx;
+		}
+		m_components.pop_back();
+
+		_component->m_poolIndex = UINT32_MAX;
+	}
+
+	ComponentTypeId ComponentPool::getType() const
+	{
+		return m_type;
+	}
+
+	uint32_t ComponentPool::getNumComponents() const
+	{
+		return (uint32_t)m_components.size();
+	}
+
+	Component* ComponentPool::getComponent(uint32_t _idx) const
+	{
+		return m_components[_idx];
+	}
+
+	ComponentPool* createComponentPool(uint32_t _size, uint32_t _align)
+	{
+		std::lock_guard<std::mutex> lock(s_poolsMutex);
+
+		const ComponentTypeId type = (ComponentTypeId)s_pools.size();
+		s_pools.push_back(std::make_unique<ComponentPool>(type, _size, _align));
+		return s_pools.back().get();
+	}
+
+	uint32_t getNumComponentTypes()
+	{
+		return (uint32_t)s_pools.size();
+	}
+
+	ComponentPool* getComponentPool(ComponentTypeId _type)
+	{
+		return s_pools[_type].get();
+	}
+
+} // namespace mge
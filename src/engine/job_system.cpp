@@ -0,0 +1,201 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#include "job_system.h"
+
+#include <algorithm>
+
+namespace mge
+{
+	static thread_local uint32_t s_workerIdx = UINT32_MAX;
+
+	uint32_t JobSystem::getQueueIdx() const
+	{
+		return s_workerIdx != UINT32_MAX ? s_workerIdx : (uint32_t)m_queues.size() - 1;
+	}
+
+	bool JobSystem::pop(uint32_t _queue, Entry& _entry)
+	{
+		Queue& queue = *m_queues[_queue];
+
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.jobs.empty())
+		{
+			return false;
+		}
+
+		_entry = std::move(queue.jobs.back());
+		queue.jobs.pop_back();
+		return true;
+	}
+
+	bool JobSystem::steal(uint32_t _thief, Entry& _entry)
+	{
+		const uint32_t numQueues = (uint32_t)m_queues.size();
+
+		for (uint32_t ii = 1; ii < numQueues; ++ii)
+		{
+			Queue& queue = *m_queues[(_thief + ii) % numQueues];
+
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.jobs.empty())
+			{
+				_entry = std::move(queue.jobs.front());
+				queue.jobs.pop_front();
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool JobSystem::runOne(uint32_t _queue)
+	{
+		Entry entry;
+		if (!pop(_queue, entry) && !steal(_queue, entry))
+		{
+			return false;
+		}
+
+		m_numQueued--;
+
+		entry.job();
+
+		if (entry.counter != nullptr)
+		{
+			entry.counter->fetch_sub(1);
+		}
+
+		return true;
+	}
+
+	void JobSystem::workerMain(uint32_t _idx)
+	{
+		s_workerIdx = _idx;
+
+		while (m_running)
+		{
+			if (runOne(_idx))
+			{
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_wake.wait(lock, [this]() { return !m_running || m_numQueued > 0; });
+		}
+	}
+
+	JobSystem::JobSystem(uint32_t _numWorkers)
+		: m_numQueued(0)
+		, m_running(true)
+	{
+		if (_numWorkers == 0)
+		{
+			const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			_numWorkers = std::max(hardwareThreads, 2u) - 1;
+		}
+
+		for (uint32_t ii = 0; ii < _numWorkers + 1; ++ii)
+		{
+			m_queues.push_back(std::make_unique<Queue>());
+		}
+
+		for (uint32_t ii = 0; ii < _numWorkers; ++ii)
+		{
+			m_threads.emplace_back(&JobSystem::workerMain, this, ii);
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_running = false;
+		}
+		m_wake.notify_all();
+
+		for (std::thread& thread : m_threads)
+		{
+			thread.join();
+		}
+	}
+
+	void JobSystem::run(JobCounter* _counter, std::function<void()> _job)
+	{
+		if (_counter != nullptr)
+		{
+			_counter->fetch_add(1);
+		}
+
+		// Count before pushing so a worker can never pop a job that isn't counted yet.
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_numQueued++;
+		}
+
+		Queue& queue = *m_queues[getQueueIdx()];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.push_back({ std::move(_job), _counter });
+		}
+
+		m_wake.notify_one();
+	}
+
+	void JobSystem::wait(JobCounter* _counter)
+	{
+		const uint32_t queue = getQueueIdx();
+
+		while (_counter->load() != 0)
+		{
+			if (!runOne(queue))
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void JobSystem::parallelFor(uint32_t _count, uint32_t _batchSize, const std::function<void(uint32_t, uint32_t)>& _func)
+	{
+		if (_count == 0)
+		{
+			return;
+		}
+
+		// Enough batches to keep every thread busy, but never smaller than the requested size.
+		const uint32_t numThreads = getNumWorkers() + 1;
+		const uint32_t batchSize = std::max(_batchSize, (_count + numThreads * 4 - 1) / (numThreads * 4));
+
+		if (_count <= batchSize)
+		{
+			_func(0, _count);
+			return;
+		}
+
+		JobCounter counter(0);
+		for (uint32_t begin = batchSize; begin < _count; begin += batchSize)
+		{
+			const uint32_t end = std::min(begin + batchSize, _count);
+			run(&counter, [&_func, begin, end]() { _func(begin, end); });
+		}
+
+		// Calling thread takes the first batch
+		_func(0, batchSize);
+
+		wait(&counter);
+	}
+
+	uint32_t JobSystem::getNumWorkers() const
+	{
+		return (uint32_t)m_threads.size();
+	}
+
+	JobSystem& getJobSystem()
+	{
+		static JobSystem s_jobSystem;
+		return s_jobSystem;
+	}
+
+} // namespace mge
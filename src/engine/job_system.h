@@ -0,0 +1,98 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mge
+{
+	/// Number of unfinished jobs, used to wait for a set of jobs.
+	/// 
+	typedef std::atomic<uint32_t> JobCounter;
+
+	/// Work stealing job system.
+	/// 
+	/// Every worker owns a queue. Jobs are pushed to the queue of the calling 
+	/// thread and popped from the back (LIFO), idle workers steal from the front 
+	/// of other queues (FIFO). Threads waiting on a counter help run jobs.
+	/// 
+	class JobSystem
+	{
+		struct Entry
+		{
+			std::function<void()> job;
+			JobCounter* counter;
+		};
+
+		struct Queue
+		{
+			std::mutex mutex;
+			std::deque<Entry> jobs;
+		};
+
+		uint32_t getQueueIdx() const;
+		bool pop(uint32_t _queue, Entry& _entry);
+		bool steal(uint32_t _thief, Entry& _entry);
+		bool runOne(uint32_t _queue);
+		void workerMain(uint32_t _idx);
+
+	public:
+		/// Create job system.
+		/// 
+		/// @param[in] _numWorkers Number of worker threads, 0 to use one per 
+		/// hardware thread minus the calling thread.
+		/// 
+		JobSystem(uint32_t _numWorkers = 0);
+		~JobSystem();
+
+		/// Queue a job.
+		/// 
+		/// @param[in] _counter Counter incremented now and decremented when the 
+		/// job has finished, can be null.
+		/// @param[in] _job Job function.
+		/// 
+		void run(JobCounter* _counter, std::function<void()> _job);
+
+		/// Wait until the counter reaches zero. Runs queued jobs while waiting.
+		/// 
+		/// @param[in] _counter Counter to wait for.
+		/// 
+		void wait(JobCounter* _counter);
+
+		/// Split a range into jobs and wait for all of them.
+		/// 
+		/// @param[in] _count Number of elements.
+		/// @param[in] _batchSize Minimum number of elements per job.
+		/// @param[in] _func Called with [begin, end) for every batch.
+		/// 
+		void parallelFor(uint32_t _count, uint32_t _batchSize, const std::function<void(uint32_t, uint32_t)>& _func);
+
+		/// Get the number of worker threads, not including the calling thread.
+		/// 
+		uint32_t getNumWorkers() const;
+
+	private:
+		std::vector<std::unique_ptr<Queue>> m_queues; // Last queue is shared by non-worker threads
+		std::vector<std::thread> m_threads;
+
+		std::mutex m_sleepMutex;
+		std::condition_variable m_wake;
+		std::atomic<uint32_t> m_numQueued;
+		std::atomic<bool> m_running;
+	};
+
+	/// Get the engine job system.
+	/// 
+	JobSystem& getJobSystem();
+
+} // namespace mge
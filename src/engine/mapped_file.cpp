@@ -0,0 +1,123 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#include "mapped_file.h"
+
+#if defined(_WIN32)
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif // defined(_WIN32)
+
+namespace mge
+{
+	MappedFile::MappedFile()
+		: m_data(nullptr)
+		, m_size(0)
+		, m_handle(nullptr)
+	{
+	}
+
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	bool MappedFile::open(const char* _filepath)
+	{
+		close();
+
+#if defined(_WIN32)
+		HANDLE file = CreateFileA(_filepath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file); // The mapping keeps the file open
+		if (mapping == nullptr)
+		{
+			return false;
+		}
+
+		void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (data == nullptr)
+		{
+			CloseHandle(mapping);
+			return false;
+		}
+
+		m_data = (const uint8_t*)data;
+		m_size = (uint64_t)size.QuadPart;
+		m_handle = mapping;
+#else
+		int fd = ::open(_filepath, O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		struct stat st;
+		if (fstat(fd, &st) != 0 || st.st_size == 0)
+		{
+			::close(fd);
+			return false;
+		}
+
+		void* data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd); // The mapping keeps the file open
+		if (data == MAP_FAILED)
+		{
+			return false;
+		}
+
+		m_data = (const uint8_t*)data;
+		m_size = (uint64_t)st.st_size;
+#endif // defined(_WIN32)
+
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_data == nullptr)
+		{
+			return;
+		}
+
+#if defined(_WIN32)
+		UnmapViewOfFile(m_data);
+		CloseHandle((HANDLE)m_handle);
+#else
+		munmap((void*)m_data, (size_t)m_size);
+#endif // defined(_WIN32)
+
+		m_data = nullptr;
+		m_size = 0;
+		m_handle = nullptr;
+	}
+
+	const uint8_t* MappedFile::getData() const
+	{
+		return m_data;
+	}
+
+	uint64_t MappedFile::getSize() const
+	{
+		return m_size;
+	}
+
+} // namespace mge
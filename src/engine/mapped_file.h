@@ -0,0 +1,53 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace mge
+{
+	/// Read only memory mapped file.
+	/// 
+	class MappedFile
+	{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		/// Map a file into memory.
+		/// 
+		/// @param[in] _filepath Path of file to map.
+		/// 
+		/// @returns True if the file was mapped.
+		/// 
+		bool open(const char* _filepath);
+
+		/// Unmap the file.
+		/// 
+		void close();
+
+		/// Get the mapped file data.
+		/// 
+		/// @returns Pointer to the start of the file, or nullptr if not mapped.
+		/// 
+		const uint8_t* getData() const;
+
+		/// Get the size of the mapped file.
+		/// 
+		/// @returns Size in bytes.
+		/// 
+		uint64_t getSize() const;
+
+	private:
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		const uint8_t* m_data;
+		uint64_t m_size;
+		void* m_handle; // Platform file mapping
+	};
+
+} // namespace mge
@@ -9,66 +9,65 @@
 
 namespace mge
 {
-    void Object::preUpdate(double _dt)
-    {
-        for (auto& component : m_components)
-        {
-            component.second->preUpdate(_dt);
-        }
-    }
-
-    void Object::postUpdate(double _dt)
-    {
-        for (auto& component : m_components)
-        {
-            component.second->postUpdate(_dt);
-        }
-    }
-
     Object::Object()
-        : m_position(Vec3()) 
-        , m_rotation(Quat()) // Identity
-        , m_scale(Vec3(1.0f, 1.0f, 1.0f))
+        : m_world(nullptr)
+        , m_transform(getTransformStorage().create()) // Identity
     {
     }
 
     Object::~Object()
     {
+        getTransformStorage().destroy(m_transform);
     }
 
     void Object::setPosition(const Vec3& _position)
     {
-        m_position = _position;
+        getTransformStorage().setPosition(m_transform, _position);
     }
 
     Vec3 Object::getPosition() const
     {
-        return m_position;
+        return getTransformStorage().getPosition(m_transform);
     }
 
     void Object::setRotation(const Vec3& _euler)
     {
-        m_rotation = quat_from_euler(_euler);
+        getTransformStorage().setRotation(m_transform, quat_from_euler(_euler));
     }
 
     void Object::setRotation(const Quat& _rotation)
     {
-        m_rotation = _rotation;
+        getTransformStorage().setRotation(m_transform, _rotation);
     }
 
     Quat Object::getRotation() const
     {
-        return m_rotation;
+        return getTransformStorage().getRotation(m_transform);
     }
 
     void Object::setScale(const Vec3& _scale)
     {
-        m_scale = _scale;
+        getTransformStorage().setScale(m_transform, _scale);
     }
 
     Vec3 Object::getScale() const
     {
-        return m_scale;
+        return getTransformStorage().getScale(m_transform);
+    }
+
+    void Object::setParent(std::shared_ptr<Object> _parent)
+    {
+        getTransformStorage().setParent(m_transform, _parent ? _parent->m_transform : kInvalidTransform);
+    }
+
+    const float* Object::getWorldMatrix() const
+    {
+        return getTransformStorage().getWorldMatrix(m_transform);
+    }
+
+    TransformHandle Object::getTransform() const
+    {
+        return m_transform;
     }
 
 } // namespace mge
\ No newline at end of file
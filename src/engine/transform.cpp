@@ -0,0 +1,234 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#include "engine/transform.h"
+
+#include <bx/math.h>
+
+namespace mge
+{
+	static TransformStorage s_transforms;
+
+	static constexpr uint32_t kInvalid = UINT32_MAX;
+
+	static void mtxSRT(float* _result, const Vec3& _pos, const Quat& _rotation, const Vec3& _scale)
+	{
+		// Scale rows of the rotation matrix instead of multiplying three matrices.
+		bx::mtxFromQuaternion(_result, { _rotation.x, _rotation.y, _rotation.z, _rotation.w });
+
+		_result[0] *= _scale.x; _result[1] *= _scale.x; _result[2]  *= _scale.x;
+		_result[4] *= _scale.y; _result[5] *= _scale.y; _result[6]  *= _scale.y;
+		_result[8] *= _scale.z; _result[9] *= _scale.z; _result[10] *= _scale.z;
+
+		_result[12] = _pos.x;
+		_result[13] = _pos.y;
+		_result[14] = _pos.z;
+	}
+
+	void TransformStorage::markDirty(uint32_t _idx)
+	{
+		if (m_dirty[_idx] == 0)
+		{
+			m_dirty[_idx] = 1;
+			m_dirtyList.push_back(_idx);
+		}
+
+		for (uint32_t child = m_firstChild[_idx]; child != kInvalid; child = m_nextSibling[child])
+		{
+			markDirty(child);
+		}
+	}
+
+	void TransformStorage::updateWorld(uint32_t _idx)
+	{
+		if (m_dirty[_idx] == 0)
+		{
+			return;
+		}
+
+		const uint32_t parent = m_parent[_idx];
+		if (parent != kInvalid)
+		{
+			// Parent must be up to date first
+			updateWorld(parent);
+
+			float local[16];
+			mtxSRT(local, m_positions[_idx], m_rotations[_idx], m_scales[_idx]);
+			bx::mtxMul(m_world[_idx].m, local, m_world[parent].m);
+		}
+		else
+		{
+			mtxSRT(m_world[_idx].m, m_positions[_idx], m_rotations[_idx], m_scales[_idx]);
+		}
+
+		m_dirty[_idx] = 0;
+		m_versions[_idx]++;
+		m_numUpdated++;
+	}
+
+	void TransformStorage::detach(uint32_t _idx)
+	{
+		const uint32_t parent = m_parent[_idx];
+		if (parent == kInvalid)
+		{
+			return;
+		}
+
+		uint32_t* link = &m_firstChild[parent];
+		while (*link != _idx)
+		{
+			link = &m_nextSibling[*link];
+		}
+		*link = m_nextSibling[_idx];
+
+		m_parent[_idx] = kInvalid;
+		m_nextSibling[_idx] = kInvalid;
+	}
+
+	TransformStorage::TransformStorage()
+		: m_numUpdated(0)
+	{
+	}
+
+	TransformHandle TransformStorage::create()
+	{
+		uint32_t idx;
+		if (!m_freeList.empty())
+		{
+			idx = m_freeList.back();
+			m_freeList.pop_back();
+		}
+		else
+		{
+			idx = (uint32_t)m_positions.size();
+			m_positions.emplace_back();
+			m_rotations.emplace_back();
+			m_scales.emplace_back();
+			m_world.emplace_back();
+			m_versions.push_back(0);
+			m_parent.push_back(kInvalid);
+			m_firstChild.push_back(kInvalid);
+			m_nextSibling.push_back(kInvalid);
+			m_dirty.push_back(0);
+		}
+
+		m_positions[idx] = Vec3();
+		m_rotations[idx] = Quat(); // Identity
+		m_scales[idx] = Vec3(1.0f, 1.0f, 1.0f);
+		bx::mtxIdentity(m_world[idx].m);
+		m_parent[idx] = kInvalid;
+		m_firstChild[idx] = kInvalid;
+		m_nextSibling[idx] = kInvalid;
+		m_dirty[idx] = 0;
+		m_versions[idx]++;
+
+		return { idx };
+	}
+
+	void TransformStorage::destroy(TransformHandle _handle)
+	{
+		const uint32_t idx = _handle.idx;
+
+		detach(idx);
+
+		while (m_firstChild[idx] != kInvalid)
+		{
+			const uint32_t child = m_firstChild[idx];
+			detach(child);
+			markDirty(child);
+		}
+
+		// Stale entries in the dirty list are skipped by update
+		m_dirty[idx] = 0;
+		m_freeList.push_back(idx);
+	}
+
+	void TransformStorage::setParent(TransformHandle _handle, TransformHandle _parent)
+	{
+		const uint32_t idx = _handle.idx;
+
+		detach(idx);
+
+		if (isValid(_parent))
+		{
+			m_parent[idx] = _parent.idx;
+			m_nextSibling[idx] = m_firstChild[_parent.idx];
+			m_firstChild[_parent.idx] = idx;
+		}
+
+		markDirty(idx);
+	}
+
+	void TransformStorage::setPosition(TransformHandle _handle, const Vec3& _position)
+	{
+		m_positions[_handle.idx] = _position;
+
+		std::lock_guard<std::mutex> lock(m_dirtyMutex);
+		markDirty(_handle.idx);
+	}
+
+	void TransformStorage::setRotation(TransformHandle _handle, const Quat& _rotation)
+	{
+		m_rotations[_handle.idx] = _rotation;
+
+		std::lock_guard<std::mutex> lock(m_dirtyMutex);
+		markDirty(_handle.idx);
+	}
+
+	void TransformStorage::setScale(TransformHandle _handle, const Vec3& _scale)
+	{
+		m_scales[_handle.idx] = _scale;
+
+		std::lock_guard<std::mutex> lock(m_dirtyMutex);
+		markDirty(_handle.idx);
+	}
+
+	const Vec3& TransformStorage::getPosition(TransformHandle _handle) const
+	{
+		return m_positions[_handle.idx];
+	}
+
+	const Quat& TransformStorage::getRotation(TransformHandle _handle) const
+	{
+		return m_rotations[_handle.idx];
+	}
+
+	const Vec3& TransformStorage::getScale(TransformHandle _handle) const
+	{
+		return m_scales[_handle.idx];
+	}
+
+	const float* TransformStorage::getWorldMatrix(TransformHandle _handle) const
+	{
+		return m_world[_handle.idx].m;
+	}
+
+	uint32_t TransformStorage::getVersion(TransformHandle _handle) const
+	{
+		return m_versions[_handle.idx];
+	}
+
+	void TransformStorage::update()
+	{
+		m_numUpdated = 0;
+
+		for (uint32_t idx : m_dirtyList)
+		{
+			updateWorld(idx);
+		}
+		m_dirtyList.clear();
+	}
+
+	uint32_t TransformStorage::getNumUpdated() const
+	{
+		return m_numUpdated;
+	}
+
+	TransformStorage& getTransformStorage()
+	{
+		return s_transforms;
+	}
+
+} // namespace mge
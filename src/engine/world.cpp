@@ -6,21 +6,157 @@
 #include "engine/world.h"
 #include "engine/renderer.h"
 #include "engine/objects/scene.h"
+#include "engine/objects/model.h"
+#include "engine/objects/light.h"
+#include "engine/components/mesh_component.h"
+#include "engine/transform.h"
+#include "engine/settings.h"
 
+#include "job_system.h"
+
+#include <algorithm>
 #include <chrono>
 
 namespace mge 
 {
+    struct UpdatePhase
+    {
+        enum Enum
+        {
+            PreUpdate,
+            Update,
+            PostUpdate,
+        };
+    };
+
 	World::World()
 		: m_world(nullptr)
 		, m_camera(nullptr)
+		, m_staticVersion(0)
 	{
 	}
 
 	World::~World()
 	{
+		// Objects can outlive the world
+		for (RenderProxy& proxy : m_renderProxies)
+		{
+			proxy.model->m_world = nullptr;
+			proxy.model->m_renderProxy = UINT32_MAX;
+		}
+
+		for (Light* light : m_lights)
+		{
+			light->m_world = nullptr;
+			light->m_lightProxy = UINT32_MAX;
+		}
+
+		for (auto& object : m_objects)
+		{
+			object->m_world = nullptr;
+		}
 	}
 
+    void World::registerObject(std::shared_ptr<Object> _object)
+    {
+        _object->m_world = this;
+
+        // Resolve the type once on creation instead of every frame.
+        if (std::shared_ptr<Model> model = std::dynamic_pointer_cast<Model>(_object))
+        {
+            registerModel(model.get());
+        }
+        else if (std::shared_ptr<Light> light = std::dynamic_pointer_cast<Light>(_object))
+        {
+            registerLight(light.get());
+        }
+        else if (std::shared_ptr<Scene> scene = std::dynamic_pointer_cast<Scene>(_object))
+        {
+            for (auto& pair : scene->m_models)
+            {
+                registerModel(pair.second.get());
+            }
+        }
+    }
+
+    void World::registerModel(Model* _model)
+    {
+        if (_model->m_renderProxy != UINT32_MAX)
+        {
+            return;
+        }
+
+        _model->m_world = this;
+        _model->m_renderProxy = (uint32_t)m_renderProxies.size();
+
+        m_renderProxies.push_back({ _model, nullptr, Aabb(), UINT32_MAX, 0, false, {}, {} });
+        updateRenderProxy(_model);
+    }
+
+    void World::unregisterModel(Model* _model)
+    {
+        if (_model->m_renderProxy == UINT32_MAX)
+        {
+            return;
+        }
+
+        // Swap and pop to keep the list contiguous
+        const uint32_t idx = _model->m_renderProxy;
+        const uint32_t last = (uint32_t)m_renderProxies.size() - 1;
+
+        if (m_renderProxies[idx].isStatic)
+        {
+            m_staticVersion++;
+        }
+
+        if (idx != last)
+        {
+            m_renderProxies[idx] = std::move(m_renderProxies[last]);
+            m_renderProxies[idx].model->m_renderProxy = idx;
+        }
+        m_renderProxies.pop_back();
+
+        _model->m_world = nullptr;
+        _model->m_renderProxy = UINT32_MAX;
+    }
+
+    void World::registerLight(Light* _light)
+    {
+        if (_light->m_lightProxy != UINT32_MAX)
+        {
+            return;
+        }
+
+        _light->m_lightProxy = (uint32_t)m_lights.size();
+        m_lights.push_back(_light);
+    }
+
+    void World::unregisterLight(Light* _light)
+    {
+        // Swap and pop to keep the list contiguous
+        const uint32_t idx = _light->m_lightProxy;
+        const uint32_t last = (uint32_t)m_lights.size() - 1;
+
+        if (idx != last)
+        {
+            m_lights[idx] = m_lights[last];
+            m_lights[idx]->m_lightProxy = idx;
+        }
+        m_lights.pop_back();
+
+        _light->m_world = nullptr;
+        _light->m_lightProxy = UINT32_MAX;
+    }
+
+    void World::updateRenderProxy(Model* _model)
+    {
+        RenderProxy& proxy = m_renderProxies[_model->m_renderProxy];
+
+        std::shared_ptr<MeshComponent> meshComp = _model->getComponent<MeshComponent>();
+        proxy.mesh = meshComp ? meshComp->m_mesh : nullptr;
+        proxy.boundsVersion = UINT32_MAX; // Recompute bounds
+    }
+
     void World::update()
     {
         if (m_world == nullptr)
@@ -38,11 +174,109 @@ namespace mge
         lastTime = currentTime;
         double dt = frameMsCpu * 0.001; 
 
-        for (uint32_t ii = 0; ii < m_objects.size(); ++ii)
+        // Gather, parallel components per type from their pools
+        m_objectUpdates.clear();
+        m_componentUpdates.clear();
+        m_serialUpdates.clear();
+
+        for (uint32_t type = 0; type < getNumComponentTypes(); ++type)
         {
-            m_objects[ii]->preUpdate(dt);
-            m_objects[ii]->update(dt);
-            m_objects[ii]->postUpdate(dt);
+            const ComponentPool* pool = getComponentPool(ComponentTypeId(type));
+            for (uint32_t ii = 0; ii < pool->getNumComponents(); ++ii)
+            {
+                Component* component = pool->getComponent(ii);
+
+                Object* owner = component->m_owner.get();
+                if (owner == nullptr 
+                    || owner->m_world != this 
+                    || component->getUpdateMode() != UpdateMode::Parallel)
+                {
+                    continue;
+                }
+
+                m_componentUpdates.push_back({ owner, component, component->getUpdateGroup(), UpdatePhase::PreUpdate });
+            }
+        }
+
+        // Serial items keep the order of a plain loop over objects, each 
+        // object runs preUpdate, update and postUpdate before the next one.
+        for (auto& object : m_objects)
+        {
+            for (auto& component : object->m_components)
+            {
+                if (component != nullptr && component->getUpdateMode() == UpdateMode::Serial)
+                {
+                    m_serialUpdates.push_back({ object.get(), component.get(), component->getUpdateGroup(), UpdatePhase::PreUpdate });
+                }
+            }
+
+            if (object->getUpdateMode() == UpdateMode::Parallel)
+            {
+                m_objectUpdates.push_back({ object.get(), nullptr, object->getUpdateGroup(), UpdatePhase::Update });
+            }
+            else
+            {
+                m_serialUpdates.push_back({ object.get(), nullptr, object->getUpdateGroup(), UpdatePhase::Update });
+            }
+
+            for (auto& component : object->m_components)
+            {
+                if (component != nullptr && component->getUpdateMode() == UpdateMode::Serial)
+                {
+                    m_serialUpdates.push_back({ object.get(), component.get(), component->getUpdateGroup(), UpdatePhase::PostUpdate });
+                }
+            }
+        }
+
+        auto compare = [](const UpdateItem& _a, const UpdateItem& _b)
+        {
+            return _a.group < _b.group;
+        };
+        std::stable_sort(m_objectUpdates.begin(), m_objectUpdates.end(), compare);
+        std::stable_sort(m_componentUpdates.begin(), m_componentUpdates.end(), compare);
+        std::stable_sort(m_serialUpdates.begin(), m_serialUpdates.end(), compare);
+
+        auto groupEnd = [](const std::vector<UpdateItem>& _items, uint32_t _begin, uint32_t _group)
+        {
+            uint32_t end = _begin;
+            while (end < _items.size() && _items[end].group == _group)
+            {
+                end++;
+            }
+            return end;
+        };
+
+        // Update, groups in ascending order. Parallel items of a group run 
+        // phase by phase, then the serial items on this thread.
+        uint32_t component = 0;
+        uint32_t object = 0;
+        uint32_t serial = 0;
+
+        while (component < m_componentUpdates.size() 
+            || object < m_objectUpdates.size() 
+            || serial < m_serialUpdates.size())
+        {
+            uint32_t group = UINT32_MAX;
+            if (component < m_componentUpdates.size()) group = std::min(group, m_componentUpdates[component].group);
+            if (object < m_objectUpdates.size())       group = std::min(group, m_objectUpdates[object].group);
+            if (serial < m_serialUpdates.size())       group = std::min(group, m_serialUpdates[serial].group);
+
+            const uint32_t componentEnd = groupEnd(m_componentUpdates, component, group);
+            const uint32_t objectEnd = groupEnd(m_objectUpdates, object, group);
+            const uint32_t serialEnd = groupEnd(m_serialUpdates, serial, group);
+
+            runUpdates(m_componentUpdates, component, componentEnd, UpdatePhase::PreUpdate, dt);
+            runUpdates(m_objectUpdates, object, objectEnd, UpdatePhase::Update, dt);
+            runUpdates(m_componentUpdates, component, componentEnd, UpdatePhase::PostUpdate, dt);
+
+            for (uint32_t ii = serial; ii < serialEnd; ++ii)
+            {
+                runUpdate(m_serialUpdates[ii], m_serialUpdates[ii].phase, dt);
+            }
+
+            component = componentEnd;
+            object = objectEnd;
+            serial = serialEnd;
         }
 
         auto endTime = std::chrono::high_resolution_clock::now();
@@ -51,8 +285,42 @@ namespace mge
         m_sdGame.pushSample(float(updateDuration.count() * 1000.0f));
     }
 
+    void World::runUpdate(const UpdateItem& _item, uint32_t _phase, double _dt)
+    {
+        switch (_phase)
+        {
+        case UpdatePhase::PreUpdate:  _item.component->preUpdate(_dt);  break;
+        case UpdatePhase::Update:     _item.object->update(_dt);        break;
+        case UpdatePhase::PostUpdate: _item.component->postUpdate(_dt); break;
+        }
+    }
+
+    void World::runUpdates(const std::vector<UpdateItem>& _items, uint32_t _begin, uint32_t _end, uint32_t _phase, double _dt)
+    {
+        if (getSettings().scene.parallelUpdate)
+        {
+            getJobSystem().parallelFor(_end - _begin, 64, [&](uint32_t _first, uint32_t _last)
+            {
+                for (uint32_t ii = _first; ii < _last; ++ii)
+                {
+                    runUpdate(_items[_begin + ii], _phase, _dt);
+                }
+            });
+        }
+        else
+        {
+            for (uint32_t ii = _begin; ii < _end; ++ii)
+            {
+                runUpdate(_items[ii], _phase, _dt);
+            }
+        }
+    }
+
 	void World::render(std::shared_ptr<Renderer> _renderer)
 	{
+		// Only dirty transforms are recomputed
+		getTransformStorage().update();
+
 		_renderer->render(m_world, m_camera);
 	}
 
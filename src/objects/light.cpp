@@ -0,0 +1,93 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#include "engine/objects/light.h"
+#include "engine/world.h"
+
+#include <bx/bx.h>
+
+namespace mge
+{
+	Light::Light(LightType::Enum _type)
+		: m_type(_type)
+		, m_color(1.0f, 1.0f, 1.0f)
+		, m_intensity(1.0f)
+		, m_range(10.0f)
+		, m_innerAngle(30.0f)
+		, m_outerAngle(45.0f)
+		, m_lightProxy(UINT32_MAX)
+	{
+	}
+
+	Light::~Light()
+	{
+		if (m_lightProxy != UINT32_MAX)
+		{
+			m_world->unregisterLight(this);
+		}
+	}
+
+	std::shared_ptr<Light> createPointLight(std::shared_ptr<World> _world)
+	{
+		return _world->makeObject<Light>(LightType::Point);
+	}
+
+	std::shared_ptr<Light> createSpotLight(std::shared_ptr<World> _world)
+	{
+		return _world->makeObject<Light>(LightType::Spot);
+	}
+
+	LightType::Enum Light::getType() const
+	{
+		return m_type;
+	}
+
+	void Light::setColor(const Vec3& _color)
+	{
+		m_color = _color;
+	}
+
+	Vec3 Light::getColor() const
+	{
+		return m_color;
+	}
+
+	void Light::setIntensity(float _intensity)
+	{
+		m_intensity = bx::max(_intensity, 0.0f);
+	}
+
+	float Light::getIntensity() const
+	{
+		return m_intensity;
+	}
+
+	void Light::setRange(float _range)
+	{
+		m_range = bx::max(_range, 0.0f);
+	}
+
+	float Light::getRange() const
+	{
+		return m_range;
+	}
+
+	void Light::setSpotAngles(float _innerAngle, float _outerAngle)
+	{
+		m_outerAngle = bx::clamp(_outerAngle, 0.0f, 89.0f);
+		m_innerAngle = bx::clamp(_innerAngle, 0.0f, m_outerAngle);
+	}
+
+	float Light::getSpotInnerAngle() const
+	{
+		return m_innerAngle;
+	}
+
+	float Light::getSpotOuterAngle() const
+	{
+		return m_outerAngle;
+	}
+
+} // namespace mge
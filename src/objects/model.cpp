@@ -11,11 +11,16 @@
 namespace mge
 {
 	Model::Model()
+		: m_renderProxy(UINT32_MAX)
 	{
 	}
 
 	Model::~Model()
 	{
+		if (m_renderProxy != UINT32_MAX)
+		{
+			m_world->unregisterModel(this);
+		}
 	}
 
 	std::shared_ptr<Model> createModel(std::shared_ptr<World> _world)
@@ -26,6 +31,11 @@ namespace mge
 	void Model::addMesh(std::shared_ptr<Mesh> _mesh)
 	{
 		addComponent<MeshComponent>(_mesh);
+
+		if (m_renderProxy != UINT32_MAX)
+		{
+			m_world->updateRenderProxy(this);
+		}
 	}
 
 } // namespace mge
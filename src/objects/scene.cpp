@@ -12,11 +12,20 @@
 #include "engine/world.h"
 #include "engine/camera.h"
 
+#include "engine/mapped_file.h"
+#include "scene_format.h"
+#include "renderer/texture_cooker.h"
+#include "renderer/mesh_optimizer.h"
+#include "engine/job_system.h"
+
+#include <bx/bx.h>
+
+#include <atomic>
 #include <filesystem>
 
 namespace mge 
 {
-	void MayaSession::begin(std::unordered_map<std::string, std::shared_ptr<Model>>& _models)
+	void MayaSession::begin(Scene& _scene)
 	{
 		m_writeBuffer = std::make_unique<mb::SharedBuffer>();
 		m_writeBuffer->init("maya-bridge-write", sizeof(mb::SharedData));
@@ -29,14 +38,14 @@ namespace mge
 		m_readBuffer->read(&status, sizeof(uint32_t));
 		if (status != MAYABRIDGE_MESSAGE_RELOAD_SCENE)
 		{
-			_models.clear();
+			_scene.clearModels();
 
 			status = MAYABRIDGE_MESSAGE_RELOAD_SCENE;
 			m_readBuffer->write(&status, sizeof(uint32_t));
 		}
 	}
 
-	void MayaSession::update(std::unordered_map<std::string, std::shared_ptr<Model>>& _models)
+	void MayaSession::update(Scene& _scene)
 	{
 		m_writeBuffer->read(&m_shared,
 			sizeof(mb::Camera) +
@@ -66,7 +75,7 @@ namespace mge
 				}
 				else
 				{
-					materialAdded(_models, material);
+					materialAdded(_scene, material);
 				}
 			}
 
@@ -75,14 +84,14 @@ namespace mge
 			{
 				const mb::Model& model = m_shared.models[ii];
 
-				auto it = _models.find(model.name);
-				if (it != _models.end())
+				auto it = _scene.m_models.find(model.name);
+				if (it != _scene.m_models.end())
 				{
 					//modelChanged(model);
 				}
 				else
 				{
-					modelAdded(_models, model);
+					modelAdded(_scene, model);
 				}
 			}
 
@@ -105,10 +114,9 @@ namespace mge
 		return m_writeBuffer && m_readBuffer;
 	}
 
-	void MayaSession::modelAdded(std::unordered_map<std::string, std::shared_ptr<Model>>& _models, const mb::Model& _model)
+	void MayaSession::modelAdded(Scene& _scene, const mb::Model& _model)
 	{
-		_models[_model.name] = std::make_shared<Model>();
-		std::shared_ptr<Model>& model = _models[_model.name];
+		std::shared_ptr<Model> model = std::make_shared<Model>();
 
 		// Transform
 		model->setPosition(Vec3(
@@ -137,32 +145,50 @@ namespace mge
 			vertices.push_back(*(Vertex*)&vertex);
 		}
 
+		// Every index fits in 16 bits when the mesh has few enough vertices
+		const bool index16 = mesh.numVertices <= UINT16_MAX + 1;
+
 		std::vector<std::shared_ptr<SubMesh>> subMeshes;
 		for (uint32_t jj = 0; jj < mesh.numSubMeshes; ++jj)
 		{
 			auto& subMesh = mesh.subMeshes[jj];
 
-			std::vector<uint32_t> indices;
+			std::vector<uint16_t> indices16;
+			std::vector<uint32_t> indices32;
 			for (uint32_t jj = 0; jj < subMesh.numIndices; ++jj)
 			{
 				auto& index = subMesh.indices[jj];
-				indices.push_back(index);
+				if (index16)
+				{
+					indices16.push_back((uint16_t)index);
+				}
+				else
+				{
+					indices32.push_back(index);
+				}
 			}
 
+			std::shared_ptr<Material> material = nullptr;
 			if (m_materials.find(subMesh.material) != m_materials.end())
 			{
-				subMeshes.push_back(createSubMesh(indices, m_materials[subMesh.material]));
+				material = m_materials[subMesh.material];
+			}
+
+			if (index16)
+			{
+				subMeshes.push_back(createSubMesh(indices16, material));
 			}
 			else
 			{
-				subMeshes.push_back(createSubMesh(indices, nullptr));
+				subMeshes.push_back(createSubMesh(indices32, material));
 			}
 		}
 
 		model->addMesh(createMesh(vertices, subMeshes));
+		_scene.setModel(_model.name, model);
 	}
 
-	void MayaSession::materialAdded(std::unordered_map<std::string, std::shared_ptr<Model>>& _models, const mb::Material& _material)
+	void MayaSession::materialAdded(Scene& _scene, const mb::Material& _material)
 	{
 		m_materials[_material.name] = std::make_shared<Material>(MGE_MATERIAL_NONE);
 		std::shared_ptr<Material> material = m_materials[_material.name];
@@ -204,182 +230,341 @@ namespace mge
 		end();
 	}
 
-	void Scene::write(FILE* _file)
+	void Scene::setModel(const std::string& _name, std::shared_ptr<Model> _model)
+	{
+		// Render proxies are owned by the world, not by the model, so a replaced
+		// model has to be unregistered here or it keeps rendering.
+		std::shared_ptr<Model>& slot = m_models[_name];
+		if (slot != nullptr && m_world != nullptr)
+		{
+			m_world->unregisterModel(slot.get());
+		}
+
+		slot = _model;
+
+		// Scenes read on construction have no world yet, registerObject picks them up
+		if (m_world != nullptr)
+		{
+			m_world->registerModel(slot.get());
+		}
+	}
+
+	void Scene::clearModels()
 	{
-		// Write models
-		uint32_t numModels = (uint32_t)m_models.size();
-		fwrite(&numModels, sizeof(uint32_t), 1, _file);
+		if (m_world != nullptr)
+		{
+			for (auto& pair : m_models)
+			{
+				m_world->unregisterModel(pair.second.get());
+			}
+		}
+
+		m_models.clear();
+	}
+
+	void Scene::write(FILE* _file, bool _optimizeMeshes)
+	{
+		SceneData data;
+
+		// Materials are shared between submeshes
+		std::unordered_map<const Material*, uint32_t> materialLookup;
+		auto texturePath = [](const std::shared_ptr<Texture>& _texture)
+		{
+			return _texture != nullptr ? _texture->m_filepath : std::string();
+		};
 
 		for (auto& key : m_models)
 		{
 			auto& name = key.first;
 			auto& model = key.second;
 
-			// Write name
-			writeString(_file, name);
-
-			// Write transform
-			fwrite(&model->getPosition(), sizeof(Vec3), 1, _file);
-			fwrite(&model->getRotation(), sizeof(Quat), 1, _file);
-			fwrite(&model->getScale(), sizeof(Vec3), 1, _file);
+			std::shared_ptr<MeshComponent> meshComp = model->getComponent<MeshComponent>();
+			if (meshComp == nullptr)
+			{
+				continue;
+			}
 
-			// Write vertices
-			std::shared_ptr<Mesh> mesh = model->getComponent<MeshComponent>()->m_mesh;
-			uint32_t numVertices = (uint32_t)mesh->m_vertices.size();
-			fwrite(&numVertices, sizeof(uint32_t), 1, _file);
-			fwrite(mesh->m_vertices.data(), numVertices * sizeof(Vertex), 1, _file);
+			SceneModelData modelData;
+			modelData.name = name;
+			modelData.position = model->getPosition();
+			modelData.rotation = model->getRotation();
+			modelData.scale = model->getScale();
 
-			// Write submeshes
-			uint32_t numSubmeshes = (uint32_t)mesh->m_submeshes.size();
-			fwrite(&numSubmeshes, sizeof(uint32_t), 1, _file);
+			std::shared_ptr<Mesh> mesh = meshComp->m_mesh;
+			modelData.vertices.assign(mesh->m_vertexData, mesh->m_vertexData + mesh->m_numVertices);
+			modelData.vertexFormat = chooseVertexFormat(mesh->m_vertexData, mesh->m_numVertices);
 
 			for (auto& submesh : mesh->m_submeshes)
 			{
-				// Write indices
-				uint32_t numIndices = (uint32_t)submesh->m_indices.size();
-				fwrite(&numIndices, sizeof(uint32_t), 1, _file);
-				fwrite(submesh->m_indices.data(), numIndices * sizeof(uint32_t), 1, _file);
-
-				// Write material properties
-				std::shared_ptr<Material> material = submesh->m_material;
-				fwrite(&material->blend, sizeof(bool), 1, _file);
-				fwrite(&material->doubleSided, sizeof(bool), 1, _file);
-				fwrite(&material->baseColorFactor, sizeof(Vec3), 1, _file);
-				fwrite(&material->metallicFactor, sizeof(float), 1, _file);
-				fwrite(&material->roughnessFactor, sizeof(float), 1, _file);
-				fwrite(&material->normalScale, sizeof(float), 1, _file);
-				fwrite(&material->occlusionStrength, sizeof(float), 1, _file);
-				fwrite(&material->emissiveFactor, sizeof(Vec3), 1, _file);
-
-				// Write textures for the material
-				writeTexture(_file, material->baseColorTexture);
-				writeTexture(_file, material->metallicTexture);
-				writeTexture(_file, material->roughnessTexture);
-				writeTexture(_file, material->normalTexture);
-				writeTexture(_file, material->occlusionTexture);
-				writeTexture(_file, material->emissiveTexture);
+				SceneSubMeshData submeshData;
+				submeshData.indices.resize(submesh->m_numIndices);
+				for (uint32_t ii = 0; ii < submesh->m_numIndices; ++ii)
+				{
+					submeshData.indices[ii] = submesh->getIndex(0, ii);
+				}
+
+				for (uint32_t lod = 1; lod < submesh->getNumLods(); ++lod)
+				{
+					SceneLodData lodData;
+					lodData.error = submesh->getLodError(lod);
+					lodData.indices.resize(submesh->getNumIndices(lod));
+					for (uint32_t ii = 0; ii < (uint32_t)lodData.indices.size(); ++ii)
+					{
+						lodData.indices[ii] = submesh->getIndex(lod, ii);
+					}
+					submeshData.lods.push_back(std::move(lodData));
+				}
+				submeshData.material = UINT32_MAX;
+
+				const Material* material = submesh->m_material.get();
+				if (material != nullptr)
+				{
+					auto it = materialLookup.find(material);
+					if (it != materialLookup.end())
+					{
+						submeshData.material = it->second;
+					}
+					else
+					{
+						SceneMaterialData materialData;
+						materialData.blend = material->blend;
+						materialData.doubleSided = material->doubleSided;
+						materialData.baseColorFactor = material->baseColorFactor;
+						materialData.metallicFactor = material->metallicFactor;
+						materialData.roughnessFactor = material->roughnessFactor;
+						materialData.normalScale = material->normalScale;
+						materialData.occlusionStrength = material->occlusionStrength;
+						materialData.emissiveFactor = material->emissiveFactor;
+						materialData.textures[0] = texturePath(material->baseColorTexture);
+						materialData.textures[1] = texturePath(material->metallicTexture);
+						materialData.textures[2] = texturePath(material->roughnessTexture);
+						materialData.textures[3] = texturePath(material->normalTexture);
+						materialData.textures[4] = texturePath(material->occlusionTexture);
+						materialData.textures[5] = texturePath(material->emissiveTexture);
+
+						submeshData.material = (uint32_t)data.materials.size();
+						materialLookup[material] = submeshData.material;
+						data.materials.push_back(materialData);
+					}
+				}
+
+				modelData.submeshes.push_back(std::move(submeshData));
+			}
+
+			if (_optimizeMeshes)
+			{
+				optimizeModel(modelData);
 			}
+
+			data.models.push_back(std::move(modelData));
 		}
+
+		writeSceneV2(_file, data);
 	}
 
-	void Scene::read(FILE* _file)
+	void Scene::read(const char* _filepath)
 	{
-		uint32_t numModels = 0;
-		fread(&numModels, sizeof(uint32_t), 1, _file);
+		std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+		if (!file->open(_filepath))
+		{
+			return;
+		}
 
-		for (uint32_t ii = 0; ii < numModels; ++ii)
+		if (isSceneV2(file->getData(), file->getSize()))
 		{
+			readMapped(file);
+			return;
+		}
+
+		// Version 1 is parsed and copied
+		file->close();
+
+		FILE* legacy = nullptr;
+		fopen_s(&legacy, _filepath, "rb");
+		if (legacy != nullptr)
+		{
+			SceneData data;
+			if (readSceneV1(legacy, data))
+			{
+				readData(data);
+			}
+			fclose(legacy);
+		}
+	}
+
+	void Scene::readMapped(std::shared_ptr<MappedFile> _file)
+	{
+		SceneView view;
+		if (!parseSceneV2(_file->getData(), _file->getSize(), view))
+		{
+			return;
+		}
+
+		// Textures are shared by path, strings are stored once so the offset is the key
+		std::unordered_map<uint32_t, std::shared_ptr<Texture>> textures;
+		auto getTexture = [&](uint32_t _path) -> std::shared_ptr<Texture>
+		{
+			const char* path = view.getString(_path);
+			if (path == nullptr)
+			{
+				return nullptr;
+			}
+
+			std::shared_ptr<Texture>& texture = textures[_path];
+			if (texture == nullptr)
+			{
+				texture = loadTexture(path);
+			}
+			return texture;
+		};
+
+		// Materials
+		std::vector<std::shared_ptr<Material>> materials(view.numMaterials);
+		for (uint32_t ii = 0; ii < view.numMaterials; ++ii)
+		{
+			const SceneMaterial& src = view.materials[ii];
+
+			std::shared_ptr<Material> material = std::make_shared<Material>(MGE_MATERIAL_NONE);
+			material->blend = 0 != (src.flags & kSceneMaterialBlend);
+			material->doubleSided = 0 != (src.flags & kSceneMaterialDoubleSided);
+			material->baseColorFactor = src.baseColorFactor;
+			material->metallicFactor = src.metallicFactor;
+			material->roughnessFactor = src.roughnessFactor;
+			material->normalScale = src.normalScale;
+			material->occlusionStrength = src.occlusionStrength;
+			material->emissiveFactor = src.emissiveFactor;
+			material->baseColorTexture = getTexture(src.textures[0]);
+			material->metallicTexture = getTexture(src.textures[1]);
+			material->roughnessTexture = getTexture(src.textures[2]);
+			material->normalTexture = getTexture(src.textures[3]);
+			material->occlusionTexture = getTexture(src.textures[4]);
+			material->emissiveTexture = getTexture(src.textures[5]);
+			materials[ii] = material;
+		}
+
+		// Models, vertex and index data is referenced from the mapping
+		std::vector<std::shared_ptr<SubMesh>> allSubMeshes(view.numSubMeshes);
+		for (uint32_t ii = 0; ii < view.numModels; ++ii)
+		{
+			const SceneModel& src = view.models[ii];
+
 			std::shared_ptr<Model> model = std::make_shared<Model>();
+			model->setPosition(src.position);
+			model->setRotation(src.rotation);
+			model->setScale(src.scale);
 
-			// Read name
-			std::string name = readString(_file);
-
-			// Read transform
-			Vec3 position;
-			Quat rotation;
-			Vec3 scale;
-			fread(&position, sizeof(Vec3), 1, _file);
-			fread(&rotation, sizeof(Quat), 1, _file);
-			fread(&scale, sizeof(Vec3), 1, _file);
-			model->setPosition(position);
-			model->setRotation(rotation);
-			model->setScale(scale);
-
-			// Read vertices
-			std::vector<Vertex> vertices;
-			uint32_t numVertices = 0;
-			fread(&numVertices, sizeof(uint32_t), 1, _file);
-			vertices.resize(numVertices);
-			fread(vertices.data(), numVertices * sizeof(Vertex), 1, _file);
-
-			// Read submeshes
 			std::vector<std::shared_ptr<SubMesh>> subMeshes;
-			uint32_t numSubMeshes = 0;
-			fread(&numSubMeshes, sizeof(uint32_t), 1, _file);
+			subMeshes.reserve(src.numSubMeshes);
 
-			for (uint32_t jj = 0; jj < numSubMeshes; ++jj)
+			for (uint32_t jj = 0; jj < src.numSubMeshes; ++jj)
 			{
-				// Read indices
-				std::vector<uint32_t> indices;
-				uint32_t numIndices = 0;
-				fread(&numIndices, sizeof(uint32_t), 1, _file);
-				indices.resize(numIndices);
-				fread(indices.data(), numIndices * sizeof(uint32_t), 1, _file);
-
-				// Read material properties
-				std::shared_ptr<Material> material = std::make_shared<Material>(MGE_MATERIAL_NONE);
-				fread(&material->blend, sizeof(bool), 1, _file);
-				fread(&material->doubleSided, sizeof(bool), 1, _file);
-				fread(&material->baseColorFactor, sizeof(Vec3), 1, _file);
-				fread(&material->metallicFactor, sizeof(float), 1, _file);
-				fread(&material->roughnessFactor, sizeof(float), 1, _file);
-				fread(&material->normalScale, sizeof(float), 1, _file);
-				fread(&material->occlusionStrength, sizeof(float), 1, _file);
-				fread(&material->emissiveFactor, sizeof(Vec3), 1, _file);
-
-				// Read textures for the material
-				material->baseColorTexture = readTexture(_file);
-				material->metallicTexture = readTexture(_file);
-				material->roughnessTexture = readTexture(_file);
-				material->normalTexture = readTexture(_file);
-				material->occlusionTexture = readTexture(_file);
-				material->emissiveTexture = readTexture(_file);
-
-				std::shared_ptr<SubMesh> subMesh = std::make_shared<SubMesh>(indices, material);
-				subMeshes.push_back(subMesh);
+				const SceneSubMesh& submesh = view.submeshes[src.firstSubMesh + jj];
+				std::shared_ptr<Material> material = submesh.material != UINT32_MAX ? materials[submesh.material] : nullptr;
+
+				if (0 != (submesh.flags & kSceneSubMeshIndex16))
+				{
+					subMeshes.push_back(std::make_shared<SubMesh>(view.indices16 + submesh.firstIndex, submesh.numIndices, material, _file));
+				}
+				else
+				{
+					subMeshes.push_back(std::make_shared<SubMesh>(view.indices + submesh.firstIndex, submesh.numIndices, material, _file));
+				}
+
+				allSubMeshes[src.firstSubMesh + jj] = subMeshes.back();
 			}
 
-			std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>(vertices, subMeshes);
+			model->addMesh(std::make_shared<Mesh>(view.vertices + src.firstVertex, src.numVertices, subMeshes, _file, (VertexFormat::Enum)src.vertexFormat));
 
-			m_models[name] = model;
-			m_models[name]->addComponent<MeshComponent>(mesh);
+			const char* name = view.getString(src.name);
+			setModel(name != nullptr ? name : "", model);
 		}
-	}
 
-	void Scene::writeTexture(FILE* _file, std::shared_ptr<Texture> _texture)
-	{
-		bool hasTexture = _texture != nullptr;
-		fwrite(&hasTexture, sizeof(bool), 1, _file);
-
-		if (hasTexture)
+		// Levels of detail
+		for (uint32_t ii = 0; ii < view.numLods; ++ii)
 		{
-			writeString(_file, _texture->m_filepath);
+			const SceneLod& lod = view.lods[ii];
+
+			SubMesh* submesh = allSubMeshes[lod.submesh].get();
+			if (submesh == nullptr)
+			{
+				continue;
+			}
+
+			if (0 != (view.submeshes[lod.submesh].flags & kSceneSubMeshIndex16))
+			{
+				submesh->addLod(view.indices16 + lod.firstIndex, lod.numIndices, lod.error, _file);
+			}
+			else
+			{
+				submesh->addLod(view.indices + lod.firstIndex, lod.numIndices, lod.error, _file);
+			}
 		}
 	}
 
-	std::shared_ptr<Texture> Scene::readTexture(FILE* _file)
+	void Scene::readData(const SceneData& _data)
 	{
-		bool hasTexture = false;
-		fread(&hasTexture, sizeof(bool), 1, _file); 
+		std::unordered_map<std::string, std::shared_ptr<Texture>> textures;
+		auto getTexture = [&](const std::string& _path) -> std::shared_ptr<Texture>
+		{
+			if (_path.empty())
+			{
+				return nullptr;
+			}
+
+			std::shared_ptr<Texture>& texture = textures[_path];
+			if (texture == nullptr)
+			{
+				texture = loadTexture(_path.c_str());
+			}
+			return texture;
+		};
 
-		if (hasTexture)
+		// Materials
+		std::vector<std::shared_ptr<Material>> materials;
+		for (const SceneMaterialData& src : _data.materials)
 		{
-			std::string filepath = readString(_file);
-			return loadTexture(filepath.c_str()); 
+			std::shared_ptr<Material> material = std::make_shared<Material>(MGE_MATERIAL_NONE);
+			material->blend = src.blend;
+			material->doubleSided = src.doubleSided;
+			material->baseColorFactor = src.baseColorFactor;
+			material->metallicFactor = src.metallicFactor;
+			material->roughnessFactor = src.roughnessFactor;
+			material->normalScale = src.normalScale;
+			material->occlusionStrength = src.occlusionStrength;
+			material->emissiveFactor = src.emissiveFactor;
+			material->baseColorTexture = getTexture(src.textures[0]);
+			material->metallicTexture = getTexture(src.textures[1]);
+			material->roughnessTexture = getTexture(src.textures[2]);
+			material->normalTexture = getTexture(src.textures[3]);
+			material->occlusionTexture = getTexture(src.textures[4]);
+			material->emissiveTexture = getTexture(src.textures[5]);
+			materials.push_back(material);
 		}
-		else
+
+		// Models
+		for (const SceneModelData& src : _data.models)
 		{
-			return nullptr;
-		}
-	}
+			std::shared_ptr<Model> model = std::make_shared<Model>();
+			model->setPosition(src.position);
+			model->setRotation(src.rotation);
+			model->setScale(src.scale);
 
-	void Scene::writeString(FILE* _file, const std::string& _str)
-	{
-		uint32_t size = (uint32_t)_str.length() + 1;
-		fwrite(&size, sizeof(uint32_t), 1, _file);
-		fwrite(_str.c_str(), size, 1, _file);
-	}
+			std::vector<std::shared_ptr<SubMesh>> subMeshes;
+			for (const SceneSubMeshData& submesh : src.submeshes)
+			{
+				subMeshes.push_back(std::make_shared<SubMesh>(
+					submesh.indices, 
+					submesh.material != UINT32_MAX ? materials[submesh.material] : nullptr));
 
-	std::string Scene::readString(FILE* _file)
-	{
-		uint32_t size = 0;
-		fread(&size, sizeof(uint32_t), 1, _file);
-		char* buffer = new char[size];
-		fread(buffer, size, 1, _file);
-		std::string str(buffer);
-		delete[] buffer;
-
-		return str;
+				for (const SceneLodData& lod : submesh.lods)
+				{
+					subMeshes.back()->addLod(lod.indices, lod.error);
+				}
+			}
+
+			model->addMesh(std::make_shared<Mesh>(src.vertices, subMeshes, src.vertexFormat));
+			setModel(src.name, model);
+		}
 	}
 
 	Scene::Scene()
@@ -390,13 +575,7 @@ namespace mge
 	Scene::Scene(const char* _filepath)
 		: m_filepath(_filepath)
 	{
-		FILE* file = nullptr;
-		fopen_s(&file, _filepath, "rb");
-		if (file != nullptr)
-		{
-			read(file);
-			fclose(file);
-		}
+		read(_filepath);
 	}
 
 	Scene::~Scene()
@@ -408,7 +587,7 @@ namespace mge
 	{
 		if (isSessionValid())
 		{
-			m_mayaSession->update(m_models);
+			m_mayaSession->update(*this);
 		}
 	}
 
@@ -422,7 +601,7 @@ namespace mge
 		return _world->makeObject<Scene>(_filepath);
 	}
 
-	void Scene::save(const char* _filepath)
+	void Scene::save(const char* _filepath, bool _optimizeMeshes)
 	{
 		const char* filepath = nullptr;
 		if (_filepath)
@@ -438,8 +617,11 @@ namespace mge
 		{
 			FILE* file = nullptr;
 			fopen_s(&file, filepath, "wb");
-			write(file);
-			fclose(file);
+			if (file != nullptr)
+			{
+				write(file, _optimizeMeshes);
+				fclose(file);
+			}
 		}
 	}
 
@@ -447,7 +629,7 @@ namespace mge
 	{
 		if (m_mayaSession = std::make_unique<MayaSession>(m_filepath))
 		{
-			m_mayaSession->begin(m_models);
+			m_mayaSession->begin(*this);
 		}
 	}
 
@@ -469,4 +651,194 @@ namespace mge
 		}
 	}
 
+	bool convertScene(const char* _srcFilepath, const char* _dstFilepath)
+	{
+		FILE* src = nullptr;
+		fopen_s(&src, _srcFilepath, "rb");
+		if (src == nullptr)
+		{
+			return false;
+		}
+
+		SceneData data;
+		const bool read = readSceneV1(src, data);
+		fclose(src);
+
+		if (!read)
+		{
+			return false;
+		}
+
+		FILE* dst = nullptr;
+		fopen_s(&dst, _dstFilepath, "wb");
+		if (dst == nullptr)
+		{
+			return false;
+		}
+
+		const bool written = writeSceneV2(dst, data);
+		fclose(dst);
+
+		return written;
+	}
+
+	bool cookScene(const char* _filepath, bool _highQuality)
+	{
+		// Usage decides the format, a texture shared between slots keeps the first
+		std::vector<std::pair<std::string, TextureUsage::Enum> > textures;
+		std::unordered_map<std::string, uint32_t> indices;
+
+		auto addMaterial = [&](bool _blend, const char* const* _paths)
+		{
+			const TextureUsage::Enum usages[6] =
+			{
+				_blend ? TextureUsage::ColorAlpha : TextureUsage::Color, // Base color
+				TextureUsage::Linear, // Metallic
+				TextureUsage::Linear, // Roughness
+				TextureUsage::Normal, // Normal
+				TextureUsage::Linear, // Occlusion
+				TextureUsage::Color, // Emissive
+			};
+
+			for (uint32_t ii = 0; ii < 6; ++ii)
+			{
+				if (_paths[ii] == nullptr || _paths[ii][0] == '\0')
+				{
+					continue;
+				}
+
+				if (indices.emplace(_paths[ii], (uint32_t)textures.size()).second)
+				{
+					textures.emplace_back(_paths[ii], usages[ii]);
+				}
+			}
+		};
+
+		MappedFile file;
+		if (!file.open(_filepath))
+		{
+			return false;
+		}
+
+		if (isSceneV2(file.getData(), file.getSize()))
+		{
+			SceneView view;
+			if (!parseSceneV2(file.getData(), file.getSize(), view))
+			{
+				return false;
+			}
+
+			for (uint32_t ii = 0; ii < view.numMaterials; ++ii)
+			{
+				const SceneMaterial& material = view.materials[ii];
+
+				const char* paths[6];
+				for (uint32_t jj = 0; jj < 6; ++jj)
+				{
+					paths[jj] = view.getString(material.textures[jj]);
+				}
+				addMaterial((material.flags & kSceneMaterialBlend) != 0, paths);
+			}
+		}
+		else
+		{
+			file.close();
+
+			FILE* legacy = nullptr;
+			fopen_s(&legacy, _filepath, "rb");
+			if (legacy == nullptr)
+			{
+				return false;
+			}
+
+			SceneData data;
+			const bool read = readSceneV1(legacy, data);
+			fclose(legacy);
+
+			if (!read)
+			{
+				return false;
+			}
+
+			for (const SceneMaterialData& material : data.materials)
+			{
+				const char* paths[6];
+				for (uint32_t jj = 0; jj < 6; ++jj)
+				{
+					paths[jj] = material.textures[jj].c_str();
+				}
+				addMaterial(material.blend, paths);
+			}
+		}
+
+		// Encoding is slow, textures are cooked in parallel
+		std::atomic<uint32_t> numFailed(0);
+		getJobSystem().parallelFor((uint32_t)textures.size(), 1, [&](uint32_t _begin, uint32_t _end)
+			{
+				for (uint32_t ii = _begin; ii < _end; ++ii)
+				{
+					if (!cookTexture(textures[ii].first.c_str(), textures[ii].second, _highQuality))
+					{
+						numFailed++;
+					}
+				}
+			});
+
+		return numFailed == 0;
+	}
+
+	bool optimizeScene(const char* _filepath, MeshCacheReport* _report)
+	{
+		SceneData data;
+		if (!readScene(_filepath, data))
+		{
+			return false;
+		}
+
+		// Models are independent, optimized in parallel
+		std::vector<VertexCacheStats> before(data.models.size());
+		std::vector<VertexCacheStats> after(data.models.size());
+		getJobSystem().parallelFor((uint32_t)data.models.size(), 1, [&](uint32_t _begin, uint32_t _end)
+			{
+				for (uint32_t ii = _begin; ii < _end; ++ii)
+				{
+					before[ii] = analyzeModel(data.models[ii]);
+					optimizeModel(data.models[ii]);
+					after[ii] = analyzeModel(data.models[ii]);
+				}
+			});
+
+		VertexCacheStats totalBefore = {};
+		VertexCacheStats totalAfter = {};
+		for (uint32_t ii = 0; ii < (uint32_t)data.models.size(); ++ii)
+		{
+			BX_TRACE("%s: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f", data.models[ii].name.c_str()
+				, before[ii].getAcmr(), after[ii].getAcmr()
+				, before[ii].getAtvr(), after[ii].getAtvr());
+
+			addVertexCacheStats(totalBefore, before[ii]);
+			addVertexCacheStats(totalAfter, after[ii]);
+		}
+
+		if (_report != nullptr)
+		{
+			_report->acmrBefore = totalBefore.getAcmr();
+			_report->acmrAfter = totalAfter.getAcmr();
+			_report->atvrBefore = totalBefore.getAtvr();
+			_report->atvrAfter = totalAfter.getAtvr();
+		}
+
+		FILE* dst = nullptr;
+		fopen_s(&dst, _filepath, "wb");
+		if (dst == nullptr)
+		{
+			return false;
+		}
+
+		const bool written = writeSceneV2(dst, data);
+		fclose(dst);
+
+		return written;
+	}
+
 } // namespace mge
@@ -0,0 +1,723 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#include "scene_format.h"
+#include "engine/mapped_file.h"
+
+#include <string.h>
+#include <unordered_map>
+
+namespace mge
+{
+	static uint64_t alignUp(uint64_t _value)
+	{
+		return (_value + kSceneAlignment - 1) / kSceneAlignment * kSceneAlignment;
+	}
+
+	static bool writePadding(FILE* _file, uint64_t _size)
+	{
+		static const uint8_t s_zeros[kSceneAlignment] = {};
+		return _size == 0 || fwrite(s_zeros, (size_t)_size, 1, _file) == 1;
+	}
+
+	static bool writeBytes(FILE* _file, const void* _data, uint64_t _size)
+	{
+		return _size == 0 || fwrite(_data, (size_t)_size, 1, _file) == 1;
+	}
+
+	static bool readBytes(FILE* _file, void* _data, uint64_t _size)
+	{
+		return _size == 0 || fread(_data, (size_t)_size, 1, _file) == 1;
+	}
+
+	static bool readString(FILE* _file, std::string& _str)
+	{
+		uint32_t size = 0;
+		if (!readBytes(_file, &size, sizeof(uint32_t)))
+		{
+			return false;
+		}
+
+		_str.resize(size);
+		if (!readBytes(_file, &_str[0], size))
+		{
+			return false;
+		}
+
+		// Stored with the null terminator
+		_str.resize(strnlen(_str.c_str(), size));
+		return true;
+	}
+
+	static bool readTexture(FILE* _file, std::string& _filepath)
+	{
+		bool hasTexture = false;
+		if (!readBytes(_file, &hasTexture, sizeof(bool)))
+		{
+			return false;
+		}
+
+		_filepath.clear();
+		return !hasTexture || readString(_file, _filepath);
+	}
+
+	const char* SceneView::getString(uint32_t _offset) const
+	{
+		if (_offset == kSceneNoString || _offset >= stringsSize)
+		{
+			return nullptr;
+		}
+
+		return strings + _offset;
+	}
+
+	bool isSceneV2(const uint8_t* _data, uint64_t _size)
+	{
+		if (_size < sizeof(SceneHeader))
+		{
+			return false;
+		}
+
+		const SceneHeader* header = (const SceneHeader*)_data;
+		return header->magic == kSceneMagic;
+	}
+
+	template<typename Index>
+	static bool indicesInRange(const Index* _indices, uint32_t _numIndices, uint32_t _numVertices)
+	{
+		for (uint32_t ii = 0; ii < _numIndices; ++ii)
+		{
+			if (_indices[ii] >= _numVertices)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	static bool indicesInRange(const SceneView& _view, const SceneSubMesh& _submesh, uint32_t _firstIndex, uint32_t _numIndices, uint32_t _numVertices)
+	{
+		return 0 != (_submesh.flags & kSceneSubMeshIndex16)
+			? indicesInRange(_view.indices16 + _firstIndex, _numIndices, _numVertices)
+			: indicesInRange(_view.indices + _firstIndex, _numIndices, _numVertices);
+	}
+
+	bool parseSceneV2(const uint8_t* _data, uint64_t _size, SceneView& _view)
+	{
+		memset(&_view, 0, sizeof(SceneView));
+
+		if (!isSceneV2(_data, _size))
+		{
+			return false;
+		}
+
+		const SceneHeader* header = (const SceneHeader*)_data;
+		if (header->version != kSceneVersion
+			|| sizeof(SceneHeader) + uint64_t(header->numChunks) * sizeof(SceneChunk) > _size)
+		{
+			return false;
+		}
+
+		// Table of contents
+		static const uint32_t s_elementSize[SceneChunkType::Count] =
+		{
+			sizeof(SceneModel),
+			sizeof(SceneSubMesh),
+			sizeof(SceneMaterial),
+			sizeof(Vertex),
+			sizeof(uint32_t),
+			sizeof(char),
+			sizeof(uint16_t),
+			sizeof(SceneLod),
+		};
+
+		const uint8_t* chunkData[SceneChunkType::Count] = {};
+		uint32_t chunkCount[SceneChunkType::Count] = {};
+
+		const SceneChunk* chunks = (const SceneChunk*)(_data + sizeof(SceneHeader));
+		for (uint32_t ii = 0; ii < header->numChunks; ++ii)
+		{
+			const SceneChunk& chunk = chunks[ii];
+			if (chunk.type >= SceneChunkType::Count)
+			{
+				continue; // Unknown chunks are skipped
+			}
+
+			if (chunk.offset % kSceneAlignment != 0
+				|| chunk.offset > _size
+				|| chunk.size > _size - chunk.offset
+				|| chunk.size != uint64_t(chunk.count) * s_elementSize[chunk.type])
+			{
+				return false;
+			}
+
+			chunkData[chunk.type] = _data + chunk.offset;
+			chunkCount[chunk.type] = chunk.count;
+		}
+
+		_view.models = (const SceneModel*)chunkData[SceneChunkType::Models];
+		_view.numModels = chunkCount[SceneChunkType::Models];
+		_view.submeshes = (const SceneSubMesh*)chunkData[SceneChunkType::SubMeshes];
+		_view.numSubMeshes = chunkCount[SceneChunkType::SubMeshes];
+		_view.materials = (const SceneMaterial*)chunkData[SceneChunkType::Materials];
+		_view.numMaterials = chunkCount[SceneChunkType::Materials];
+		_view.vertices = (const Vertex*)chunkData[SceneChunkType::Vertices];
+		_view.numVertices = chunkCount[SceneChunkType::Vertices];
+		_view.indices = (const uint32_t*)chunkData[SceneChunkType::Indices];
+		_view.numIndices = chunkCount[SceneChunkType::Indices];
+		_view.strings = (const char*)chunkData[SceneChunkType::Strings];
+		_view.stringsSize = chunkCount[SceneChunkType::Strings];
+		_view.indices16 = (const uint16_t*)chunkData[SceneChunkType::Indices16];
+		_view.numIndices16 = chunkCount[SceneChunkType::Indices16];
+		_view.lods = (const SceneLod*)chunkData[SceneChunkType::Lods];
+		_view.numLods = chunkCount[SceneChunkType::Lods];
+
+		// Strings must be terminated so any offset can be read safely
+		if (_view.stringsSize != 0 && _view.strings[_view.stringsSize - 1] != '\0')
+		{
+			return false;
+		}
+
+		// Ranges
+		for (uint32_t ii = 0; ii < _view.numModels; ++ii)
+		{
+			const SceneModel& model = _view.models[ii];
+			if (uint64_t(model.firstSubMesh) + model.numSubMeshes > _view.numSubMeshes
+				|| uint64_t(model.firstVertex) + model.numVertices > _view.numVertices
+				|| model.vertexFormat >= VertexFormat::Count)
+			{
+				return false;
+			}
+		}
+
+		for (uint32_t ii = 0; ii < _view.numSubMeshes; ++ii)
+		{
+			const SceneSubMesh& submesh = _view.submeshes[ii];
+			const uint32_t numIndices = 0 != (submesh.flags & kSceneSubMeshIndex16) ? _view.numIndices16 : _view.numIndices;
+			if (uint64_t(submesh.firstIndex) + submesh.numIndices > numIndices
+				|| (submesh.material != UINT32_MAX && submesh.material >= _view.numMaterials))
+			{
+				return false;
+			}
+		}
+
+		for (uint32_t ii = 0; ii < _view.numLods; ++ii)
+		{
+			const SceneLod& lod = _view.lods[ii];
+			if (lod.submesh >= _view.numSubMeshes)
+			{
+				return false;
+			}
+
+			const SceneSubMesh& submesh = _view.submeshes[lod.submesh];
+			const uint32_t numIndices = 0 != (submesh.flags & kSceneSubMeshIndex16) ? _view.numIndices16 : _view.numIndices;
+			if (uint64_t(lod.firstIndex) + lod.numIndices > numIndices)
+			{
+				return false;
+			}
+		}
+
+		// Index values, anything past the vertices of its model would be read out of bounds
+		std::vector<uint32_t> submeshVertices(_view.numSubMeshes, 0);
+		for (uint32_t ii = 0; ii < _view.numModels; ++ii)
+		{
+			const SceneModel& model = _view.models[ii];
+			for (uint32_t jj = 0; jj < model.numSubMeshes; ++jj)
+			{
+				const SceneSubMesh& submesh = _view.submeshes[model.firstSubMesh + jj];
+				if (!indicesInRange(_view, submesh, submesh.firstIndex, submesh.numIndices, model.numVertices))
+				{
+					return false;
+				}
+
+				submeshVertices[model.firstSubMesh + jj] = model.numVertices;
+			}
+		}
+
+		for (uint32_t ii = 0; ii < _view.numLods; ++ii)
+		{
+			const SceneLod& lod = _view.lods[ii];
+			if (!indicesInRange(_view, _view.submeshes[lod.submesh], lod.firstIndex, lod.numIndices, submeshVertices[lod.submesh]))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool writeSceneV2(FILE* _file, const SceneData& _data)
+	{
+		std::vector<SceneModel> models;
+		std::vector<SceneSubMesh> submeshes;
+		std::vector<SceneMaterial> materials;
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices;
+		std::vector<uint16_t> indices16;
+		std::vector<SceneLod> lods;
+		std::vector<char> strings;
+
+		// Identical strings are stored once
+		std::unordered_map<std::string, uint32_t> stringOffsets;
+		auto addString = [&](const std::string& _str) -> uint32_t
+		{
+			if (_str.empty())
+			{
+				return kSceneNoString;
+			}
+
+			auto it = stringOffsets.find(_str);
+			if (it != stringOffsets.end())
+			{
+				return it->second;
+			}
+
+			const uint32_t offset = (uint32_t)strings.size();
+			strings.insert(strings.end(), _str.c_str(), _str.c_str() + _str.length() + 1);
+			stringOffsets[_str] = offset;
+			return offset;
+		};
+
+		for (const SceneMaterialData& data : _data.materials)
+		{
+			SceneMaterial material = {};
+			material.flags = 0
+				| (data.blend ? kSceneMaterialBlend : 0)
+				| (data.doubleSided ? kSceneMaterialDoubleSided : 0);
+			material.baseColorFactor = data.baseColorFactor;
+			material.metallicFactor = data.metallicFactor;
+			material.roughnessFactor = data.roughnessFactor;
+			material.normalScale = data.normalScale;
+			material.occlusionStrength = data.occlusionStrength;
+			material.emissiveFactor = data.emissiveFactor;
+
+			for (uint32_t ii = 0; ii < 6; ++ii)
+			{
+				material.textures[ii] = addString(data.textures[ii]);
+			}
+
+			materials.push_back(material);
+		}
+
+		for (const SceneModelData& data : _data.models)
+		{
+			SceneModel model = {};
+			model.name = addString(data.name);
+			model.firstSubMesh = (uint32_t)submeshes.size();
+			model.numSubMeshes = (uint32_t)data.submeshes.size();
+			model.firstVertex = (uint32_t)vertices.size();
+			model.numVertices = (uint32_t)data.vertices.size();
+			model.position = data.position;
+			model.rotation = data.rotation;
+			model.scale = data.scale;
+			model.vertexFormat = data.vertexFormat;
+			models.push_back(model);
+
+			vertices.insert(vertices.end(), data.vertices.begin(), data.vertices.end());
+
+			for (const SceneSubMeshData& submeshData : data.submeshes)
+			{
+				bool index16 = true;
+				for (uint32_t index : submeshData.indices)
+				{
+					index16 &= index <= UINT16_MAX;
+				}
+
+				SceneSubMesh submesh = {};
+				submesh.firstIndex = (uint32_t)(index16 ? indices16.size() : indices.size());
+				submesh.numIndices = (uint32_t)submeshData.indices.size();
+				submesh.material = submeshData.material;
+				submesh.flags = index16 ? kSceneSubMeshIndex16 : 0;
+				submeshes.push_back(submesh);
+
+				if (index16)
+				{
+					indices16.insert(indices16.end(), submeshData.indices.begin(), submeshData.indices.end());
+				}
+				else
+				{
+					indices.insert(indices.end(), submeshData.indices.begin(), submeshData.indices.end());
+				}
+
+				// Levels of detail use a subset of the vertices, the index width fits them too
+				for (const SceneLodData& lodData : submeshData.lods)
+				{
+					SceneLod lod = {};
+					lod.submesh = (uint32_t)submeshes.size() - 1;
+					lod.firstIndex = (uint32_t)(index16 ? indices16.size() : indices.size());
+					lod.numIndices = (uint32_t)lodData.indices.size();
+					lod.error = lodData.error;
+					lods.push_back(lod);
+
+					if (index16)
+					{
+						indices16.insert(indices16.end(), lodData.indices.begin(), lodData.indices.end());
+					}
+					else
+					{
+						indices.insert(indices.end(), lodData.indices.begin(), lodData.indices.end());
+					}
+				}
+			}
+		}
+
+		// Layout
+		const struct
+		{
+			uint32_t type;
+			const void* data;
+			uint32_t count;
+			uint64_t size;
+		} payload[SceneChunkType::Count] =
+		{
+			{ SceneChunkType::Models,    models.data(),    (uint32_t)models.size(),    models.size() * sizeof(SceneModel) },
+			{ SceneChunkType::SubMeshes, submeshes.data(), (uint32_t)submeshes.size(), submeshes.size() * sizeof(SceneSubMesh) },
+			{ SceneChunkType::Materials, materials.data(), (uint32_t)materials.size(), materials.size() * sizeof(SceneMaterial) },
+			{ SceneChunkType::Vertices,  vertices.data(),  (uint32_t)vertices.size(),  vertices.size() * sizeof(Vertex) },
+			{ SceneChunkType::Indices,   indices.data(),   (uint32_t)indices.size(),   indices.size() * sizeof(uint32_t) },
+			{ SceneChunkType::Strings,   strings.data(),   (uint32_t)strings.size(),   strings.size() * sizeof(char) },
+			{ SceneChunkType::Indices16, indices16.data(), (uint32_t)indices16.size(), indices16.size() * sizeof(uint16_t) },
+			{ SceneChunkType::Lods,      lods.data(),      (uint32_t)lods.size(),      lods.size() * sizeof(SceneLod) },
+		};
+
+		SceneHeader header = {};
+		header.magic = kSceneMagic;
+		header.version = kSceneVersion;
+		header.numChunks = SceneChunkType::Count;
+
+		SceneChunk chunks[SceneChunkType::Count];
+		uint64_t offset = alignUp(sizeof(SceneHeader) + sizeof(chunks));
+		for (uint32_t ii = 0; ii < SceneChunkType::Count; ++ii)
+		{
+			chunks[ii].type = payload[ii].type;
+			chunks[ii].count = payload[ii].count;
+			chunks[ii].offset = offset;
+			chunks[ii].size = payload[ii].size;
+			offset = alignUp(offset + payload[ii].size);
+		}
+
+		// Write
+		uint64_t written = sizeof(SceneHeader) + sizeof(chunks);
+		if (!writeBytes(_file, &header, sizeof(SceneHeader))
+			|| !writeBytes(_file, chunks, sizeof(chunks)))
+		{
+			return false;
+		}
+
+		for (uint32_t ii = 0; ii < SceneChunkType::Count; ++ii)
+		{
+			if (!writePadding(_file, chunks[ii].offset - written)
+				|| !writeBytes(_file, payload[ii].data, payload[ii].size))
+			{
+				return false;
+			}
+
+			written = chunks[ii].offset + payload[ii].size;
+		}
+
+		return writePadding(_file, alignUp(written) - written);
+	}
+
+	void readSceneV2(const SceneView& _view, SceneData& _data)
+	{
+		auto getString = [&](uint32_t _offset)
+		{
+			const char* str = _view.getString(_offset);
+			return str != nullptr ? std::string(str) : std::string();
+		};
+
+		_data.materials.resize(_view.numMaterials);
+		for (uint32_t ii = 0; ii < _view.numMaterials; ++ii)
+		{
+			const SceneMaterial& src = _view.materials[ii];
+			SceneMaterialData& material = _data.materials[ii];
+
+			material.blend = 0 != (src.flags & kSceneMaterialBlend);
+			material.doubleSided = 0 != (src.flags & kSceneMaterialDoubleSided);
+			material.baseColorFactor = src.baseColorFactor;
+			material.metallicFactor = src.metallicFactor;
+			material.roughnessFactor = src.roughnessFactor;
+			material.normalScale = src.normalScale;
+			material.occlusionStrength = src.occlusionStrength;
+			material.emissiveFactor = src.emissiveFactor;
+
+			for (uint32_t jj = 0; jj < 6; ++jj)
+			{
+				material.textures[jj] = getString(src.textures[jj]);
+			}
+		}
+
+		// Submesh index in the file to the submesh it was copied to
+		std::vector<SceneSubMeshData*> submeshes(_view.numSubMeshes, nullptr);
+
+		_data.models.resize(_view.numModels);
+		for (uint32_t ii = 0; ii < _view.numModels; ++ii)
+		{
+			const SceneModel& src = _view.models[ii];
+			SceneModelData& model = _data.models[ii];
+
+			model.name = getString(src.name);
+			model.position = src.position;
+			model.rotation = src.rotation;
+			model.scale = src.scale;
+			model.vertexFormat = (VertexFormat::Enum)src.vertexFormat;
+			model.vertices.assign(_view.vertices + src.firstVertex, _view.vertices + src.firstVertex + src.numVertices);
+
+			model.submeshes.resize(src.numSubMeshes);
+			for (uint32_t jj = 0; jj < src.numSubMeshes; ++jj)
+			{
+				const SceneSubMesh& submesh = _view.submeshes[src.firstSubMesh + jj];
+
+				if (0 != (submesh.flags & kSceneSubMeshIndex16))
+				{
+					const uint16_t* indices = _view.indices16 + submesh.firstIndex;
+					model.submeshes[jj].indices.assign(indices, indices + submesh.numIndices);
+				}
+				else
+				{
+					const uint32_t* indices = _view.indices + submesh.firstIndex;
+					model.submeshes[jj].indices.assign(indices, indices + submesh.numIndices);
+				}
+
+				model.submeshes[jj].material = submesh.material;
+				submeshes[src.firstSubMesh + jj] = &model.submeshes[jj];
+			}
+		}
+
+		for (uint32_t ii = 0; ii < _view.numLods; ++ii)
+		{
+			const SceneLod& lod = _view.lods[ii];
+
+			SceneSubMeshData* submesh = submeshes[lod.submesh];
+			if (submesh == nullptr)
+			{
+				continue;
+			}
+
+			SceneLodData lodData;
+			lodData.error = lod.error;
+
+			if (0 != (_view.submeshes[lod.submesh].flags & kSceneSubMeshIndex16))
+			{
+				const uint16_t* indices = _view.indices16 + lod.firstIndex;
+				lodData.indices.assign(indices, indices + lod.numIndices);
+			}
+			else
+			{
+				const uint32_t* indices = _view.indices + lod.firstIndex;
+				lodData.indices.assign(indices, indices + lod.numIndices);
+			}
+
+			submesh->lods.push_back(std::move(lodData));
+		}
+	}
+
+	bool readSceneV1(FILE* _file, SceneData& _data)
+	{
+		uint32_t numModels = 0;
+		if (!readBytes(_file, &numModels, sizeof(uint32_t)))
+		{
+			return false;
+		}
+
+		// Materials were written per submesh, identical ones are merged
+		std::unordered_map<std::string, uint32_t> materialLookup;
+
+		_data.models.resize(numModels);
+		for (SceneModelData& model : _data.models)
+		{
+			uint32_t numVertices = 0;
+			uint32_t numSubMeshes = 0;
+
+			if (!readString(_file, model.name)
+				|| !readBytes(_file, &model.position, sizeof(Vec3))
+				|| !readBytes(_file, &model.rotation, sizeof(Quat))
+				|| !readBytes(_file, &model.scale, sizeof(Vec3))
+				|| !readBytes(_file, &numVertices, sizeof(uint32_t)))
+			{
+				return false;
+			}
+
+			model.vertices.resize(numVertices);
+			if (!readBytes(_file, model.vertices.data(), numVertices * sizeof(Vertex))
+				|| !readBytes(_file, &numSubMeshes, sizeof(uint32_t)))
+			{
+				return false;
+			}
+
+			model.vertexFormat = chooseVertexFormat(model.vertices.data(), numVertices);
+
+			model.submeshes.resize(numSubMeshes);
+			for (SceneSubMeshData& submesh : model.submeshes)
+			{
+				uint32_t numIndices = 0;
+				if (!readBytes(_file, &numIndices, sizeof(uint32_t)))
+				{
+					return false;
+				}
+
+				submesh.indices.resize(numIndices);
+				if (!readBytes(_file, submesh.indices.data(), numIndices * sizeof(uint32_t)))
+				{
+					return false;
+				}
+
+				SceneMaterialData material;
+				if (!readBytes(_file, &material.blend, sizeof(bool))
+					|| !readBytes(_file, &material.doubleSided, sizeof(bool))
+					|| !readBytes(_file, &material.baseColorFactor, sizeof(Vec3))
+					|| !readBytes(_file, &material.metallicFactor, sizeof(float))
+					|| !readBytes(_file, &material.roughnessFactor, sizeof(float))
+					|| !readBytes(_file, &material.normalScale, sizeof(float))
+					|| !readBytes(_file, &material.occlusionStrength, sizeof(float))
+					|| !readBytes(_file, &material.emissiveFactor, sizeof(Vec3)))
+				{
+					return false;
+				}
+
+				for (uint32_t ii = 0; ii < 6; ++ii)
+				{
+					if (!readTexture(_file, material.textures[ii]))
+					{
+						return false;
+					}
+				}
+
+				std::string key;
+				key.append((const char*)&material.blend, sizeof(bool));
+				key.append((const char*)&material.doubleSided, sizeof(bool));
+				key.append((const char*)&material.baseColorFactor, sizeof(Vec3));
+				key.append((const char*)&material.metallicFactor, sizeof(float) * 4);
+				key.append((const char*)&material.emissiveFactor, sizeof(Vec3));
+				for (uint32_t ii = 0; ii < 6; ++ii)
+				{
+					key.append(material.textures[ii]);
+					key.push_back('\0');
+				}
+
+				auto it = materialLookup.find(key);
+				if (it != materialLookup.end())
+				{
+					submesh.material = it->second;
+				}
+				else
+				{
+					submesh.material = (uint32_t)_data.materials.size();
+					materialLookup[key] = submesh.material;
+					_data.materials.push_back(material);
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool readScene(const char* _filepath, SceneData& _data)
+	{
+		MappedFile file;
+		if (!file.open(_filepath))
+		{
+			return false;
+		}
+
+		if (isSceneV2(file.getData(), file.getSize()))
+		{
+			SceneView view;
+			if (!parseSceneV2(file.getData(), file.getSize(), view))
+			{
+				return false;
+			}
+
+			readSceneV2(view, _data);
+			return true;
+		}
+
+		file.close();
+
+		FILE* legacy = nullptr;
+		fopen_s(&legacy, _filepath, "rb");
+		if (legacy == nullptr)
+		{
+			return false;
+		}
+
+		const bool read = readSceneV1(legacy, _data);
+		fclose(legacy);
+
+		return read;
+	}
+
+	VertexCacheStats analyzeModel(const SceneModelData& _model)
+	{
+		VertexCacheStats stats = {};
+		for (const SceneSubMeshData& submesh : _model.submeshes)
+		{
+			addVertexCacheStats(stats, analyzeVertexCache(submesh.indices.data(), (uint32_t)submesh.indices.size(), (uint32_t)_model.vertices.size()));
+		}
+		return stats;
+	}
+
+	static constexpr uint32_t kMaxLods = 4; // Coarser levels of detail generated per submesh
+	static constexpr float kMaxLodError = 0.05f; // Relative to the model size
+
+	static void generateLods(SceneSubMeshData& _submesh, const SceneModelData& _model)
+	{
+		_submesh.lods.clear();
+
+		std::vector<uint32_t> indices(_submesh.indices.size());
+		uint32_t numIndices = (uint32_t)_submesh.indices.size();
+
+		// Each level halves the triangles of the last, always simplified from 
+		// the full submesh so errors do not add up
+		for (uint32_t lod = 0; lod < kMaxLods; ++lod)
+		{
+			const uint32_t target = numIndices / 6 * 3;
+			if (target < 3 * 16)
+			{
+				break;
+			}
+
+			float error = 0.0f;
+			const uint32_t count = simplifyTriangles(indices.data(), _submesh.indices.data(), (uint32_t)_submesh.indices.size()
+				, _model.vertices.data(), (uint32_t)_model.vertices.size(), target, kMaxLodError, error);
+
+			// Not worth the memory if the error bound stopped it early
+			if (count > numIndices * 3 / 4)
+			{
+				break;
+			}
+
+			SceneLodData lodData;
+			lodData.indices.assign(indices.begin(), indices.begin() + count);
+			lodData.error = error;
+			_submesh.lods.push_back(std::move(lodData));
+
+			numIndices = count;
+		}
+	}
+
+	void optimizeModel(SceneModelData& _model)
+	{
+		std::vector<std::vector<uint32_t>*> indexLists;
+		for (SceneSubMeshData& submesh : _model.submeshes)
+		{
+			generateLods(submesh, _model);
+
+			optimizeTriangles(submesh.indices.data(), (uint32_t)submesh.indices.size(), _model.vertices.data(), (uint32_t)_model.vertices.size());
+			indexLists.push_back(&submesh.indices);
+
+			for (SceneLodData& lod : submesh.lods)
+			{
+				optimizeTriangles(lod.indices.data(), (uint32_t)lod.indices.size(), _model.vertices.data(), (uint32_t)_model.vertices.size());
+				indexLists.push_back(&lod.indices);
+			}
+		}
+
+		// After triangles, so vertices follow the final draw order
+		optimizeVertexFetch(_model.vertices, indexLists);
+	}
+
+} // namespace mge
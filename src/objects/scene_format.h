@@ -0,0 +1,237 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#pragma once
+
+#include "engine/math.h"
+#include "engine/vertex.h"
+#include "renderer/mesh_optimizer.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace mge
+{
+	// Scene file version 2.
+	//
+	// The file is a single blob made to be memory mapped:
+	//
+	//   SceneHeader
+	//   SceneChunk[numChunks]   Table of contents
+	//   chunk data              Each chunk starts at a kSceneAlignment boundary
+	//
+	// Models reference ranges in the shared vertex, index and submesh chunks,
+	// and strings by byte offset into the string chunk, so nothing has to be
+	// parsed or copied per model.
+
+	static constexpr uint32_t kSceneMagic = 'M' | ('G' << 8) | ('E' << 16) | ('S' << 24);
+	static constexpr uint32_t kSceneVersion = 2;
+	static constexpr uint32_t kSceneAlignment = 16;
+	static constexpr uint32_t kSceneNoString = UINT32_MAX;
+
+	static constexpr uint32_t kSceneMaterialBlend = 1 << 0;
+	static constexpr uint32_t kSceneMaterialDoubleSided = 1 << 1;
+
+	static constexpr uint32_t kSceneSubMeshIndex16 = 1 << 0; // Indices are in the 16-bit index chunk
+
+	struct SceneChunkType
+	{
+		enum Enum
+		{
+			Models,    //!< SceneModel[]
+			SubMeshes, //!< SceneSubMesh[]
+			Materials, //!< SceneMaterial[]
+			Vertices,  //!< Vertex[]
+			Indices,   //!< uint32_t[]
+			Strings,   //!< Null terminated strings
+			Indices16, //!< uint16_t[]
+			Lods,      //!< SceneLod[]
+
+			Count
+		};
+	};
+
+	struct SceneHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t numChunks;
+		uint32_t reserved;
+	};
+
+	struct SceneChunk
+	{
+		uint32_t type;
+		uint32_t count; // Number of elements
+		uint64_t offset; // From start of file
+		uint64_t size; // In bytes
+	};
+
+	struct SceneModel
+	{
+		uint32_t name;
+		uint32_t firstSubMesh;
+		uint32_t numSubMeshes;
+		uint32_t firstVertex;
+		uint32_t numVertices;
+		Vec3 position;
+		Quat rotation;
+		Vec3 scale;
+		uint32_t vertexFormat; // VertexFormat::Enum chosen when written, zero is full
+	};
+
+	struct SceneSubMesh
+	{
+		uint32_t firstIndex;
+		uint32_t numIndices;
+		uint32_t material;
+		uint32_t flags;
+	};
+
+	// Coarser level of detail of a submesh, ordered by submesh then finest first.
+	// Indices are in the same index chunk as the submesh.
+	struct SceneLod
+	{
+		uint32_t submesh;
+		uint32_t firstIndex;
+		uint32_t numIndices;
+		float error; // Relative to the size of the model
+	};
+
+	struct SceneMaterial
+	{
+		uint32_t flags;
+		Vec3 baseColorFactor;
+		float metallicFactor;
+		float roughnessFactor;
+		float normalScale;
+		float occlusionStrength;
+		Vec3 emissiveFactor;
+		uint32_t textures[6]; // Base color, metallic, roughness, normal, occlusion, emissive
+		uint32_t reserved[3];
+	};
+
+	static_assert(sizeof(SceneHeader) == 16, "Scene file layout changed");
+	static_assert(sizeof(SceneChunk) == 24, "Scene file layout changed");
+	static_assert(sizeof(SceneModel) == 64, "Scene file layout changed");
+	static_assert(sizeof(SceneSubMesh) == 16, "Scene file layout changed");
+	static_assert(sizeof(SceneLod) == 16, "Scene file layout changed");
+	static_assert(sizeof(SceneMaterial) == 80, "Scene file layout changed");
+
+	/// Typed view of a mapped version 2 scene file.
+	///
+	struct SceneView
+	{
+		/// Get string from the string chunk.
+		///
+		/// @param[in] _offset Byte offset, or kSceneNoString.
+		///
+		/// @returns String, or nullptr.
+		///
+		const char* getString(uint32_t _offset) const;
+
+		const SceneModel* models;
+		uint32_t numModels;
+		const SceneSubMesh* submeshes;
+		uint32_t numSubMeshes;
+		const SceneMaterial* materials;
+		uint32_t numMaterials;
+		const Vertex* vertices;
+		uint32_t numVertices;
+		const uint32_t* indices;
+		uint32_t numIndices;
+		const uint16_t* indices16;
+		uint32_t numIndices16;
+		const SceneLod* lods;
+		uint32_t numLods;
+		const char* strings;
+		uint32_t stringsSize;
+	};
+
+	/// CPU side scene, used when reading the version 1 format and when writing.
+	///
+	struct SceneMaterialData
+	{
+		bool blend;
+		bool doubleSided;
+		Vec3 baseColorFactor;
+		float metallicFactor;
+		float roughnessFactor;
+		float normalScale;
+		float occlusionStrength;
+		Vec3 emissiveFactor;
+		std::string textures[6]; // Empty if not set
+	};
+
+	struct SceneLodData
+	{
+		std::vector<uint32_t> indices;
+		float error;
+	};
+
+	struct SceneSubMeshData
+	{
+		std::vector<uint32_t> indices; // Written as 16-bit if every index fits
+		std::vector<SceneLodData> lods; // Coarser levels of detail, finest first
+		uint32_t material;
+	};
+
+	struct SceneModelData
+	{
+		std::string name;
+		Vec3 position;
+		Quat rotation;
+		Vec3 scale;
+		VertexFormat::Enum vertexFormat;
+		std::vector<Vertex> vertices;
+		std::vector<SceneSubMeshData> submeshes;
+	};
+
+	struct SceneData
+	{
+		std::vector<SceneModelData> models;
+		std::vector<SceneMaterialData> materials;
+	};
+
+	/// Check if memory starts with a version 2 scene header.
+	///
+	bool isSceneV2(const uint8_t* _data, uint64_t _size);
+
+	/// Validate a version 2 scene and build a view into it.
+	///
+	/// @returns False if the file is malformed.
+	///
+	bool parseSceneV2(const uint8_t* _data, uint64_t _size, SceneView& _view);
+
+	/// Copy a version 2 scene into CPU side data, to be modified and written again.
+	///
+	void readSceneV2(const SceneView& _view, SceneData& _data);
+
+	/// Write a version 2 scene.
+	///
+	bool writeSceneV2(FILE* _file, const SceneData& _data);
+
+	/// Read a version 1 scene, the format written before the chunked container.
+	/// Every submesh has its own copy of its material.
+	///
+	bool readSceneV1(FILE* _file, SceneData& _data);
+
+	/// Read a scene file in either format into CPU side data.
+	///
+	bool readScene(const char* _filepath, SceneData& _data);
+
+	/// Vertex cache stats of the full detail submeshes of a model.
+	///
+	VertexCacheStats analyzeModel(const SceneModelData& _model);
+
+	/// Generate levels of detail, then reorder the triangles of every submesh
+	/// and level for the vertex cache and overdraw, and the vertices in the
+	/// order they are fetched. See optimizeScene.
+	///
+	void optimizeModel(SceneModelData& _model);
+
+} // namespace mge
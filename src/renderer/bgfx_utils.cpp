@@ -71,12 +71,7 @@ namespace mge
 
 		bgfx::TextureHandle loadTexture(const char* _filePath, uint64_t _flags, bgfx::TextureInfo* _info, bimg::Orientation::Enum* _orientation)
 		{
-			auto it = m_textures.find(_filePath);
-			if (it != m_textures.end())
-			{
-				return it->second; 
-			}
-
+			// Not cached, the caller owns the handle
 			bgfx::TextureHandle handle = BGFX_INVALID_HANDLE;
 
 			uint32_t size;
@@ -92,12 +87,6 @@ namespace mge
 						*_orientation = imageContainer->m_orientation;
 					}
 
-					const bgfx::Memory* mem = bgfx::makeRef(
-						imageContainer->m_data
-						, imageContainer->m_size
-						, imageReleaseCb
-						, imageContainer
-					);
 					unload(data);
 
 					if (nullptr != _info)
@@ -114,59 +103,16 @@ namespace mge
 						);
 					}
 
-					if (imageContainer->m_cubeMap)
-					{
-						handle = bgfx::createTextureCube(
-							uint16_t(imageContainer->m_width)
-							, 1 < imageContainer->m_numMips
-							, imageContainer->m_numLayers
-							, bgfx::TextureFormat::Enum(imageContainer->m_format)
-							, _flags
-							, mem
-						);
-					}
-					else if (1 < imageContainer->m_depth)
-					{
-						handle = bgfx::createTexture3D(
-							uint16_t(imageContainer->m_width)
-							, uint16_t(imageContainer->m_height)
-							, uint16_t(imageContainer->m_depth)
-							, 1 < imageContainer->m_numMips
-							, bgfx::TextureFormat::Enum(imageContainer->m_format)
-							, _flags
-							, mem
-						);
-					}
-					else if (bgfx::isTextureValid(0, false, imageContainer->m_numLayers, bgfx::TextureFormat::Enum(imageContainer->m_format), _flags))
-					{
-						handle = bgfx::createTexture2D(
-							uint16_t(imageContainer->m_width)
-							, uint16_t(imageContainer->m_height)
-							, 1 < imageContainer->m_numMips
-							, imageContainer->m_numLayers
-							, bgfx::TextureFormat::Enum(imageContainer->m_format)
-							, _flags
-							, mem
-						);
-					}
-
-					if (bgfx::isValid(handle))
-					{
-						const bx::StringView name(_filePath);
-						bgfx::setName(handle, name.getPtr(), name.getLength());
-					}
+					handle = bgfx::createTexture(imageContainer, _flags, _filePath);
 				}
 			}
 
-			m_textures[_filePath] = handle;
 			return handle;
 		}
 
 		bx::DefaultAllocator m_allocator;
 		bx::FileReader m_reader;
 		bx::FileWriter m_writer;
-
-		std::unordered_map<std::string, bgfx::TextureHandle> m_textures;
 	};
 
 } // namespace mge
@@ -235,4 +181,137 @@ namespace bgfx
 		return s_ctx->loadTexture(_filePath, _flags, _info, _orientation);
 	}
 
+	static bgfx::TextureHandle createTextureFromImage(bimg::ImageContainer* _imageContainer, uint64_t _flags)
+	{
+		bgfx::TextureHandle handle = BGFX_INVALID_HANDLE;
+
+		const bgfx::Memory* mem = bgfx::makeRef(
+			_imageContainer->m_data
+			, _imageContainer->m_size
+			, mge::imageReleaseCb
+			, _imageContainer
+		);
+
+		if (_imageContainer->m_cubeMap)
+		{
+			handle = bgfx::createTextureCube(
+				uint16_t(_imageContainer->m_width)
+				, 1 < _imageContainer->m_numMips
+				, _imageContainer->m_numLayers
+				, bgfx::TextureFormat::Enum(_imageContainer->m_format)
+				, _flags
+				, mem
+			);
+		}
+		else if (1 < _imageContainer->m_depth)
+		{
+			handle = bgfx::createTexture3D(
+				uint16_t(_imageContainer->m_width)
+				, uint16_t(_imageContainer->m_height)
+				, uint16_t(_imageContainer->m_depth)
+				, 1 < _imageContainer->m_numMips
+				, bgfx::TextureFormat::Enum(_imageContainer->m_format)
+				, _flags
+				, mem
+			);
+		}
+		else if (bgfx::isTextureValid(0, false, _imageContainer->m_numLayers, bgfx::TextureFormat::Enum(_imageContainer->m_format), _flags))
+		{
+			handle = bgfx::createTexture2D(
+				uint16_t(_imageContainer->m_width)
+				, uint16_t(_imageContainer->m_height)
+				, 1 < _imageContainer->m_numMips
+				, _imageContainer->m_numLayers
+				, bgfx::TextureFormat::Enum(_imageContainer->m_format)
+				, _flags
+				, mem
+			);
+		}
+		else
+		{
+			// Memory is only released by bgfx once it has been passed to a create call
+			bimg::imageFree(_imageContainer);
+		}
+
+		return handle;
+	}
+
+	bgfx::TextureHandle createTexture(bimg::ImageContainer* _imageContainer, uint64_t _flags, const char* _name, uint8_t _skipMips, bgfx::TextureInfo* _info)
+	{
+		bgfx::TextureHandle handle = BGFX_INVALID_HANDLE;
+
+		const uint8_t skipMips = _imageContainer->m_numMips > 1 ? bx::min<uint8_t>(_skipMips, _imageContainer->m_numMips - 1) : 0;
+		if (0 < skipMips 
+			&& !_imageContainer->m_cubeMap 
+			&& 1 == _imageContainer->m_depth)
+		{
+			// Copy the remaining mip chain of every layer
+			const uint16_t numLayers = _imageContainer->m_numLayers;
+			const uint8_t numMips = _imageContainer->m_numMips;
+
+			uint32_t size = 0;
+			for (uint16_t layer = 0; layer < numLayers; ++layer)
+			{
+				for (uint8_t lod = skipMips; lod < numMips; ++lod)
+				{
+					bimg::ImageMip mip;
+					bimg::imageGetRawData(*_imageContainer, layer, lod, _imageContainer->m_data, _imageContainer->m_size, mip);
+					size += mip.m_size;
+				}
+			}
+
+			const bgfx::Memory* mem = bgfx::alloc(size);
+
+			uint8_t* dst = mem->data;
+			for (uint16_t layer = 0; layer < numLayers; ++layer)
+			{
+				for (uint8_t lod = skipMips; lod < numMips; ++lod)
+				{
+					bimg::ImageMip mip;
+					bimg::imageGetRawData(*_imageContainer, layer, lod, _imageContainer->m_data, _imageContainer->m_size, mip);
+					bx::memCopy(dst, mip.m_data, mip.m_size);
+					dst += mip.m_size;
+				}
+			}
+
+			const uint16_t width = uint16_t(bx::max<uint32_t>(_imageContainer->m_width >> skipMips, 1));
+			const uint16_t height = uint16_t(bx::max<uint32_t>(_imageContainer->m_height >> skipMips, 1));
+			const bgfx::TextureFormat::Enum format = bgfx::TextureFormat::Enum(_imageContainer->m_format);
+			bimg::imageFree(_imageContainer);
+
+			if (nullptr != _info)
+			{
+				bgfx::calcTextureSize(*_info, width, height, 1, false, true, numLayers, format);
+			}
+
+			handle = bgfx::createTexture2D(width, height, true, numLayers, format, _flags, mem);
+		}
+		else
+		{
+			if (nullptr != _info)
+			{
+				bgfx::calcTextureSize(
+					*_info
+					, uint16_t(_imageContainer->m_width)
+					, uint16_t(_imageContainer->m_height)
+					, uint16_t(_imageContainer->m_depth)
+					, _imageContainer->m_cubeMap
+					, 1 < _imageContainer->m_numMips
+					, _imageContainer->m_numLayers
+					, bgfx::TextureFormat::Enum(_imageContainer->m_format)
+				);
+			}
+
+			handle = createTextureFromImage(_imageContainer, _flags);
+		}
+
+		if (bgfx::isValid(handle) && nullptr != _name)
+		{
+			const bx::StringView name(_name);
+			bgfx::setName(handle, name.getPtr(), name.getLength());
+		}
+
+		return handle;
+	}
+
 } // namespace bgfx
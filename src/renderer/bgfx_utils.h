@@ -101,4 +101,8 @@ namespace bgfx
 	void shutdownBgfxUtils();
 
 	bgfx::TextureHandle loadTexture(const char* _filePath, uint64_t _flags = BGFX_TEXTURE_NONE | BGFX_SAMPLER_NONE, bgfx::TextureInfo* _info = nullptr, bimg::Orientation::Enum* _orientation = nullptr);
+
+	// Takes ownership of the image, returns an invalid handle if the format is not supported.
+	// Top mips of 2D textures can be skipped to reduce memory.
+	bgfx::TextureHandle createTexture(bimg::ImageContainer* _imageContainer, uint64_t _flags, const char* _name, uint8_t _skipMips = 0, bgfx::TextureInfo* _info = nullptr);
 }
\ No newline at end of file
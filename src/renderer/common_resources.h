@@ -15,19 +15,38 @@ namespace mge
 			: firstFrame(true)
 			, view()
 			, proj()
+			, viewProj()
+			, prevViewProj()
+			, jitter()
+			, cameraNear(0.01f)
+			, cameraFar(100.0f)
 			, width(1280)
 			, height(720)
+			, renderWidth(1280)
+			, renderHeight(720)
+			, resolutionScale(1.0f)
+			, renderResized(false)
 		{
 		}
 
 		bool firstFrame;
 
 		float view[16];
-		float proj[16];
+		float proj[16]; // Jittered when temporal AA is on
+		float viewProj[16]; // Without jitter, for motion vectors
+		float prevViewProj[16]; // Of the previous frame, without jitter
+		float jitter[2]; // Sub-pixel offset of the projection in NDC
+		Vec3 cameraPosition;
 		Vec3 cameraDirection;
+		float cameraNear;
+		float cameraFar;
 
-		uint16_t width;
+		uint16_t width; // Back buffer
 		uint16_t height;
+		uint16_t renderWidth; // Scene targets, the back buffer scaled by resolutionScale
+		uint16_t renderHeight;
+		float resolutionScale;
+		bool renderResized; // Scene targets have to be recreated this frame
 	};
 
 } // namespace mge
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#include "frustum.h"
+
+#include <stdint.h>
+
+namespace mge
+{
+	static void setPlane(float* _plane, float _a, float _b, float _c, float _d)
+	{
+		const float len = sqrtf(_a * _a + _b * _b + _c * _c);
+		const float invLen = len > 0.0f ? 1.0f / len : 0.0f;
+
+		_plane[0] = _a * invLen;
+		_plane[1] = _b * invLen;
+		_plane[2] = _c * invLen;
+		_plane[3] = _d * invLen;
+	}
+
+	void Frustum::build(const float* _viewProj, bool _homogeneousDepth)
+	{
+		// Gribb & Hartmann, "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix"
+		// bx matrices transform row vectors, so clip space components are read out of the columns.
+		const float* m = _viewProj;
+
+		setPlane(planes[Left],   m[3] + m[0], m[7] + m[4], m[11] + m[8],  m[15] + m[12]);
+		setPlane(planes[Right],  m[3] - m[0], m[7] - m[4], m[11] - m[8],  m[15] - m[12]);
+		setPlane(planes[Bottom], m[3] + m[1], m[7] + m[5], m[11] + m[9],  m[15] + m[13]);
+		setPlane(planes[Top],    m[3] - m[1], m[7] - m[5], m[11] - m[9],  m[15] - m[13]);
+		setPlane(planes[Far],    m[3] - m[2], m[7] - m[6], m[11] - m[10], m[15] - m[14]);
+
+		if (_homogeneousDepth)
+		{
+			setPlane(planes[Near], m[3] + m[2], m[7] + m[6], m[11] + m[10], m[15] + m[14]);
+		}
+		else
+		{
+			setPlane(planes[Near], m[2], m[6], m[10], m[14]);
+		}
+	}
+
+	bool Frustum::intersects(const Aabb& _bounds) const
+	{
+		const Vec3 center = aabb_center(_bounds);
+		const Vec3 extents = aabb_extents(_bounds);
+
+		for (uint32_t ii = 0; ii < Count; ++ii)
+		{
+			const float* plane = planes[ii];
+
+			const float distance = plane[0] * center.x + plane[1] * center.y + plane[2] * center.z + plane[3];
+			const float radius = fabsf(plane[0]) * extents.x + fabsf(plane[1]) * extents.y + fabsf(plane[2]) * extents.z;
+
+			if (distance + radius < 0.0f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	Aabb transformAabb(const Aabb& _bounds, const float* _mtx)
+	{
+		// Arvo, "Transforming Axis-Aligned Bounding Boxes"
+		const Vec3 center = aabb_center(_bounds);
+		const Vec3 extents = aabb_extents(_bounds);
+
+		const Vec3 newCenter(
+			center.x * _mtx[0] + center.y * _mtx[4] + center.z * _mtx[8]  + _mtx[12],
+			center.x * _mtx[1] + center.y * _mtx[5] + center.z * _mtx[9]  + _mtx[13],
+			center.x * _mtx[2] + center.y * _mtx[6] + center.z * _mtx[10] + _mtx[14]);
+
+		const Vec3 newExtents(
+			extents.x * fabsf(_mtx[0]) + extents.y * fabsf(_mtx[4]) + extents.z * fabsf(_mtx[8]),
+			extents.x * fabsf(_mtx[1]) + extents.y * fabsf(_mtx[5]) + extents.z * fabsf(_mtx[9]),
+			extents.x * fabsf(_mtx[2]) + extents.y * fabsf(_mtx[6]) + extents.z * fabsf(_mtx[10]));
+
+		return Aabb(newCenter - newExtents, newCenter + newExtents);
+	}
+
+} // namespace mge
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#pragma once
+
+#include "engine/math.h"
+
+namespace mge
+{
+	/// View frustum used for visibility culling.
+	///
+	struct Frustum
+	{
+		enum Plane
+		{
+			Left,
+			Right,
+			Bottom,
+			Top,
+			Near,
+			Far,
+
+			Count
+		};
+
+		/// Extract frustum planes from a combined view projection matrix.
+		///
+		/// @param[in] _viewProj View projection matrix (bx convention, view * proj).
+		/// @param[in] _homogeneousDepth True if clip space depth is [-1, 1].
+		///
+		void build(const float* _viewProj, bool _homogeneousDepth);
+
+		/// Test a world space bounding box against the frustum.
+		///
+		/// @param[in] _bounds Bounding box in world space.
+		///
+		/// @returns False if the box is completely outside of the frustum.
+		///
+		bool intersects(const Aabb& _bounds) const;
+
+		float planes[Count][4]; // .xyz = normal, .w = distance
+	};
+
+	/// Transform a bounding box and return the box enclosing the result.
+	///
+	/// @param[in] _bounds Bounding box in local space.
+	/// @param[in] _mtx Transform matrix.
+	///
+	/// @returns Transformed bounding box.
+	///
+	Aabb transformAabb(const Aabb& _bounds, const float* _mtx);
+
+} // namespace mge
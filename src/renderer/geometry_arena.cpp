@@ -0,0 +1,367 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#include "geometry_arena.h"
+
+#include <bx/bx.h>
+
+namespace mge
+{
+	static constexpr uint32_t kVertexPageSize = 1 << 18; // Vertices per page, larger meshes get their own
+	static constexpr uint32_t kIndexPageSize = 1 << 20; // Indices per page, larger meshes get their own
+
+	static GeometryArena* s_arena = nullptr;
+
+	RangeAllocator::RangeAllocator(uint32_t _size)
+		: m_size(_size)
+		, m_used(0)
+	{
+		m_free[0] = _size;
+	}
+
+	bool RangeAllocator::alloc(uint32_t _size, uint32_t& _offset)
+	{
+		for (auto it = m_free.begin(); it != m_free.end(); ++it)
+		{
+			if (it->second < _size)
+			{
+				continue;
+			}
+
+			_offset = it->first;
+
+			const uint32_t remaining = it->second - _size;
+			m_free.erase(it);
+
+			if (remaining > 0)
+			{
+				m_free[_offset + _size] = remaining;
+			}
+
+			m_used += _size;
+			return true;
+		}
+
+		return false;
+	}
+
+	void RangeAllocator::free(uint32_t _offset, uint32_t _size)
+	{
+		m_used -= _size;
+
+		auto it = m_free.emplace(_offset, _size).first;
+
+		// Merge with next
+		auto next = std::next(it);
+		if (next != m_free.end() && it->first + it->second == next->first)
+		{
+			it->second += next->second;
+			m_free.erase(next);
+		}
+
+		// Merge with previous
+		if (it != m_free.begin())
+		{
+			auto prev = std::prev(it);
+			if (prev->first + prev->second == it->first)
+			{
+				prev->second += it->second;
+				m_free.erase(it);
+			}
+		}
+	}
+
+	uint32_t RangeAllocator::getSize() const
+	{
+		return m_size;
+	}
+
+	uint32_t RangeAllocator::getUsed() const
+	{
+		return m_used;
+	}
+
+	GeometryArena::GeometryArena()
+	{
+		m_vertexBoundsUniform = bgfx::createUniform("u_vertexBounds", bgfx::UniformType::Vec4, 2);
+	}
+
+	GeometryArena::~GeometryArena()
+	{
+		bgfx::destroy(m_vertexBoundsUniform);
+
+		for (VertexPage& page : m_vertexPages)
+		{
+			if (bgfx::isValid(page.handle))
+			{
+				bgfx::destroy(page.handle);
+			}
+		}
+
+		for (IndexPage& page : m_indexPages)
+		{
+			if (bgfx::isValid(page.handle))
+			{
+				bgfx::destroy(page.handle);
+			}
+		}
+	}
+
+	const bgfx::VertexLayout& GeometryArena::getLayout(VertexFormat::Enum _format)
+	{
+		return _format == VertexFormat::Packed ? PackedVertex::ms_layout : Vertex::ms_layout;
+	}
+
+	GeometryRange GeometryArena::allocVertices(const void* _vertices, uint32_t _numVertices, VertexFormat::Enum _format)
+	{
+		GeometryRange range = { UINT16_MAX, 0, 0 };
+		if (_numVertices == 0)
+		{
+			return range;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		uint16_t page = UINT16_MAX;
+		for (uint16_t ii = 0; ii < (uint16_t)m_vertexPages.size() && page == UINT16_MAX; ++ii)
+		{
+			if (bgfx::isValid(m_vertexPages[ii].handle)
+				&& m_vertexPages[ii].format == _format
+				&& m_vertexPages[ii].allocator.alloc(_numVertices, range.first))
+			{
+				page = ii;
+			}
+		}
+
+		if (page == UINT16_MAX)
+		{
+			// Reuse a released page slot so ranges keep their page index
+			for (uint16_t ii = 0; ii < (uint16_t)m_vertexPages.size() && page == UINT16_MAX; ++ii)
+			{
+				if (!bgfx::isValid(m_vertexPages[ii].handle))
+				{
+					page = ii;
+				}
+			}
+
+			if (page == UINT16_MAX)
+			{
+				page = (uint16_t)m_vertexPages.size();
+				m_vertexPages.push_back({ BGFX_INVALID_HANDLE, _format, RangeAllocator(0) });
+			}
+
+			const uint32_t size = bx::max(_numVertices, kVertexPageSize);
+
+			VertexPage& newPage = m_vertexPages[page];
+			newPage.handle = bgfx::createDynamicVertexBuffer(size, getLayout(_format));
+			newPage.format = _format;
+			newPage.allocator = RangeAllocator(size);
+			newPage.allocator.alloc(_numVertices, range.first);
+		}
+
+		range.page = page;
+		range.count = _numVertices;
+
+		bgfx::update(m_vertexPages[page].handle, range.first, bgfx::makeRef(_vertices, (uint32_t)(getLayout(_format).getStride() * _numVertices)));
+		return range;
+	}
+
+	GeometryRange GeometryArena::allocIndices(const void* _indices, uint32_t _numIndices, bool _index32)
+	{
+		GeometryRange range = { UINT16_MAX, 0, 0 };
+		if (_numIndices == 0)
+		{
+			return range;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		uint16_t page = UINT16_MAX;
+		for (uint16_t ii = 0; ii < (uint16_t)m_indexPages.size() && page == UINT16_MAX; ++ii)
+		{
+			if (bgfx::isValid(m_indexPages[ii].handle)
+				&& m_indexPages[ii].index32 == _index32
+				&& m_indexPages[ii].allocator.alloc(_numIndices, range.first))
+			{
+				page = ii;
+			}
+		}
+
+		if (page == UINT16_MAX)
+		{
+			// Reuse a released page slot so ranges keep their page index
+			for (uint16_t ii = 0; ii < (uint16_t)m_indexPages.size() && page == UINT16_MAX; ++ii)
+			{
+				if (!bgfx::isValid(m_indexPages[ii].handle))
+				{
+					page = ii;
+				}
+			}
+
+			if (page == UINT16_MAX)
+			{
+				page = (uint16_t)m_indexPages.size();
+				m_indexPages.push_back({ BGFX_INVALID_HANDLE, _index32, RangeAllocator(0) });
+			}
+
+			const uint32_t size = bx::max(_numIndices, kIndexPageSize);
+
+			IndexPage& newPage = m_indexPages[page];
+			newPage.handle = bgfx::createDynamicIndexBuffer(size, _index32 ? BGFX_BUFFER_INDEX32 : BGFX_BUFFER_NONE);
+			newPage.index32 = _index32;
+			newPage.allocator = RangeAllocator(size);
+			newPage.allocator.alloc(_numIndices, range.first);
+		}
+
+		range.page = page;
+		range.count = _numIndices;
+
+		const uint32_t indexSize = _index32 ? sizeof(uint32_t) : sizeof(uint16_t);
+		bgfx::update(m_indexPages[page].handle, range.first, bgfx::makeRef(_indices, indexSize * _numIndices));
+		return range;
+	}
+
+	void GeometryArena::freeVertices(const GeometryRange& _range)
+	{
+		if (_range.page == UINT16_MAX)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		VertexPage& page = m_vertexPages[_range.page];
+		page.allocator.free(_range.first, _range.count);
+
+		// First page is kept for meshes created later
+		if (_range.page > 0 && page.allocator.getUsed() == 0)
+		{
+			bgfx::destroy(page.handle);
+			page.handle = BGFX_INVALID_HANDLE;
+		}
+	}
+
+	void GeometryArena::freeIndices(const GeometryRange& _range)
+	{
+		if (_range.page == UINT16_MAX)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		IndexPage& page = m_indexPages[_range.page];
+		page.allocator.free(_range.first, _range.count);
+
+		// First page is kept for meshes created later
+		if (_range.page > 0 && page.allocator.getUsed() == 0)
+		{
+			bgfx::destroy(page.handle);
+			page.handle = BGFX_INVALID_HANDLE;
+		}
+	}
+
+	void GeometryArena::setVertexBuffer(bgfx::Encoder* _encoder, const Mesh& _mesh) const
+	{
+		const GeometryRange& range = _mesh.m_vertexRange;
+		if (range.page == UINT16_MAX)
+		{
+			return;
+		}
+
+		_encoder->setVertexBuffer(0, m_vertexPages[range.page].handle, range.first, range.count);
+
+		if (_mesh.m_vertexFormat == VertexFormat::Packed)
+		{
+			const Vec3 center = aabb_center(_mesh.m_bounds);
+			const Vec3 extents = aabb_extents(_mesh.m_bounds);
+
+			const float bounds[8] =
+			{
+				center.x, center.y, center.z, 0.0f,
+				extents.x, extents.y, extents.z, 0.0f,
+			};
+			_encoder->setUniform(m_vertexBoundsUniform, bounds, 2);
+		}
+	}
+
+	void GeometryArena::setIndexBuffer(bgfx::Encoder* _encoder, const SubMesh& _submesh, uint8_t _lod) const
+	{
+		const GeometryRange& range = _lod == 0 ? _submesh.m_indexRange : _submesh.m_lods[_lod - 1].indexRange;
+		if (range.page != UINT16_MAX)
+		{
+			_encoder->setIndexBuffer(m_indexPages[range.page].handle, range.first, range.count);
+		}
+	}
+
+	uint32_t GeometryArena::getNumPages() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		uint32_t numPages = 0;
+		for (const VertexPage& page : m_vertexPages)
+		{
+			numPages += bgfx::isValid(page.handle) ? 1 : 0;
+		}
+
+		for (const IndexPage& page : m_indexPages)
+		{
+			numPages += bgfx::isValid(page.handle) ? 1 : 0;
+		}
+
+		return numPages;
+	}
+
+	void GeometryArena::getVertexUsage(uint32_t& _used, uint32_t& _capacity) const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		_used = 0;
+		_capacity = 0;
+		for (const VertexPage& page : m_vertexPages)
+		{
+			if (bgfx::isValid(page.handle))
+			{
+				_used += page.allocator.getUsed();
+				_capacity += page.allocator.getSize();
+			}
+		}
+	}
+
+	void GeometryArena::getIndexUsage(uint32_t& _used, uint32_t& _size, uint32_t& _capacity) const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		_used = 0;
+		_size = 0;
+		_capacity = 0;
+		for (const IndexPage& page : m_indexPages)
+		{
+			if (bgfx::isValid(page.handle))
+			{
+				_used += page.allocator.getUsed();
+				_size += page.allocator.getUsed() * (page.index32 ? sizeof(uint32_t) : sizeof(uint16_t));
+				_capacity += page.allocator.getSize();
+			}
+		}
+	}
+
+	void initGeometryArena()
+	{
+		s_arena = new GeometryArena();
+	}
+
+	void shutdownGeometryArena()
+	{
+		delete s_arena;
+		s_arena = nullptr;
+	}
+
+	GeometryArena* getGeometryArena()
+	{
+		return s_arena;
+	}
+
+} // namespace mge
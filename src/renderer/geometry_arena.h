@@ -0,0 +1,139 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#pragma once
+
+#include "engine/mesh.h"
+
+#include <bgfx/bgfx.h>
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace mge
+{
+	/// First fit allocator over a range of elements. Freed ranges are merged 
+	/// with free neighbours so the free list does not fragment.
+	/// 
+	class RangeAllocator
+	{
+	public:
+		RangeAllocator(uint32_t _size);
+
+		/// Allocate a range.
+		/// 
+		/// @param[in] _size Number of elements.
+		/// @param[out] _offset First element of range.
+		/// 
+		/// @returns False if there is no free range large enough.
+		/// 
+		bool alloc(uint32_t _size, uint32_t& _offset);
+
+		/// Free a range returned by alloc.
+		/// 
+		void free(uint32_t _offset, uint32_t _size);
+
+		uint32_t getSize() const;
+		uint32_t getUsed() const;
+
+	private:
+		std::map<uint32_t, uint32_t> m_free; // Offset to size
+		uint32_t m_size;
+		uint32_t m_used;
+	};
+
+	/// Shared geometry buffers.
+	/// 
+	/// Meshes are sub-allocated out of a few large dynamic vertex and index 
+	/// buffers instead of each owning its own. Draws select their range with 
+	/// a start vertex, which acts as base vertex for indexed draws, and a 
+	/// start index. Pages left empty by removed meshes are released.
+	/// 
+	class GeometryArena
+	{
+		struct VertexPage
+		{
+			bgfx::DynamicVertexBufferHandle handle;
+			VertexFormat::Enum format;
+			RangeAllocator allocator;
+		};
+
+		struct IndexPage
+		{
+			bgfx::DynamicIndexBufferHandle handle;
+			bool index32; // Each index width has its own pages
+			RangeAllocator allocator;
+		};
+
+	public:
+		GeometryArena();
+		~GeometryArena();
+
+		/// Allocate and upload vertices.
+		/// 
+		/// @param[in] _vertices Vertices, referenced until the upload is done.
+		/// @param[in] _numVertices Number of vertices.
+		/// @param[in] _format Format of vertices, each format has its own pages.
+		/// 
+		/// @returns Range in the shared vertex buffers.
+		/// 
+		GeometryRange allocVertices(const void* _vertices, uint32_t _numVertices, VertexFormat::Enum _format);
+
+		/// Allocate and upload indices.
+		/// 
+		/// @param[in] _indices Indices, relative to the first vertex of the mesh.
+		/// @param[in] _numIndices Number of indices.
+		/// @param[in] _index32 True if indices are 32-bit, otherwise 16-bit.
+		/// 
+		/// @returns Range in the shared index buffers.
+		/// 
+		GeometryRange allocIndices(const void* _indices, uint32_t _numIndices, bool _index32);
+
+		void freeVertices(const GeometryRange& _range);
+		void freeIndices(const GeometryRange& _range);
+
+		/// Bind the vertices of a mesh, and the bounds packed positions are 
+		/// quantized to. Thread safe while no meshes are created or destroyed.
+		/// 
+		void setVertexBuffer(bgfx::Encoder* _encoder, const Mesh& _mesh) const;
+
+		/// Bind the indices of a sub mesh level of detail. Thread safe while no 
+		/// meshes are created or destroyed.
+		/// 
+		void setIndexBuffer(bgfx::Encoder* _encoder, const SubMesh& _submesh, uint8_t _lod) const;
+
+		/// Get number of vertex and index buffers in use.
+		/// 
+		uint32_t getNumPages() const;
+
+		/// Get number of vertices allocated and the capacity of all pages.
+		/// 
+		void getVertexUsage(uint32_t& _used, uint32_t& _capacity) const;
+
+		/// Get number of indices allocated, their size in bytes and the 
+		/// capacity of all pages.
+		/// 
+		void getIndexUsage(uint32_t& _used, uint32_t& _size, uint32_t& _capacity) const;
+
+	private:
+		static const bgfx::VertexLayout& getLayout(VertexFormat::Enum _format);
+
+		std::vector<VertexPage> m_vertexPages;
+		std::vector<IndexPage> m_indexPages;
+		mutable std::mutex m_mutex;
+		bgfx::UniformHandle m_vertexBoundsUniform;
+	};
+
+	void initGeometryArena();
+	void shutdownGeometryArena();
+
+	/// Get the geometry arena.
+	/// 
+	/// @returns Geometry arena, nullptr if no renderer has been created.
+	/// 
+	GeometryArena* getGeometryArena();
+
+} // namespace mge
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#include "instancing.h"
+
+#include "engine/settings.h"
+
+#include <bx/bx.h>
+
+#include <functional>
+#include <mutex>
+
+namespace mge
+{
+	static constexpr uint16_t kInstanceStride = 16 * sizeof(float);
+
+	// Batches can be submitted from several encoders at once, checking and 
+	// allocating transient instance data has to happen as one step.
+	static std::mutex s_instanceDataMutex;
+
+	size_t InstanceBatcher::KeyHash::operator()(const Key& _key) const
+	{
+		size_t hash = std::hash<const void*>()(_key.mesh);
+		hash ^= std::hash<const void*>()(_key.submesh) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		hash ^= std::hash<const void*>()(_key.material) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		hash ^= std::hash<uint8_t>()(_key.lod) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		hash ^= std::hash<bool>()(_key.moving) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		return hash;
+	}
+
+	InstanceBatcher::InstanceBatcher()
+		: m_numBatches(0)
+	{
+	}
+
+	void InstanceBatcher::begin()
+	{
+		for (uint32_t ii = 0; ii < m_numBatches; ++ii)
+		{
+			InstanceBatch& batch = m_batches[ii];
+			batch.mesh.reset();
+			batch.submesh.reset();
+			batch.material.reset();
+			batch.lod = 0;
+			batch.transforms.clear();
+			batch.prevTransforms.clear();
+			batch.numInstances = 0;
+			batch.moving = false;
+			batch.depth = 0.0f;
+		}
+
+		m_lookup.clear();
+		m_numBatches = 0;
+	}
+
+	void InstanceBatcher::add(const std::shared_ptr<Mesh>& _mesh, const std::shared_ptr<SubMesh>& _submesh, const std::shared_ptr<Material>& _material, uint8_t _lod, const float* _mtx, float _depth, const float* _prevMtx)
+	{
+		const bool moving = _prevMtx != nullptr;
+		const Key key = { _mesh.get(), _submesh.get(), _material.get(), _lod, moving };
+
+		uint32_t idx;
+		auto it = m_lookup.find(key);
+		if (it != m_lookup.end())
+		{
+			idx = it->second;
+		}
+		else
+		{
+			idx = m_numBatches++;
+			if (idx == m_batches.size())
+			{
+				m_batches.emplace_back();
+			}
+
+			InstanceBatch& batch = m_batches[idx];
+			batch.mesh = _mesh;
+			batch.submesh = _submesh;
+			batch.material = _material;
+			batch.lod = _lod;
+			batch.numInstances = 0;
+			batch.moving = moving;
+			batch.depth = _depth;
+
+			m_lookup.emplace(key, idx);
+		}
+
+		InstanceBatch& batch = m_batches[idx];
+		batch.transforms.insert(batch.transforms.end(), _mtx, _mtx + 16);
+		if (moving)
+		{
+			batch.prevTransforms.insert(batch.prevTransforms.end(), _prevMtx, _prevMtx + 16);
+		}
+		batch.numInstances++;
+		batch.depth = bx::min(batch.depth, _depth);
+	}
+
+	uint32_t InstanceBatcher::allocInstanceData(bgfx::InstanceDataBuffer* _idb, const InstanceBatch& _batch, uint32_t _first)
+	{
+		const uint32_t requested = _batch.numInstances - _first;
+
+		uint32_t num = 0;
+		{
+			std::lock_guard<std::mutex> lock(s_instanceDataMutex);
+
+			num = bgfx::getAvailInstanceDataBuffer(requested, kInstanceStride);
+			if (num == 0)
+			{
+				return 0;
+			}
+
+			bgfx::allocInstanceDataBuffer(_idb, num, kInstanceStride);
+		}
+
+		bx::memCopy(_idb->data, &_batch.transforms[_first * 16], num * kInstanceStride);
+
+		return num;
+	}
+
+	bool InstanceBatcher::isEnabled()
+	{
+		const bgfx::Caps* caps = bgfx::getCaps();
+		return getSettings().renderer.instancing 
+			&& 0 != (caps->supported & BGFX_CAPS_INSTANCING);
+	}
+
+	bool InstanceBatcher::isInstanced(const InstanceBatch& _batch)
+	{
+		// Moving instances need their previous transform, which doesn't fit the instance data
+		return _batch.numInstances > 1 
+			&& !_batch.moving 
+			&& isEnabled();
+	}
+
+	uint32_t InstanceBatcher::getNumBatches() const
+	{
+		return m_numBatches;
+	}
+
+	const InstanceBatch& InstanceBatcher::getBatch(uint32_t _idx) const
+	{
+		return m_batches[_idx];
+	}
+
+} // namespace mge
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#pragma once
+
+#include <bgfx/bgfx.h>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace mge
+{
+	class Mesh;
+	class SubMesh;
+	class Material;
+
+	/// All visible instances of a sub mesh rendered with the same material.
+	///
+	struct InstanceBatch
+	{
+		std::shared_ptr<Mesh> mesh;
+		std::shared_ptr<SubMesh> submesh;
+		std::shared_ptr<Material> material;
+		uint8_t lod; // Level of detail of the sub mesh
+		std::vector<float> transforms; // 16 floats per instance
+		std::vector<float> prevTransforms; // 16 floats per instance, only filled for moving batches
+		uint32_t numInstances;
+		bool moving; // Instances moved since the previous frame, drawn one by one with their previous transform
+		float depth; // Distance to nearest instance
+	};
+
+	/// Groups (Mesh, SubMesh, Material, LOD) draws so duplicated meshes can be 
+	/// submitted as a single instanced draw call.
+	///
+	class InstanceBatcher
+	{
+		struct Key
+		{
+			const Mesh* mesh;
+			const SubMesh* submesh;
+			const Material* material;
+			uint8_t lod;
+			bool moving;
+
+			bool operator==(const Key& _other) const
+			{
+				return mesh == _other.mesh
+					&& submesh == _other.submesh
+					&& material == _other.material
+					&& lod == _other.lod
+					&& moving == _other.moving;
+			}
+		};
+
+		struct KeyHash
+		{
+			size_t operator()(const Key& _key) const;
+		};
+
+	public:
+		InstanceBatcher();
+
+		/// Clear all batches. Allocated memory is kept for the next frame.
+		///
+		void begin();
+
+		/// Add an instance of a sub mesh.
+		///
+		/// @param[in] _mesh Parent mesh owning the vertex buffer.
+		/// @param[in] _submesh Sub mesh owning the index buffer.
+		/// @param[in] _material Material used by the sub mesh, can be null.
+		/// @param[in] _lod Level of detail of the sub mesh.
+		/// @param[in] _mtx Model transform matrix.
+		/// @param[in] _depth Distance from the viewer, used for sorting.
+		/// @param[in] _prevMtx Model transform matrix of the previous frame, null if it didn't move.
+		///
+		void add(const std::shared_ptr<Mesh>& _mesh, const std::shared_ptr<SubMesh>& _submesh, const std::shared_ptr<Material>& _material, uint8_t _lod, const float* _mtx, float _depth, const float* _prevMtx = nullptr);
+
+		/// Allocate and fill an instance data buffer from a batch.
+		///
+		/// @param[out] _idb Instance data buffer to fill.
+		/// @param[in] _batch Batch to read transforms from.
+		/// @param[in] _first Index of first instance to copy.
+		///
+		/// @returns Number of instances written, may be less than requested if 
+		/// the frame is out of instance data memory.
+		///
+		static uint32_t allocInstanceData(bgfx::InstanceDataBuffer* _idb, const InstanceBatch& _batch, uint32_t _first);
+
+		/// Check if instanced draws should be used this frame.
+		///
+		/// @returns True if instancing is enabled and supported by the renderer.
+		///
+		static bool isEnabled();
+
+		/// Check if a batch should be drawn instanced. Every pass drawing the
+		/// batch has to agree, or depth won't match between them.
+		///
+		/// @param[in] _batch Batch to draw.
+		///
+		/// @returns True if instancing is enabled and the batch has more than one still instance.
+		///
+		static bool isInstanced(const InstanceBatch& _batch);
+
+		/// Get the number of batches added since begin.
+		///
+		uint32_t getNumBatches() const;
+
+		/// Get batch by index.
+		///
+		const InstanceBatch& getBatch(uint32_t _idx) const;
+
+	private:
+		std::unordered_map<Key, uint32_t, KeyHash> m_lookup;
+		std::vector<InstanceBatch> m_batches;
+		uint32_t m_numBatches;
+	};
+
+} // namespace mge
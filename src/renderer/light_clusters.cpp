@@ -0,0 +1,317 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#include "light_clusters.h"
+#include "common_resources.h"
+
+#include "engine/world.h"
+#include "engine/settings.h"
+#include "engine/objects/light.h"
+
+#include <bx/bx.h>
+#include <bx/math.h>
+
+namespace mge
+{
+	static constexpr uint32_t kNumClusters = LightClusters::kClustersX * LightClusters::kClustersY * LightClusters::kClustersZ;
+	static constexpr uint32_t kTexelsPerLight = 3;
+
+	// Sphere enclosing the lit volume, in view space
+	static void getLightBounds(const Light& _light, const Vec3& _position, const Vec3& _direction, Vec3& _center, float& _radius)
+	{
+		const float range = _light.getRange();
+
+		_center = _position;
+		_radius = range;
+
+		if (_light.getType() != LightType::Spot)
+		{
+			return;
+		}
+
+		// Sphere through the apex and the rim of the cone, when smaller
+		const float angle = bx::toRad(_light.getSpotOuterAngle());
+		const float axial = range * bx::cos(angle) - range * 0.5f;
+		const float radial = range * bx::sin(angle);
+		const float radius = bx::max(range * 0.5f, bx::sqrt(axial * axial + radial * radial));
+
+		if (radius < _radius)
+		{
+			_center = _position + _direction * (range * 0.5f);
+			_radius = radius;
+		}
+	}
+
+	LightClusters::LightClusters()
+		: m_near(0.01f)
+		, m_far(100.0f)
+		, m_sliceScale(0.0f)
+		, m_sliceBias(0.0f)
+		, m_depthSign(1.0f)
+		, m_numLights(0)
+		, m_numVisible(0)
+		, m_numIndices(0)
+		, m_maxPerCluster(0)
+	{
+		const uint64_t flags = BGFX_SAMPLER_POINT | BGFX_SAMPLER_UVW_CLAMP;
+
+		m_lightsTexture = bgfx::createTexture2D(kTexelsPerLight, kMaxLights, false, 1, bgfx::TextureFormat::RGBA32F, flags);
+		m_gridTexture = bgfx::createTexture2D(kClustersX * kClustersY, kClustersZ, false, 1, bgfx::TextureFormat::RG32F, flags);
+		m_indicesTexture = bgfx::createTexture2D(kIndicesWidth, kMaxIndices / kIndicesWidth, false, 1, bgfx::TextureFormat::R32F, flags);
+
+		s_lights = bgfx::createUniform("s_lights", bgfx::UniformType::Sampler);
+		s_lightGrid = bgfx::createUniform("s_lightGrid", bgfx::UniformType::Sampler);
+		s_lightIndices = bgfx::createUniform("s_lightIndices", bgfx::UniformType::Sampler);
+		m_clusterParamsUniform = bgfx::createUniform("u_clusterParams", bgfx::UniformType::Vec4);
+		m_clusterDepthUniform = bgfx::createUniform("u_clusterDepth", bgfx::UniformType::Vec4);
+
+		m_counts.resize(kNumClusters);
+		m_grid.resize(kNumClusters * 2);
+	}
+
+	LightClusters::~LightClusters()
+	{
+		bgfx::destroy(m_lightsTexture);
+		bgfx::destroy(m_gridTexture);
+		bgfx::destroy(m_indicesTexture);
+
+		bgfx::destroy(s_lights);
+		bgfx::destroy(s_lightGrid);
+		bgfx::destroy(s_lightIndices);
+		bgfx::destroy(m_clusterParamsUniform);
+		bgfx::destroy(m_clusterDepthUniform);
+	}
+
+	uint32_t LightClusters::getSlice(float _depth) const
+	{
+		const float slice = bx::floor(bx::log(_depth) * m_sliceScale - m_sliceBias);
+		return uint32_t(bx::clamp(slice, 0.0f, float(kClustersZ - 1)));
+	}
+
+	void LightClusters::update(const World& _world, const CommonResources& _common)
+	{
+		const Settings& settings = getSettings();
+
+		// Exponential slices, each one is about as deep as it is wide
+		m_near = bx::max(_common.cameraNear, 0.01f);
+		m_far = bx::max(bx::min(_common.cameraFar, settings.renderer.lightDistance), m_near * 2.0f);
+		m_sliceScale = float(kClustersZ) / bx::log(m_far / m_near);
+		m_sliceBias = bx::log(m_near) * m_sliceScale;
+
+		// View space depth axis, projections can be left or right handed
+		const float* proj = _common.proj;
+		m_depthSign = proj[11] != 0.0f ? bx::sign(proj[11]) : bx::sign(proj[10]);
+
+		m_numLights = (uint32_t)_world.m_lights.size();
+		m_numVisible = 0;
+
+		m_lights.resize(kMaxLights * kTexelsPerLight * 4);
+		m_ranges.clear();
+
+		for (const Light* light : _world.m_lights)
+		{
+			if (m_numVisible == kMaxLights)
+			{
+				break;
+			}
+
+			if (light->getRange() <= 0.0f || light->getIntensity() <= 0.0f)
+			{
+				continue;
+			}
+
+			// Spot lights shine along -Z
+			const float* mtx = light->getWorldMatrix();
+			const bx::Vec3 position = bx::mul({ mtx[12], mtx[13], mtx[14] }, _common.view);
+			const bx::Vec3 direction = bx::normalize(bx::mulXyz0({ -mtx[8], -mtx[9], -mtx[10] }, _common.view));
+
+			const Vec3 viewPosition(position.x, position.y, position.z);
+			const Vec3 viewDirection(direction.x, direction.y, direction.z);
+
+			Vec3 center;
+			float radius;
+			getLightBounds(*light, viewPosition, viewDirection, center, radius);
+
+			const float depth = center.z * m_depthSign;
+			const float minDepth = depth - radius;
+			const float maxDepth = depth + radius;
+			if (maxDepth < m_near || minDepth > m_far)
+			{
+				continue;
+			}
+
+			// Screen rect of the view space box around the sphere, all of it
+			// when the box reaches behind the near plane
+			float minX = -1.0f, maxX = 1.0f;
+			float minY = -1.0f, maxY = 1.0f;
+			if (minDepth > m_near)
+			{
+				minX = minY = 1.0f;
+				maxX = maxY = -1.0f;
+
+				for (uint32_t ii = 0; ii < 8; ++ii)
+				{
+					const bx::Vec3 corner =
+					{
+						center.x + ((ii & 1) ? radius : -radius),
+						center.y + ((ii & 2) ? radius : -radius),
+						center.z + ((ii & 4) ? radius : -radius),
+					};
+
+					const bx::Vec3 ndc = bx::mulH(corner, proj);
+					minX = bx::min(minX, ndc.x);
+					maxX = bx::max(maxX, ndc.x);
+					minY = bx::min(minY, ndc.y);
+					maxY = bx::max(maxY, ndc.y);
+				}
+
+				if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f)
+				{
+					continue;
+				}
+			}
+
+			ClusterRange range;
+			range.x0 = uint16_t(bx::clamp(bx::floor((minX * 0.5f + 0.5f) * kClustersX), 0.0f, float(kClustersX - 1)));
+			range.x1 = uint16_t(bx::clamp(bx::floor((maxX * 0.5f + 0.5f) * kClustersX), 0.0f, float(kClustersX - 1)));
+			range.y0 = uint16_t(bx::clamp(bx::floor((minY * 0.5f + 0.5f) * kClustersY), 0.0f, float(kClustersY - 1)));
+			range.y1 = uint16_t(bx::clamp(bx::floor((maxY * 0.5f + 0.5f) * kClustersY), 0.0f, float(kClustersY - 1)));
+			range.z0 = uint16_t(getSlice(bx::max(minDepth, m_near)));
+			range.z1 = uint16_t(getSlice(bx::min(maxDepth, m_far)));
+			m_ranges.push_back(range);
+
+			// Point lights get a cone that lets everything through
+			const Vec3 color = light->getColor() * light->getIntensity();
+			const bool spot = light->getType() == LightType::Spot;
+			const float cosOuter = spot ? bx::cos(bx::toRad(light->getSpotOuterAngle())) : -2.0f;
+			const float cosInner = spot ? bx::cos(bx::toRad(light->getSpotInnerAngle())) : -1.0f;
+
+			float* texels = &m_lights[m_numVisible * kTexelsPerLight * 4];
+			texels[0] = viewPosition.x;
+			texels[1] = viewPosition.y;
+			texels[2] = viewPosition.z;
+			texels[3] = light->getRange();
+			texels[4] = color.x;
+			texels[5] = color.y;
+			texels[6] = color.z;
+			texels[7] = cosOuter;
+			texels[8] = viewDirection.x;
+			texels[9] = viewDirection.y;
+			texels[10] = viewDirection.z;
+			texels[11] = bx::max(cosInner, cosOuter + 0.001f);
+
+			m_numVisible++;
+		}
+
+		// Count lights per cluster
+		for (uint32_t& count : m_counts)
+		{
+			count = 0;
+		}
+
+		for (const ClusterRange& range : m_ranges)
+		{
+			for (uint32_t zz = range.z0; zz <= range.z1; ++zz)
+			{
+				for (uint32_t yy = range.y0; yy <= range.y1; ++yy)
+				{
+					for (uint32_t xx = range.x0; xx <= range.x1; ++xx)
+					{
+						m_counts[xx + yy * kClustersX + zz * kClustersX * kClustersY]++;
+					}
+				}
+			}
+		}
+
+		// Lists are laid out one after another, clusters past the end lose lights
+		uint32_t offset = 0;
+		m_maxPerCluster = 0;
+		for (uint32_t ii = 0; ii < kNumClusters; ++ii)
+		{
+			const uint32_t count = bx::min(m_counts[ii], kMaxIndices - offset);
+			m_grid[ii * 2 + 0] = float(offset);
+			m_grid[ii * 2 + 1] = float(count);
+			m_maxPerCluster = bx::max(m_maxPerCluster, m_counts[ii]);
+
+			offset += count;
+			m_counts[ii] = 0;
+		}
+		m_numIndices = offset;
+
+		// Fill lists, counts are reused as write cursors
+		const uint32_t numRows = (m_numIndices + kIndicesWidth - 1) / kIndicesWidth;
+		m_indices.resize(numRows * kIndicesWidth);
+
+		for (uint32_t light = 0; light < (uint32_t)m_ranges.size(); ++light)
+		{
+			const ClusterRange& range = m_ranges[light];
+			for (uint32_t zz = range.z0; zz <= range.z1; ++zz)
+			{
+				for (uint32_t yy = range.y0; yy <= range.y1; ++yy)
+				{
+					for (uint32_t xx = range.x0; xx <= range.x1; ++xx)
+					{
+						const uint32_t cluster = xx + yy * kClustersX + zz * kClustersX * kClustersY;
+						const uint32_t cursor = m_counts[cluster]++;
+						if (cursor < uint32_t(m_grid[cluster * 2 + 1]))
+						{
+							m_indices[uint32_t(m_grid[cluster * 2 + 0]) + cursor] = float(light);
+						}
+					}
+				}
+			}
+		}
+
+		// Upload
+		if (m_numVisible > 0)
+		{
+			bgfx::updateTexture2D(m_lightsTexture, 0, 0, 0, 0, uint16_t(kTexelsPerLight), uint16_t(m_numVisible),
+				bgfx::copy(m_lights.data(), m_numVisible * kTexelsPerLight * 4 * sizeof(float)));
+		}
+
+		bgfx::updateTexture2D(m_gridTexture, 0, 0, 0, 0, uint16_t(kClustersX * kClustersY), uint16_t(kClustersZ),
+			bgfx::copy(m_grid.data(), uint32_t(m_grid.size() * sizeof(float))));
+
+		if (numRows > 0)
+		{
+			bgfx::updateTexture2D(m_indicesTexture, 0, 0, 0, 0, uint16_t(kIndicesWidth), uint16_t(numRows),
+				bgfx::copy(m_indices.data(), uint32_t(m_indices.size() * sizeof(float))));
+		}
+	}
+
+	void LightClusters::bind(uint8_t _lightsStage) const
+	{
+		bgfx::setTexture(_lightsStage + 0, s_lights, m_lightsTexture);
+		bgfx::setTexture(_lightsStage + 1, s_lightGrid, m_gridTexture);
+		bgfx::setTexture(_lightsStage + 2, s_lightIndices, m_indicesTexture);
+
+		const float params[4] = { float(kClustersX), float(kClustersY), float(kClustersZ), m_depthSign };
+		bgfx::setUniform(m_clusterParamsUniform, params);
+
+		const float depth[4] = { m_sliceScale, m_sliceBias, m_near, m_far };
+		bgfx::setUniform(m_clusterDepthUniform, depth);
+	}
+
+	uint32_t LightClusters::getNumLights() const
+	{
+		return m_numLights;
+	}
+
+	uint32_t LightClusters::getNumVisible() const
+	{
+		return m_numVisible;
+	}
+
+	uint32_t LightClusters::getNumIndices() const
+	{
+		return m_numIndices;
+	}
+
+	uint32_t LightClusters::getMaxPerCluster() const
+	{
+		return m_maxPerCluster;
+	}
+
+} // namespace mge
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#pragma once
+
+#include "engine/math.h"
+
+#include <bgfx/bgfx.h>
+
+#include <stdint.h>
+#include <vector>
+
+namespace mge
+{
+	class World;
+	struct CommonResources;
+
+	/// Assigns point and spot lights to clusters, view space froxels split
+	/// exponentially in depth, so lighting a pixel only loops over the lights
+	/// of its cluster.
+	///
+	/// GPU data, read with texelFetch:
+	/// - Lights, RGBA32F, 3 texels per row: position.xyz + range, color.xyz + cos outer, direction.xyz + cos inner (view space).
+	/// - Grid, RG32F, x + y * kClustersX by z: first index, number of lights.
+	/// - Indices, R32F, kIndicesWidth wide: light rows.
+	///
+	class LightClusters
+	{
+	public:
+		static constexpr uint32_t kClustersX = 16;
+		static constexpr uint32_t kClustersY = 9;
+		static constexpr uint32_t kClustersZ = 24;
+		static constexpr uint32_t kMaxLights = 4096; // Visible lights, farther ones are dropped
+		static constexpr uint32_t kIndicesWidth = 1024;
+		static constexpr uint32_t kMaxIndices = kIndicesWidth * 256;
+
+		LightClusters();
+		~LightClusters();
+
+		/// Cull and assign the lights of a world, and upload the result.
+		///
+		/// @param[in] _world World with the lights.
+		/// @param[in] _common Camera the clusters are built for.
+		///
+		void update(const World& _world, const CommonResources& _common);
+
+		/// Bind cluster textures and uniforms for the next draw.
+		///
+		/// @param[in] _lightsStage Texture stage of the lights, grid and indices use the next two.
+		///
+		void bind(uint8_t _lightsStage) const;
+
+		uint32_t getNumLights() const; // In world
+		uint32_t getNumVisible() const; // Assigned to at least one cluster
+		uint32_t getNumIndices() const;
+		uint32_t getMaxPerCluster() const;
+
+	private:
+		struct ClusterRange
+		{
+			uint16_t x0, x1;
+			uint16_t y0, y1;
+			uint16_t z0, z1;
+		};
+
+		uint32_t getSlice(float _depth) const;
+
+		std::vector<float> m_lights;
+		std::vector<ClusterRange> m_ranges;
+		std::vector<uint32_t> m_counts;
+		std::vector<float> m_grid;
+		std::vector<float> m_indices;
+
+		float m_near;
+		float m_far;
+		float m_sliceScale;
+		float m_sliceBias;
+		float m_depthSign;
+
+		uint32_t m_numLights;
+		uint32_t m_numVisible;
+		uint32_t m_numIndices;
+		uint32_t m_maxPerCluster;
+
+		bgfx::TextureHandle m_lightsTexture;
+		bgfx::TextureHandle m_gridTexture;
+		bgfx::TextureHandle m_indicesTexture;
+		bgfx::UniformHandle s_lights;
+		bgfx::UniformHandle s_lightGrid;
+		bgfx::UniformHandle s_lightIndices;
+		bgfx::UniformHandle m_clusterParamsUniform;
+		bgfx::UniformHandle m_clusterDepthUniform;
+	};
+
+} // namespace mge
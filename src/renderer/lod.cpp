@@ -0,0 +1,42 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#include "lod.h"
+#include "common_resources.h"
+
+#include "engine/mesh.h"
+
+#include <bx/math.h>
+
+namespace mge
+{
+	uint8_t selectLod(const SubMesh& _submesh, const Aabb& _bounds, const CommonResources& _common, float _threshold)
+	{
+		const uint32_t numLods = _submesh.getNumLods();
+		if (numLods == 1 || _threshold <= 0.0f)
+		{
+			return 0;
+		}
+
+		// Errors are relative to the largest side of the mesh
+		const Vec3 extents = aabb_extents(_bounds);
+		const float size = 2.0f * bx::max(extents.x, bx::max(extents.y, extents.z));
+
+		// Nearest point of the bounding sphere, the camera can be inside it
+		const float distance = bx::max(length(aabb_center(_bounds) - _common.cameraPosition) - length(extents), 0.01f);
+		const float pixelsPerUnit = _common.proj[5] * float(_common.renderHeight) * 0.5f / distance;
+
+		for (uint32_t lod = numLods - 1; lod > 0; --lod)
+		{
+			if (_submesh.getLodError(lod) * size * pixelsPerUnit <= _threshold)
+			{
+				return uint8_t(lod);
+			}
+		}
+
+		return 0;
+	}
+
+} // namespace mge
@@ -0,0 +1,29 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#pragma once
+
+#include "engine/math.h"
+
+#include <stdint.h>
+
+namespace mge
+{
+	class SubMesh;
+	struct CommonResources;
+
+	/// Pick the coarsest level of detail of a sub mesh whose error, projected
+	/// to the screen, stays within a number of pixels.
+	///
+	/// @param[in] _submesh Sub mesh to pick a level of detail for.
+	/// @param[in] _bounds World space bounds of the parent mesh instance.
+	/// @param[in] _common Camera and screen size to project with.
+	/// @param[in] _threshold Pixels the surface may move, 0 always picks the full sub mesh.
+	///
+	/// @returns Level of detail.
+	///
+	uint8_t selectLod(const SubMesh& _submesh, const Aabb& _bounds, const CommonResources& _common, float _threshold);
+
+} // namespace mge
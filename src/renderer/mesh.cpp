@@ -4,21 +4,140 @@
  */
 
 #include "engine/mesh.h"
+#include "geometry_arena.h"
 
 namespace mge
 {
+	static Aabb computeBounds(const Vertex* _vertices, uint32_t _numVertices)
+	{
+		if (_numVertices == 0)
+		{
+			return Aabb();
+		}
+
+		Aabb bounds(_vertices[0].position, _vertices[0].position);
+		for (uint32_t ii = 0; ii < _numVertices; ++ii)
+		{
+			bounds = aabb_expand(bounds, _vertices[ii].position);
+		}
+
+		return bounds;
+	}
+
+	void SubMesh::upload()
+	{
+		GeometryArena* arena = getGeometryArena();
+		m_indexRange = arena != nullptr ? arena->allocIndices(m_indexData, m_numIndices, m_index32) : GeometryRange{ UINT16_MAX, 0, 0 };
+	}
+
+	void SubMesh::addLod(const std::vector<uint32_t>& _indices, float _error)
+	{
+		// Levels of detail use a subset of the vertices, so the index width is kept
+		if (m_index32)
+		{
+			std::shared_ptr<std::vector<uint32_t>> storage = std::make_shared<std::vector<uint32_t>>(_indices);
+			addLod(storage->data(), (uint32_t)storage->size(), _error, storage);
+		}
+		else
+		{
+			std::shared_ptr<std::vector<uint16_t>> storage = std::make_shared<std::vector<uint16_t>>(_indices.begin(), _indices.end());
+			addLod(storage->data(), (uint32_t)storage->size(), _error, storage);
+		}
+	}
+
+	void SubMesh::addLod(const void* _indices, uint32_t _numIndices, float _error, std::shared_ptr<const void> _storage)
+	{
+		Lod lod;
+		lod.storage = _storage;
+		lod.indexData = _indices;
+		lod.numIndices = _numIndices;
+		lod.error = _error;
+
+		GeometryArena* arena = getGeometryArena();
+		lod.indexRange = arena != nullptr ? arena->allocIndices(_indices, _numIndices, m_index32) : GeometryRange{ UINT16_MAX, 0, 0 };
+
+		m_lods.push_back(lod);
+	}
+
+	uint32_t SubMesh::getIndex(uint32_t _lod, uint32_t _idx) const
+	{
+		const void* data = _lod == 0 ? m_indexData : m_lods[_lod - 1].indexData;
+		return m_index32 ? ((const uint32_t*)data)[_idx] : ((const uint16_t*)data)[_idx];
+	}
+
+	uint32_t SubMesh::getNumIndices(uint32_t _lod) const
+	{
+		return _lod == 0 ? m_numIndices : m_lods[_lod - 1].numIndices;
+	}
+
 	SubMesh::SubMesh(const std::vector<uint32_t>& _indices, std::shared_ptr<Material> _material)
-		: m_indices(_indices), m_material(_material)
+		: m_storage(nullptr)
+		, m_numIndices((uint32_t)_indices.size())
+		, m_index32(false)
+		, m_material(_material)
 	{
-		m_ibh = bgfx::createIndexBuffer(
-			bgfx::makeRef(m_indices.data(), (uint32_t)(sizeof(uint32_t) * m_indices.size())),
-			BGFX_BUFFER_INDEX32
-		);
+		// Indices are relative to the base vertex of the mesh, so most fit in 16 bits
+		for (uint32_t index : _indices)
+		{
+			m_index32 |= index > UINT16_MAX;
+		}
+
+		if (m_index32)
+		{
+			m_indices32 = _indices;
+			m_indexData = m_indices32.data();
+		}
+		else
+		{
+			m_indices16.assign(_indices.begin(), _indices.end());
+			m_indexData = m_indices16.data();
+		}
+
+		upload();
+	}
+
+	SubMesh::SubMesh(const std::vector<uint16_t>& _indices, std::shared_ptr<Material> _material)
+		: m_indices16(_indices)
+		, m_storage(nullptr)
+		, m_indexData(m_indices16.data())
+		, m_numIndices((uint32_t)m_indices16.size())
+		, m_index32(false)
+		, m_material(_material)
+	{
+		upload();
+	}
+
+	SubMesh::SubMesh(const uint32_t* _indices, uint32_t _numIndices, std::shared_ptr<Material> _material, std::shared_ptr<const void> _storage)
+		: m_storage(_storage)
+		, m_indexData(_indices)
+		, m_numIndices(_numIndices)
+		, m_index32(true)
+		, m_material(_material)
+	{
+		upload();
+	}
+
+	SubMesh::SubMesh(const uint16_t* _indices, uint32_t _numIndices, std::shared_ptr<Material> _material, std::shared_ptr<const void> _storage)
+		: m_storage(_storage)
+		, m_indexData(_indices)
+		, m_numIndices(_numIndices)
+		, m_index32(false)
+		, m_material(_material)
+	{
+		upload();
 	}
 
 	SubMesh::~SubMesh()
 	{
-		bgfx::destroy(m_ibh);
+		if (GeometryArena* arena = getGeometryArena())
+		{
+			arena->freeIndices(m_indexRange);
+
+			for (const Lod& lod : m_lods)
+			{
+				arena->freeIndices(lod.indexRange);
+			}
+		}
 	}
 
 	std::shared_ptr<SubMesh> createSubMesh(const std::vector<uint32_t>& _indices, std::shared_ptr<Material> _material)
@@ -26,34 +145,97 @@ namespace mge
 		return std::make_shared<SubMesh>(_indices, _material);
 	}
 
+	std::shared_ptr<SubMesh> createSubMesh(const std::vector<uint16_t>& _indices, std::shared_ptr<Material> _material)
+	{
+		return std::make_shared<SubMesh>(_indices, _material);
+	}
+
 	void SubMesh::setMaterial(std::shared_ptr<Material> _material)
 	{
 		m_material = _material;
 	}
 
-	Mesh::Mesh(const std::vector<Vertex>& _vertices, const std::vector<std::shared_ptr<SubMesh>>& _submeshes)
-		: m_vertices(_vertices)
+	uint32_t SubMesh::getNumLods() const
+	{
+		return 1 + (uint32_t)m_lods.size();
+	}
+
+	float SubMesh::getLodError(uint32_t _lod) const
+	{
+		return _lod == 0 ? 0.0f : m_lods[_lod - 1].error;
+	}
+
+	void Mesh::upload()
+	{
+		GeometryArena* arena = getGeometryArena();
+		if (arena == nullptr)
+		{
+			m_vertexRange = { UINT16_MAX, 0, 0 };
+			return;
+		}
+
+		// Half float attributes are needed for the packed format
+		if (m_vertexFormat == VertexFormat::Packed
+			&& 0 == (bgfx::getCaps()->supported & BGFX_CAPS_VERTEX_ATTRIB_HALF))
+		{
+			m_vertexFormat = VertexFormat::Full;
+		}
+
+		if (m_vertexFormat == VertexFormat::Packed)
+		{
+			m_packedVertices.resize(m_numVertices);
+			packVertices(m_packedVertices.data(), m_vertexData, m_numVertices, m_bounds);
+
+			m_vertexRange = arena->allocVertices(m_packedVertices.data(), m_numVertices, VertexFormat::Packed);
+		}
+		else
+		{
+			m_vertexRange = arena->allocVertices(m_vertexData, m_numVertices, VertexFormat::Full);
+		}
+	}
+
+	Mesh::Mesh(const std::vector<Vertex>& _vertices, const std::vector<std::shared_ptr<SubMesh>>& _submeshes, VertexFormat::Enum _format)
+		: m_vertexFormat(_format)
+		, m_bounds(computeBounds(_vertices.data(), (uint32_t)_vertices.size()))
+		, m_vertices(_vertices)
+		, m_storage(nullptr)
+		, m_vertexData(m_vertices.data())
+		, m_numVertices((uint32_t)m_vertices.size())
 		, m_submeshes(_submeshes)
 	{
-		m_vbh = bgfx::createVertexBuffer(
-			bgfx::makeRef(m_vertices.data(), (uint32_t)(sizeof(Vertex) * m_vertices.size())),
-			Vertex::ms_layout
-		);
+		upload();
 	}
 
 	Mesh::Mesh(const std::vector<Vertex>& _vertices, const std::vector<uint32_t>& _indices)
-		: m_vertices(_vertices)
+		: m_vertexFormat(VertexFormat::Full)
+		, m_bounds(computeBounds(_vertices.data(), (uint32_t)_vertices.size()))
+		, m_vertices(_vertices)
+		, m_storage(nullptr)
+		, m_vertexData(m_vertices.data())
+		, m_numVertices((uint32_t)m_vertices.size())
 	{
-		m_vbh = bgfx::createVertexBuffer(
-			bgfx::makeRef(m_vertices.data(), (uint32_t)(sizeof(Vertex) * m_vertices.size())),
-			Vertex::ms_layout
-		);
+		upload();
 		m_submeshes.push_back(createSubMesh(_indices));
 	}
 
+	Mesh::Mesh(const Vertex* _vertices, uint32_t _numVertices, const std::vector<std::shared_ptr<SubMesh>>& _submeshes, std::shared_ptr<const void> _storage, VertexFormat::Enum _format)
+		: m_vertexFormat(_format)
+		, m_bounds(computeBounds(_vertices, _numVertices))
+		, m_storage(_storage)
+		, m_vertexData(_vertices)
+		, m_numVertices(_numVertices)
+		, m_submeshes(_submeshes)
+	{
+		// Full format is uploaded straight from the referenced vertices, no copy is made
+		upload();
+	}
+
 	Mesh::~Mesh()
 	{
-		bgfx::destroy(m_vbh);
+		if (GeometryArena* arena = getGeometryArena())
+		{
+			arena->freeVertices(m_vertexRange);
+		}
 	}
 
 	std::shared_ptr<Mesh> createMesh(const std::vector<Vertex>& _vertices, const std::vector<std::shared_ptr<SubMesh>>& _submeshes)
@@ -79,4 +261,9 @@ namespace mge
 		m_submeshes[_idx]->setMaterial(_material);
 	}
 
+	const Aabb& Mesh::getBounds() const
+	{
+		return m_bounds;
+	}
+
 } // namespace mge
\ No newline at end of file
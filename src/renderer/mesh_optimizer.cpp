@@ -0,0 +1,669 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#include "mesh_optimizer.h"
+
+#include <bx/bx.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace mge
+{
+	static constexpr uint32_t kVertexCacheSize = 16; // Conservative FIFO size, most GPUs are at least this
+
+	// FIFO cache kept as the time each vertex was last transformed
+	struct VertexCache
+	{
+		VertexCache(uint32_t _numVertices)
+			: times(_numVertices, 0)
+			, time(kVertexCacheSize + 1)
+		{
+		}
+
+		bool isCached(uint32_t _vertex) const
+		{
+			return time - times[_vertex] <= kVertexCacheSize;
+		}
+
+		// Returns true on a miss
+		bool access(uint32_t _vertex)
+		{
+			if (isCached(_vertex))
+			{
+				return false;
+			}
+
+			times[_vertex] = time++;
+			return true;
+		}
+
+		std::vector<uint32_t> times;
+		uint32_t time;
+	};
+
+	float VertexCacheStats::getAcmr() const
+	{
+		return numTriangles > 0 ? float(numMisses) / float(numTriangles) : 0.0f;
+	}
+
+	float VertexCacheStats::getAtvr() const
+	{
+		return numVertices > 0 ? float(numMisses) / float(numVertices) : 0.0f;
+	}
+
+	VertexCacheStats analyzeVertexCache(const uint32_t* _indices, uint32_t _numIndices, uint32_t _numVertices)
+	{
+		VertexCacheStats stats = {};
+		stats.numTriangles = _numIndices / 3;
+
+		VertexCache cache(_numVertices);
+		std::vector<bool> used(_numVertices, false);
+
+		for (uint32_t ii = 0; ii < stats.numTriangles * 3; ++ii)
+		{
+			const uint32_t index = _indices[ii];
+			if (!used[index])
+			{
+				used[index] = true;
+				stats.numVertices++;
+			}
+
+			stats.numMisses += cache.access(index) ? 1 : 0;
+		}
+
+		return stats;
+	}
+
+	void addVertexCacheStats(VertexCacheStats& _stats, const VertexCacheStats& _other)
+	{
+		_stats.numTriangles += _other.numTriangles;
+		_stats.numVertices += _other.numVertices;
+		_stats.numMisses += _other.numMisses;
+	}
+
+	// Tipsify, fans around vertices and picks the next one that is still in
+	// cache, preferring vertices with few triangles left.
+	static void tipsify(std::vector<uint32_t>& _triangles, const uint32_t* _indices, uint32_t _numTriangles, uint32_t _numVertices)
+	{
+		// Vertex to triangle adjacency
+		std::vector<uint32_t> offsets(_numVertices + 1, 0);
+		for (uint32_t ii = 0; ii < _numTriangles * 3; ++ii)
+		{
+			offsets[_indices[ii] + 1]++;
+		}
+
+		for (uint32_t ii = 0; ii < _numVertices; ++ii)
+		{
+			offsets[ii + 1] += offsets[ii];
+		}
+
+		std::vector<uint32_t> adjacency(_numTriangles * 3);
+		std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+		for (uint32_t ii = 0; ii < _numTriangles * 3; ++ii)
+		{
+			adjacency[fill[_indices[ii]]++] = ii / 3;
+		}
+
+		std::vector<uint32_t> live(_numVertices);
+		for (uint32_t ii = 0; ii < _numVertices; ++ii)
+		{
+			live[ii] = offsets[ii + 1] - offsets[ii];
+		}
+
+		std::vector<bool> emitted(_numTriangles, false);
+		std::vector<uint32_t> deadEnd;
+		std::vector<uint32_t> candidates;
+
+		VertexCache cache(_numVertices);
+
+		_triangles.clear();
+		_triangles.reserve(_numTriangles);
+
+		uint32_t cursor = 0;
+		int32_t fanning = _numVertices > 0 ? 0 : -1;
+
+		while (fanning >= 0)
+		{
+			candidates.clear();
+
+			for (uint32_t ii = offsets[fanning]; ii < offsets[fanning + 1]; ++ii)
+			{
+				const uint32_t triangle = adjacency[ii];
+				if (emitted[triangle])
+				{
+					continue;
+				}
+
+				for (uint32_t jj = 0; jj < 3; ++jj)
+				{
+					const uint32_t vertex = _indices[triangle * 3 + jj];
+
+					deadEnd.push_back(vertex);
+					candidates.push_back(vertex);
+					live[vertex]--;
+					cache.access(vertex);
+				}
+
+				emitted[triangle] = true;
+				_triangles.push_back(triangle);
+			}
+
+			// Candidate that stays in cache while its remaining triangles are fanned
+			int32_t next = -1;
+			int32_t bestPriority = -1;
+			for (uint32_t vertex : candidates)
+			{
+				if (live[vertex] == 0)
+				{
+					continue;
+				}
+
+				int32_t priority = 0;
+				const uint32_t age = cache.time - cache.times[vertex];
+				if (age + 2 * live[vertex] <= kVertexCacheSize)
+				{
+					priority = int32_t(age);
+				}
+
+				if (priority > bestPriority)
+				{
+					bestPriority = priority;
+					next = int32_t(vertex);
+				}
+			}
+
+			// Dead end, go back to recently used vertices before scanning for any
+			while (next < 0 && !deadEnd.empty())
+			{
+				const uint32_t vertex = deadEnd.back();
+				deadEnd.pop_back();
+
+				if (live[vertex] > 0)
+				{
+					next = int32_t(vertex);
+				}
+			}
+
+			while (next < 0 && cursor < _numVertices)
+			{
+				if (live[cursor] > 0)
+				{
+					next = int32_t(cursor);
+				}
+				cursor++;
+			}
+
+			fanning = next;
+		}
+	}
+
+	void optimizeTriangles(uint32_t* _indices, uint32_t _numIndices, const Vertex* _vertices, uint32_t _numVertices)
+	{
+		const uint32_t numTriangles = _numIndices / 3;
+		if (numTriangles < 2)
+		{
+			return;
+		}
+
+		std::vector<uint32_t> triangles;
+		tipsify(triangles, _indices, numTriangles, _numVertices);
+
+		// Clusters start where every vertex of a triangle misses the cache,
+		// so moving them around costs next to nothing
+		std::vector<uint32_t> clusters;
+		{
+			VertexCache cache(_numVertices);
+			for (uint32_t ii = 0; ii < numTriangles; ++ii)
+			{
+				const uint32_t* triangle = &_indices[triangles[ii] * 3];
+
+				uint32_t misses = 0;
+				for (uint32_t jj = 0; jj < 3; ++jj)
+				{
+					misses += cache.access(triangle[jj]) ? 1 : 0;
+				}
+
+				if (ii == 0 || misses == 3)
+				{
+					clusters.push_back(ii);
+				}
+			}
+		}
+		clusters.push_back(numTriangles);
+
+		// Clusters facing away from the mesh center are drawn first, they are
+		// the most likely to occlude the rest
+		const uint32_t numClusters = (uint32_t)clusters.size() - 1;
+
+		std::vector<Vec3> centroids(numClusters, Vec3(0.0f, 0.0f, 0.0f));
+		std::vector<Vec3> normals(numClusters, Vec3(0.0f, 0.0f, 0.0f));
+		std::vector<float> areas(numClusters, 0.0f);
+
+		Vec3 meshCentroid(0.0f, 0.0f, 0.0f);
+		float meshArea = 0.0f;
+
+		for (uint32_t cluster = 0; cluster < numClusters; ++cluster)
+		{
+			for (uint32_t ii = clusters[cluster]; ii < clusters[cluster + 1]; ++ii)
+			{
+				const uint32_t* triangle = &_indices[triangles[ii] * 3];
+
+				const Vec3& p0 = _vertices[triangle[0]].position;
+				const Vec3& p1 = _vertices[triangle[1]].position;
+				const Vec3& p2 = _vertices[triangle[2]].position;
+
+				const Vec3 normal = cross(p1 - p0, p2 - p0);
+				const float area = length(normal);
+				const Vec3 center = (p0 + p1 + p2) * (1.0f / 3.0f);
+
+				centroids[cluster] = centroids[cluster] + center * area;
+				normals[cluster] = normals[cluster] + normal;
+				areas[cluster] += area;
+			}
+
+			meshCentroid = meshCentroid + centroids[cluster];
+			meshArea += areas[cluster];
+		}
+
+		meshCentroid = meshArea > 0.0f ? meshCentroid * (1.0f / meshArea) : meshCentroid;
+
+		std::vector<float> sortKeys(numClusters, 0.0f);
+		for (uint32_t cluster = 0; cluster < numClusters; ++cluster)
+		{
+			const float normalLength = length(normals[cluster]);
+			if (areas[cluster] > 0.0f && normalLength > 0.0f)
+			{
+				const Vec3 centroid = centroids[cluster] * (1.0f / areas[cluster]);
+				sortKeys[cluster] = dot(centroid - meshCentroid, normals[cluster] * (1.0f / normalLength));
+			}
+		}
+
+		std::vector<uint32_t> order(numClusters);
+		for (uint32_t ii = 0; ii < numClusters; ++ii)
+		{
+			order[ii] = ii;
+		}
+
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t _a, uint32_t _b)
+		{
+			return sortKeys[_a] > sortKeys[_b];
+		});
+
+		std::vector<uint32_t> result;
+		result.reserve(numTriangles * 3);
+		for (uint32_t cluster : order)
+		{
+			for (uint32_t ii = clusters[cluster]; ii < clusters[cluster + 1]; ++ii)
+			{
+				const uint32_t* triangle = &_indices[triangles[ii] * 3];
+				result.insert(result.end(), triangle, triangle + 3);
+			}
+		}
+
+		bx::memCopy(_indices, result.data(), result.size() * sizeof(uint32_t));
+	}
+
+	// Symmetric 4x4 matrix, sum of squared distances to a set of planes
+	struct Quadric
+	{
+		double a00, a01, a02, a03;
+		double a11, a12, a13;
+		double a22, a23;
+		double a33;
+
+		void addPlane(double _x, double _y, double _z, double _d, double _weight)
+		{
+			a00 += _weight * _x * _x; a01 += _weight * _x * _y; a02 += _weight * _x * _z; a03 += _weight * _x * _d;
+			a11 += _weight * _y * _y; a12 += _weight * _y * _z; a13 += _weight * _y * _d;
+			a22 += _weight * _z * _z; a23 += _weight * _z * _d;
+			a33 += _weight * _d * _d;
+		}
+
+		void add(const Quadric& _other)
+		{
+			a00 += _other.a00; a01 += _other.a01; a02 += _other.a02; a03 += _other.a03;
+			a11 += _other.a11; a12 += _other.a12; a13 += _other.a13;
+			a22 += _other.a22; a23 += _other.a23;
+			a33 += _other.a33;
+		}
+
+		double evaluate(const double* _p) const
+		{
+			const double x = _p[0], y = _p[1], z = _p[2];
+			return a00 * x * x + 2.0 * a01 * x * y + 2.0 * a02 * x * z + 2.0 * a03 * x
+				+ a11 * y * y + 2.0 * a12 * y * z + 2.0 * a13 * y
+				+ a22 * z * z + 2.0 * a23 * z
+				+ a33;
+		}
+	};
+
+	struct Collapse
+	{
+		uint32_t from;
+		uint32_t to;
+		double error;
+	};
+
+	struct PositionKey
+	{
+		uint32_t bits[3];
+
+		bool operator==(const PositionKey& _other) const
+		{
+			return bits[0] == _other.bits[0] && bits[1] == _other.bits[1] && bits[2] == _other.bits[2];
+		}
+	};
+
+	struct PositionKeyHash
+	{
+		size_t operator()(const PositionKey& _key) const
+		{
+			return (size_t(_key.bits[0]) * 73856093u) ^ (size_t(_key.bits[1]) * 19349663u) ^ (size_t(_key.bits[2]) * 83492791u);
+		}
+	};
+
+	static void getNormal(double* _normal, const double* _p0, const double* _p1, const double* _p2)
+	{
+		const double e0[3] = { _p1[0] - _p0[0], _p1[1] - _p0[1], _p1[2] - _p0[2] };
+		const double e1[3] = { _p2[0] - _p0[0], _p2[1] - _p0[1], _p2[2] - _p0[2] };
+
+		_normal[0] = e0[1] * e1[2] - e0[2] * e1[1];
+		_normal[1] = e0[2] * e1[0] - e0[0] * e1[2];
+		_normal[2] = e0[0] * e1[1] - e0[1] * e1[0];
+	}
+
+	uint32_t simplifyTriangles(uint32_t* _dst, const uint32_t* _indices, uint32_t _numIndices, const Vertex* _vertices, uint32_t _numVertices, uint32_t _targetIndices, float _maxError, float& _error)
+	{
+		_error = 0.0f;
+
+		std::vector<uint32_t> indices(_indices, _indices + _numIndices / 3 * 3);
+		if (_numVertices == 0 || indices.size() <= _targetIndices)
+		{
+			bx::memCopy(_dst, indices.data(), indices.size() * sizeof(uint32_t));
+			return (uint32_t)indices.size();
+		}
+
+		// Positions are scaled to unit size, so errors do not depend on the mesh size
+		Vec3 minPos = _vertices[0].position;
+		Vec3 maxPos = _vertices[0].position;
+		for (uint32_t ii = 1; ii < _numVertices; ++ii)
+		{
+			const Vec3& pos = _vertices[ii].position;
+			minPos = Vec3(bx::min(minPos.x, pos.x), bx::min(minPos.y, pos.y), bx::min(minPos.z, pos.z));
+			maxPos = Vec3(bx::max(maxPos.x, pos.x), bx::max(maxPos.y, pos.y), bx::max(maxPos.z, pos.z));
+		}
+
+		const float extent = bx::max(maxPos.x - minPos.x, bx::max(maxPos.y - minPos.y, maxPos.z - minPos.z));
+		const double scale = extent > 0.0f ? 1.0 / double(extent) : 1.0;
+
+		std::vector<double> positions(_numVertices * 3);
+		for (uint32_t ii = 0; ii < _numVertices; ++ii)
+		{
+			positions[ii * 3 + 0] = double(_vertices[ii].position.x - minPos.x) * scale;
+			positions[ii * 3 + 1] = double(_vertices[ii].position.y - minPos.y) * scale;
+			positions[ii * 3 + 2] = double(_vertices[ii].position.z - minPos.z) * scale;
+		}
+
+		// Vertices sharing a position differ in some attribute, they form a seam
+		std::vector<uint32_t> wedge(_numVertices);
+		std::vector<uint32_t> numWedges(_numVertices, 0);
+		{
+			std::unordered_map<PositionKey, uint32_t, PositionKeyHash> lookup;
+			lookup.reserve(_numVertices);
+
+			for (uint32_t ii = 0; ii < _numVertices; ++ii)
+			{
+				PositionKey key;
+				bx::memCopy(key.bits, &_vertices[ii].position, sizeof(key.bits));
+
+				wedge[ii] = lookup.emplace(key, ii).first->second;
+				numWedges[wedge[ii]]++;
+			}
+		}
+
+		// Edges are matched by position, an edge without a twin is on a border
+		std::vector<bool> locked(_numVertices, false);
+		{
+			std::unordered_set<uint64_t> edges;
+			edges.reserve(indices.size());
+
+			for (uint32_t ii = 0; ii < indices.size(); ++ii)
+			{
+				const uint32_t a = wedge[indices[ii]];
+				const uint32_t b = wedge[indices[ii - ii % 3 + (ii + 1) % 3]];
+				edges.insert(uint64_t(a) << 32 | b);
+			}
+
+			for (uint32_t ii = 0; ii < indices.size(); ++ii)
+			{
+				const uint32_t a = wedge[indices[ii]];
+				const uint32_t b = wedge[indices[ii - ii % 3 + (ii + 1) % 3]];
+				if (edges.find(uint64_t(b) << 32 | a) == edges.end())
+				{
+					locked[a] = true;
+					locked[b] = true;
+				}
+			}
+		}
+
+		for (uint32_t ii = 0; ii < _numVertices; ++ii)
+		{
+			locked[ii] = locked[wedge[ii]] || numWedges[wedge[ii]] > 1;
+		}
+
+		// Area weighted plane quadrics, kept on the first vertex of each position
+		std::vector<Quadric> quadrics(_numVertices, Quadric());
+		for (uint32_t ii = 0; ii < indices.size(); ii += 3)
+		{
+			const double* p0 = &positions[indices[ii + 0] * 3];
+			const double* p1 = &positions[indices[ii + 1] * 3];
+			const double* p2 = &positions[indices[ii + 2] * 3];
+
+			double normal[3];
+			getNormal(normal, p0, p1, p2);
+
+			const double length = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			if (length <= 0.0)
+			{
+				continue;
+			}
+
+			normal[0] /= length;
+			normal[1] /= length;
+			normal[2] /= length;
+
+			const double distance = -(normal[0] * p0[0] + normal[1] * p0[1] + normal[2] * p0[2]);
+			const double area = length * 0.5;
+
+			for (uint32_t jj = 0; jj < 3; ++jj)
+			{
+				quadrics[wedge[indices[ii + jj]]].addPlane(normal[0], normal[1], normal[2], distance, area);
+			}
+		}
+
+		const double maxError = double(_maxError) * double(_maxError);
+		double resultError = 0.0;
+
+		std::vector<Collapse> collapses;
+		std::vector<uint32_t> remap(_numVertices);
+		std::vector<bool> touched(_numVertices);
+		std::vector<uint32_t> offsets(_numVertices + 1);
+		std::vector<uint32_t> adjacency;
+
+		while (indices.size() > _targetIndices)
+		{
+			const uint32_t numTriangles = (uint32_t)indices.size() / 3;
+
+			// Vertex to triangle adjacency
+			std::fill(offsets.begin(), offsets.end(), 0);
+			for (uint32_t index : indices)
+			{
+				offsets[index + 1]++;
+			}
+
+			for (uint32_t ii = 0; ii < _numVertices; ++ii)
+			{
+				offsets[ii + 1] += offsets[ii];
+			}
+
+			adjacency.resize(indices.size());
+			std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+			for (uint32_t ii = 0; ii < indices.size(); ++ii)
+			{
+				adjacency[fill[indices[ii]]++] = ii / 3;
+			}
+
+			// Unlocked vertices can move onto any neighbour with a single position
+			collapses.clear();
+			for (uint32_t ii = 0; ii < indices.size(); ++ii)
+			{
+				const uint32_t from = indices[ii];
+				const uint32_t to = indices[ii - ii % 3 + (ii + 1) % 3];
+
+				for (uint32_t jj = 0; jj < 2; ++jj)
+				{
+					const uint32_t a = jj == 0 ? from : to;
+					const uint32_t b = jj == 0 ? to : from;
+
+					if (a != b && !locked[a] && numWedges[wedge[b]] == 1)
+					{
+						Quadric quadric = quadrics[a];
+						quadric.add(quadrics[b]);
+
+						collapses.push_back({ a, b, quadric.evaluate(&positions[b * 3]) });
+					}
+				}
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& _a, const Collapse& _b)
+			{
+				return _a.error < _b.error;
+			});
+
+			// Each collapse removes about two triangles
+			const uint32_t maxCollapses = bx::max((numTriangles - _targetIndices / 3) / 2, 1u);
+			uint32_t numCollapses = 0;
+
+			for (uint32_t ii = 0; ii < _numVertices; ++ii)
+			{
+				remap[ii] = ii;
+				touched[ii] = false;
+			}
+
+			for (const Collapse& collapse : collapses)
+			{
+				if (numCollapses >= maxCollapses || collapse.error > maxError)
+				{
+					break;
+				}
+
+				if (touched[collapse.from] || touched[collapse.to])
+				{
+					continue;
+				}
+
+				// Reject collapses that fold a triangle over
+				const double* target = &positions[collapse.to * 3];
+
+				bool flipped = false;
+				for (uint32_t jj = offsets[collapse.from]; jj < offsets[collapse.from + 1] && !flipped; ++jj)
+				{
+					const uint32_t* triangle = &indices[adjacency[jj] * 3];
+					if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+					{
+						continue; // Removed by the collapse
+					}
+
+					const double* before[3];
+					const double* after[3];
+					for (uint32_t kk = 0; kk < 3; ++kk)
+					{
+						before[kk] = &positions[triangle[kk] * 3];
+						after[kk] = triangle[kk] == collapse.from ? target : before[kk];
+					}
+
+					double n0[3], n1[3];
+					getNormal(n0, before[0], before[1], before[2]);
+					getNormal(n1, after[0], after[1], after[2]);
+
+					flipped = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2] <= 0.0;
+				}
+
+				if (flipped)
+				{
+					continue;
+				}
+
+				// Neighbours keep their positions for the rest of the pass, so the
+				// flip test above stays valid
+				for (uint32_t jj = offsets[collapse.from]; jj < offsets[collapse.from + 1]; ++jj)
+				{
+					const uint32_t* triangle = &indices[adjacency[jj] * 3];
+					touched[triangle[0]] = true;
+					touched[triangle[1]] = true;
+					touched[triangle[2]] = true;
+				}
+
+				remap[collapse.from] = collapse.to;
+				quadrics[collapse.to].add(quadrics[collapse.from]);
+				resultError = bx::max(resultError, collapse.error);
+				numCollapses++;
+			}
+
+			if (numCollapses == 0)
+			{
+				break;
+			}
+
+			// Remove triangles that collapsed to a line
+			uint32_t numIndices = 0;
+			for (uint32_t ii = 0; ii < indices.size(); ii += 3)
+			{
+				const uint32_t a = remap[indices[ii + 0]];
+				const uint32_t b = remap[indices[ii + 1]];
+				const uint32_t c = remap[indices[ii + 2]];
+
+				if (a != b && b != c && c != a)
+				{
+					indices[numIndices++] = a;
+					indices[numIndices++] = b;
+					indices[numIndices++] = c;
+				}
+			}
+			indices.resize(numIndices);
+		}
+
+		_error = float(sqrt(resultError));
+
+		bx::memCopy(_dst, indices.data(), indices.size() * sizeof(uint32_t));
+		return (uint32_t)indices.size();
+	}
+
+	void optimizeVertexFetch(std::vector<Vertex>& _vertices, const std::vector<std::vector<uint32_t>*>& _indexLists)
+	{
+		std::vector<uint32_t> remap(_vertices.size(), UINT32_MAX);
+		std::vector<Vertex> vertices;
+		vertices.reserve(_vertices.size());
+
+		for (std::vector<uint32_t>* indices : _indexLists)
+		{
+			for (uint32_t& index : *indices)
+			{
+				if (remap[index] == UINT32_MAX)
+				{
+					remap[index] = (uint32_t)vertices.size();
+					vertices.push_back(_vertices[index]);
+				}
+
+				index = remap[index];
+			}
+		}
+
+		_vertices.swap(vertices);
+	}
+
+} // namespace mge
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#pragma once
+
+#include "engine/vertex.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace mge
+{
+	/// Post-transform vertex cache efficiency of a triangle list, simulated
+	/// with a FIFO cache.
+	///
+	struct VertexCacheStats
+	{
+		uint32_t numTriangles;
+		uint32_t numVertices; // Unique vertices referenced
+		uint32_t numMisses; // Vertices transformed
+
+		/// Average cache miss ratio, transformed vertices per triangle. 3 is
+		/// the worst case and about 0.5 is the best a regular grid can do.
+		float getAcmr() const;
+
+		/// Average transform to vertex ratio, transformed vertices per unique
+		/// vertex. 1 is optimal.
+		float getAtvr() const;
+	};
+
+	/// Simulate the vertex cache for a triangle list.
+	///
+	/// @param[in] _indices Triangle list indices.
+	/// @param[in] _numIndices Number of indices.
+	/// @param[in] _numVertices Number of vertices indices can reference.
+	///
+	/// @returns Stats, to be summed with the stats of other draws.
+	///
+	VertexCacheStats analyzeVertexCache(const uint32_t* _indices, uint32_t _numIndices, uint32_t _numVertices);
+
+	/// Add stats of another draw.
+	///
+	void addVertexCacheStats(VertexCacheStats& _stats, const VertexCacheStats& _other);
+
+	/// Reorder triangles for the post-transform vertex cache, then reorder
+	/// groups of triangles front to back as seen from outside the mesh so
+	/// early depth rejects more of the hidden ones.
+	///
+	/// @param[in,out] _indices Triangle list indices, reordered in place.
+	/// @param[in] _numIndices Number of indices.
+	/// @param[in] _vertices Vertices indices reference.
+	/// @param[in] _numVertices Number of vertices.
+	///
+	/// @remark Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex
+	/// Locality and Reduced Overdraw". Triangles are only regrouped where the
+	/// cache ordering had to restart, so overdraw sorting does not cost cache hits.
+	///
+	void optimizeTriangles(uint32_t* _indices, uint32_t _numIndices, const Vertex* _vertices, uint32_t _numVertices);
+
+	/// Simplify a triangle list by collapsing the edges that change the surface
+	/// least, measured with quadric error metrics. Vertices are not moved or
+	/// created, so the result indexes the same vertices.
+	///
+	/// @param[out] _dst Simplified indices, room for _numIndices is needed.
+	/// @param[in] _indices Triangle list indices.
+	/// @param[in] _numIndices Number of indices.
+	/// @param[in] _vertices Vertices indices reference.
+	/// @param[in] _numVertices Number of vertices.
+	/// @param[in] _targetIndices Number of indices to stop at.
+	/// @param[in] _maxError Largest error allowed, relative to the size of the vertices.
+	/// @param[out] _error Error of the result, relative to the size of the vertices.
+	///
+	/// @remark Garland and Heckbert, "Surface Simplification Using Quadric Error
+	/// Metrics". Open borders and attribute seams are kept as they are.
+	///
+	/// @returns Number of indices written.
+	///
+	uint32_t simplifyTriangles(uint32_t* _dst, const uint32_t* _indices, uint32_t _numIndices, const Vertex* _vertices, uint32_t _numVertices, uint32_t _targetIndices, float _maxError, float& _error);
+
+	/// Reorder vertices in the order the index lists first use them, so
+	/// vertex fetch reads memory linearly. Unused vertices are removed.
+	///
+	/// @param[in,out] _vertices Vertices, reordered in place.
+	/// @param[in,out] _indexLists Index lists sharing the vertices, remapped in place.
+	///
+	void optimizeVertexFetch(std::vector<Vertex>& _vertices, const std::vector<std::vector<uint32_t>*>& _indexLists);
+
+} // namespace mge
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#include "parallel_submit.h"
+
+#include "engine/settings.h"
+#include "engine/job_system.h"
+
+#include <bx/bx.h>
+
+namespace mge
+{
+	static constexpr uint32_t kMinItemsPerChunk = 32;
+
+	void parallelSubmit(uint32_t _count, const std::function<void(bgfx::Encoder*, uint32_t, uint32_t)>& _func)
+	{
+		if (_count == 0)
+		{
+			return;
+		}
+
+		// Encoder 0 belongs to the API thread, the rest can be used by any thread.
+		const uint32_t maxChunks = bgfx::getCaps()->limits.maxEncoders - 1;
+
+		if (!getSettings().renderer.parallelSubmit 
+			|| maxChunks < 2
+			|| _count < kMinItemsPerChunk * 2)
+		{
+			bgfx::Encoder* encoder = bgfx::begin();
+			_func(encoder, 0, _count);
+			bgfx::end(encoder);
+			return;
+		}
+
+		const uint32_t chunkSize = bx::max(kMinItemsPerChunk, (_count + maxChunks - 1) / maxChunks);
+
+		getJobSystem().parallelFor(_count, chunkSize, [&_func](uint32_t _begin, uint32_t _end)
+		{
+			bgfx::Encoder* encoder = bgfx::begin(true);
+			BX_ASSERT(encoder != nullptr, "Out of encoders, increase Init::Limits::maxEncoders.");
+
+			_func(encoder, _begin, _end);
+			bgfx::end(encoder);
+		});
+	}
+
+} // namespace mge
@@ -0,0 +1,29 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#pragma once
+
+#include <bgfx/bgfx.h>
+
+#include <functional>
+
+namespace mge
+{
+	/// Record draws from several worker threads.
+	///
+	/// The range is split into chunks, one bgfx encoder is used per chunk. Falls 
+	/// back to a single encoder on the calling thread if parallel submission is 
+	/// disabled or the range is small.
+	///
+	/// Chunks finish in any order. Views that depend on the order of the range
+	/// have to use `bgfx::ViewMode::DepthAscending` and submit each item with
+	/// its index as depth.
+	///
+	/// @param[in] _count Number of items to submit.
+	/// @param[in] _func Called with an encoder and an item range [begin, end).
+	///
+	void parallelSubmit(uint32_t _count, const std::function<void(bgfx::Encoder*, uint32_t, uint32_t)>& _func);
+
+} // namespace mge
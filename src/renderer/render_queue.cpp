@@ -0,0 +1,124 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#include "render_queue.h"
+
+#include <bx/bx.h>
+#include <bx/sort.h>
+
+namespace mge
+{
+	static uint16_t encodeDepth(float _depth)
+	{
+		// Bit pattern of a positive float is monotonic, keep sign, exponent and 
+		// the top 7 bits of the mantissa.
+		const float depth = _depth > 0.0f ? _depth : 0.0f;
+
+		uint32_t bits;
+		bx::memCopy(&bits, &depth, sizeof(bits));
+		return uint16_t(bits >> 16);
+	}
+
+	RenderQueue::RenderQueue()
+		: m_numItems(0)
+	{
+	}
+
+	void RenderQueue::begin()
+	{
+		m_numItems = 0;
+	}
+
+	void RenderQueue::push(uint64_t _key, uint32_t _value)
+	{
+		if (m_numItems == m_keys.size())
+		{
+			const size_t capacity = m_keys.empty() ? 256 : m_keys.size() * 2;
+			m_keys.resize(capacity);
+			m_tempKeys.resize(capacity);
+			m_values.resize(capacity);
+			m_tempValues.resize(capacity);
+		}
+
+		m_keys[m_numItems] = _key;
+		m_values[m_numItems] = _value;
+		m_numItems++;
+	}
+
+	void RenderQueue::sort()
+	{
+		if (m_numItems > 1)
+		{
+			bx::radixSort(m_keys.data(), m_tempKeys.data(), m_values.data(), m_tempValues.data(), m_numItems);
+		}
+	}
+
+	uint32_t RenderQueue::getNumItems() const
+	{
+		return m_numItems;
+	}
+
+	uint32_t RenderQueue::getValue(uint32_t _idx) const
+	{
+		return m_values[_idx];
+	}
+
+	uint16_t RenderQueue::getMaterialId(const void* _ptr)
+	{
+		return getId(m_materialIds, _ptr);
+	}
+
+	uint16_t RenderQueue::getMeshId(const void* _ptr)
+	{
+		return getId(m_meshIds, _ptr);
+	}
+
+	uint64_t RenderQueue::makeKey(bgfx::ViewId _view, uint8_t _layer, uint16_t _material, uint16_t _mesh, float _depth)
+	{
+		const uint64_t depth = encodeDepth(_depth);
+
+		uint64_t key = 0
+			| (uint64_t(_view) << 56)
+			| (uint64_t(_layer) << 48);
+
+		if (0 != (_layer & kLayerTranslucent))
+		{
+			// Back to front
+			key |= (uint64_t(UINT16_MAX - depth) << 32)
+				| (uint64_t(_material) << 16)
+				| (uint64_t(_mesh));
+		}
+		else
+		{
+			// State first, then front to back
+			key |= (uint64_t(_material) << 32)
+				| (uint64_t(_mesh) << 16)
+				| (depth);
+		}
+
+		return key;
+	}
+
+	uint16_t RenderQueue::getId(std::unordered_map<const void*, uint16_t>& _ids, const void* _ptr)
+	{
+		if (_ptr == nullptr)
+		{
+			return 0;
+		}
+
+		auto it = _ids.find(_ptr);
+		if (it != _ids.end())
+		{
+			return it->second;
+		}
+
+		// Ids wrap around after 65535 unique resources. Sorting still groups 
+		// most of them, redundant bind checks compare pointers and stay correct.
+		const uint16_t id = uint16_t(_ids.size() % UINT16_MAX) + 1;
+		_ids.emplace(_ptr, id);
+		return id;
+	}
+
+} // namespace mge
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#pragma once
+
+#include <bgfx/bgfx.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace mge
+{
+	/// Sorted list of draw items for a single view.
+	///
+	/// Opaque sort key layout:
+	/// | 63..56 view | 55..48 layer | 47..32 material | 31..16 mesh | 15..0 depth |
+	///
+	/// Translucent sort key layout (back to front):
+	/// | 63..56 view | 55..48 layer | 47..32 depth | 31..16 material | 15..0 mesh |
+	///
+	class RenderQueue
+	{
+	public:
+		static constexpr uint8_t kLayerTranslucent = 0x80;
+
+		RenderQueue();
+
+		/// Clear all items. Allocated memory is kept for the next frame.
+		///
+		void begin();
+
+		/// Add a draw item.
+		///
+		/// @param[in] _key Sort key, see `makeKey`.
+		/// @param[in] _value User value, usually an index into a list of draws.
+		///
+		void push(uint64_t _key, uint32_t _value);
+
+		/// Radix sort items by key.
+		///
+		void sort();
+
+		/// Get the number of items in the queue.
+		///
+		uint32_t getNumItems() const;
+
+		/// Get user value of item by sorted index.
+		///
+		uint32_t getValue(uint32_t _idx) const;
+
+		/// Get a small id for a resource used in the sort key. Ids are stable 
+		/// across frames.
+		///
+		/// @param[in] _ptr Resource pointer, can be null.
+		///
+		/// @returns Id, 0 for null.
+		///
+		uint16_t getMaterialId(const void* _ptr);
+		uint16_t getMeshId(const void* _ptr);
+
+		/// Build a sort key.
+		///
+		/// @param[in] _view View id.
+		/// @param[in] _layer Program or pass bucket, or'ed with `kLayerTranslucent` 
+		/// for blended draws.
+		/// @param[in] _material Material id.
+		/// @param[in] _mesh Mesh id.
+		/// @param[in] _depth Distance from camera.
+		///
+		/// @returns Sort key.
+		///
+		static uint64_t makeKey(bgfx::ViewId _view, uint8_t _layer, uint16_t _material, uint16_t _mesh, float _depth);
+
+	private:
+		static uint16_t getId(std::unordered_map<const void*, uint16_t>& _ids, const void* _ptr);
+
+		std::vector<uint64_t> m_keys;
+		std::vector<uint64_t> m_tempKeys;
+		std::vector<uint32_t> m_values;
+		std::vector<uint32_t> m_tempValues;
+		uint32_t m_numItems;
+
+		std::unordered_map<const void*, uint16_t> m_materialIds;
+		std::unordered_map<const void*, uint16_t> m_meshIds;
+	};
+
+} // namespace mge
@@ -7,6 +7,12 @@
 #include "engine/camera.h"
 #include "engine/material.h"
 #include "engine/vertex.h"
+#include "engine/world.h"
+#include "engine/mesh.h"
+#include "engine/transform.h"
+#include "engine/job_system.h"
+#include "engine/settings.h"
+#include "engine/objects/model.h"
 #include "vertexpos.h"
 #include "vertexpostex.h"
 
@@ -14,18 +20,47 @@
 
 #include "bgfx_utils.h"
 #include "common_resources.h"
+#include "frustum.h"
+#include "texture_streamer.h"
+#include "texture_residency.h"
+#include "geometry_arena.h"
 
 #include "systems/shadow_mapping.h"
 #include "systems/gbuffer.h"
+#include "systems/deferred.h"
+#include "systems/temporal_aa.h"
 #include "systems/skybox.h"
 #include "systems/tone_mapping.h"
 #include "systems/imgui.h"
 
 namespace mge
 {
+	static constexpr uint32_t kStaticFrames = 60; // Frames a model has to stay still before its shadow is cached
+	static constexpr uint32_t kResolutionFrames = 30; // Frames of GPU time averaged before the render resolution is adjusted
+	static constexpr float kResolutionStep = 0.05f; // Render scale moves in steps, each one recreates the scene targets
+	static constexpr float kResolutionTarget = 0.9f; // Share of the GPU frame budget a new scale aims for
+	static constexpr float kResolutionRaise = 0.8f; // Share of the GPU frame budget the scale is only raised below
+	static constexpr uint32_t kJitterPhases = 16; // Length of the Halton sequence temporal AA jitters through
+	static constexpr uint32_t kStatsLatency = 4; // Frames GPU stats can lag behind submission, frame latency and a query
+
+	static float halton(uint32_t _index, uint32_t _base)
+	{
+		float result = 0.0f;
+		float fraction = 1.0f;
+
+		while (_index > 0)
+		{
+			fraction /= float(_base);
+			result += fraction * float(_index % _base);
+			_index /= _base;
+		}
+
+		return result;
+	}
+
 	void Renderer::dbgTextPrintStats(const bgfx::Stats* _stats)
 	{
-		bgfx::setDebug(BGFX_DEBUG_TEXT);
+		bgfx::setDebug(BGFX_DEBUG_TEXT | BGFX_DEBUG_PROFILER); // Profiler fills in per view GPU times
 
 		const uint32_t x = _stats->textWidth - 40;
 
@@ -49,8 +84,70 @@ namespace mge
 		bgfx::dbgTextPrintf(x + 15, 4, framerate < 60 ? 0x8c : 0x8a, "%.2f fps        ", framerate);
 
 		float textures = (float)_stats->textureMemoryUsed / (1024.0f * 1024.0f);
-		bgfx::dbgTextPrintf(x, 5, textures > 1454 ? 0x8c : 0x8a, " textures:     ");
-		bgfx::dbgTextPrintf(x + 15, 5, textures > 1454 ? 0x8c : 0x8a, "%.2f / 1454 MiB ", textures);
+		float streamed = (float)getTextureResidency()->getResidentSize() / (1024.0f * 1024.0f);
+		uint32_t budget = getSettings().renderer.textureBudget;
+		bgfx::dbgTextPrintf(x, 5, streamed > budget ? 0x8c : 0x8a, " textures:     ");
+		bgfx::dbgTextPrintf(x + 15, 5, streamed > budget ? 0x8c : 0x8a, "%.2f / %u MiB (%.2f MiB total) ", streamed, budget, textures);
+
+		bgfx::dbgTextPrintf(x, 6, 0x8a, " models:       ");
+		bgfx::dbgTextPrintf(x + 15, 6, 0x8a, "%u drawn, %u culled ", m_gbuffer->m_numSubmitted, m_gbuffer->m_numCulled);
+
+		bgfx::dbgTextPrintf(x, 7, 0x8a, " draw calls:   ");
+		bgfx::dbgTextPrintf(x + 15, 7, 0x8a, "%u / %u instances ", m_gbuffer->m_numDrawCalls + m_gbuffer->m_numPrepassDrawCalls + m_shadowmapping->m_numDrawCalls, m_gbuffer->m_numInstances + m_shadowmapping->m_numInstances);
+	}
+
+	void Renderer::updateResolutionScale(const bgfx::Stats* _stats)
+	{
+		const Settings::Renderer& settings = getSettings().renderer;
+
+		if (!settings.dynamicResolution)
+		{
+			m_common->resolutionScale = 1.0f;
+			m_resolutionFrames = 0;
+			m_resolutionGpuTime = 0.0f;
+			return;
+		}
+
+		// Frames rendered at the previous scale would skew the average
+		if (m_statsStableFrames < kStatsLatency)
+		{
+			return;
+		}
+
+		m_resolutionGpuTime += float(_stats->gpuTimeEnd - _stats->gpuTimeBegin) * float(1000.0 / _stats->gpuTimerFreq);
+		if (++m_resolutionFrames < kResolutionFrames)
+		{
+			return;
+		}
+
+		const float gpuTime = m_resolutionGpuTime / float(m_resolutionFrames);
+		m_resolutionFrames = 0;
+		m_resolutionGpuTime = 0.0f;
+
+		// Dead band between lowering and raising the scale, so GPU time close to
+		// the target does not flip between two steps and recreate targets.
+		const float current = m_common->resolutionScale;
+		const bool lower = gpuTime > settings.gpuFrameBudget;
+		const bool raise = gpuTime < settings.gpuFrameBudget * kResolutionRaise;
+		if (!lower && !raise)
+		{
+			return;
+		}
+
+		// GPU time follows the pixel count, the square of the scale. Aim a little
+		// under budget to leave room for spikes.
+		const float target = settings.gpuFrameBudget * kResolutionTarget;
+		float scale = current * bx::sqrt(target / bx::max(gpuTime, 0.1f));
+
+		// Round down to a step so a raise never overshoots the target, at most
+		// two steps at a time and at least one when lowering
+		scale = bx::floor(scale / kResolutionStep + 0.001f) * kResolutionStep;
+		scale = lower
+			? bx::clamp(scale, current - kResolutionStep * 2.0f, current - kResolutionStep)
+			: bx::clamp(scale, current, current + kResolutionStep * 2.0f);
+		scale = bx::clamp(scale, settings.minResolutionScale, bx::max(settings.minResolutionScale, settings.maxResolutionScale));
+
+		m_common->resolutionScale = scale;
 	}
 
 	void Renderer::update(std::shared_ptr<World> _world, std::shared_ptr<Camera> _camera)
@@ -63,6 +160,12 @@ namespace mge
 			m_world = _world;
 		}
 
+		// Upload textures that finished decoding
+		getTextureStreamer()->update(getSettings().renderer.textureUploadBudget);
+
+		// Evict textures not in use when over budget
+		getTextureResidency()->update(uint64_t(getSettings().renderer.textureBudget) << 20);
+
 		// Update resolution upon resize
 		uint32_t w = m_window->getWidth();
 		uint32_t h = m_window->getHeight();
@@ -81,6 +184,14 @@ namespace mge
 			}
 		}
 
+		// Scene targets follow the window scaled by dynamic resolution
+		const uint16_t renderWidth = uint16_t(bx::max(float(m_common->width) * m_common->resolutionScale + 0.5f, 1.0f));
+		const uint16_t renderHeight = uint16_t(bx::max(float(m_common->height) * m_common->resolutionScale + 0.5f, 1.0f));
+
+		m_common->renderResized = m_common->renderWidth != renderWidth || m_common->renderHeight != renderHeight;
+		m_common->renderWidth = renderWidth;
+		m_common->renderHeight = renderHeight;
+
 		// Matches Autodesk Maya
 		bx::Handedness::Enum handedness = bx::Handedness::Right;
 
@@ -125,13 +236,92 @@ namespace mge
 				);
 			}
 
+			m_common->cameraPosition = _camera->getPosition();
 			m_common->cameraDirection = normalize(_camera->getTarget() - _camera->getPosition());
+			m_common->cameraNear = _camera->getNear();
+			m_common->cameraFar = _camera->getFar();
+
+			// Motion vectors compare against the previous camera, both without jitter
+			bx::memCopy(m_common->prevViewProj, m_common->viewProj, sizeof(m_common->viewProj));
+			bx::mtxMul(m_common->viewProj, m_common->view, m_common->proj);
+
+			if (m_common->firstFrame)
+			{
+				bx::memCopy(m_common->prevViewProj, m_common->viewProj, sizeof(m_common->viewProj));
+			}
+
+			// Sub-pixel jitter so temporal AA gathers a new sample each frame
+			m_common->jitter[0] = 0.0f;
+			m_common->jitter[1] = 0.0f;
+
+			if (getSettings().renderer.temporalAA)
+			{
+				const uint32_t index = (m_frameIndex % kJitterPhases) + 1;
+				m_common->jitter[0] = (halton(index, 2) - 0.5f) * 2.0f / float(m_common->renderWidth);
+				m_common->jitter[1] = (halton(index, 3) - 0.5f) * 2.0f / float(m_common->renderHeight);
+
+				// Offsets clip x and y by jitter * w, works for perspective and orthographic
+				m_common->proj[8]  += m_common->jitter[0] * m_common->proj[11];
+				m_common->proj[9]  += m_common->jitter[1] * m_common->proj[11];
+				m_common->proj[12] += m_common->jitter[0] * m_common->proj[15];
+				m_common->proj[13] += m_common->jitter[1] * m_common->proj[15];
+			}
+		}
+		else
+		{
+			// No camera update, nothing moved
+			bx::memCopy(m_common->prevViewProj, m_common->viewProj, sizeof(m_common->viewProj));
+		}
+
+		// Update world bounds of models that moved
+		const TransformStorage& transforms = getTransformStorage();
+		for (RenderProxy& proxy : _world->m_renderProxies)
+		{
+			if (proxy.mesh == nullptr)
+			{
+				continue;
+			}
+
+			const TransformHandle transform = proxy.model->getTransform();
+			const uint32_t version = transforms.getVersion(transform);
+			const float* mtx = transforms.getWorldMatrix(transform);
+			if (proxy.boundsVersion != version)
+			{
+				// New proxies have no history, they start without motion
+				const bool hasHistory = proxy.boundsVersion != UINT32_MAX;
+
+				proxy.bounds = transformAabb(proxy.mesh->getBounds(), mtx);
+				proxy.boundsVersion = version;
+				proxy.stillFrames = 0;
+
+				bx::memCopy(proxy.prevMtx, hasHistory ? proxy.mtx : mtx, sizeof(proxy.prevMtx));
+				bx::memCopy(proxy.mtx, mtx, sizeof(proxy.mtx));
+			}
+			else if (proxy.stillFrames < kStaticFrames)
+			{
+				// The first still frame has no motion left
+				if (proxy.stillFrames == 0)
+				{
+					bx::memCopy(proxy.prevMtx, proxy.mtx, sizeof(proxy.prevMtx));
+				}
+
+				proxy.stillFrames++;
+			}
+
+			// Static shadows are redrawn when a model joins or leaves them
+			const bool isStatic = proxy.stillFrames >= kStaticFrames;
+			if (proxy.isStatic != isStatic)
+			{
+				proxy.isStatic = isStatic;
+				_world->m_staticVersion++;
+			}
 		}
 	}
 
 	void Renderer::postUpdate()
 	{
 		m_common->firstFrame = false;
+		m_frameIndex++;
 	}
 
 	void Renderer::render(std::shared_ptr<World> _world, std::shared_ptr<Camera> _camera)
@@ -141,6 +331,29 @@ namespace mge
 		m_sdCpu.pushSample(float(stats->cpuTimeEnd - stats->cpuTimeBegin) * float(1000.0 / stats->cpuTimerFreq));
 		m_sdGpu.pushSample(float(stats->gpuTimeEnd - stats->gpuTimeBegin) * float(1000.0 / stats->gpuTimerFreq));
 
+		// GPU time of writing and lighting the GBuffer, kept per layout to compare them.
+		// Stats describe an earlier frame, so only sample once every frame they
+		// could come from was submitted with the same layout and render size.
+		if (stats->numViews > 0 && m_statsStableFrames >= kStatsLatency)
+		{
+			const bgfx::ViewId first = ShadowMapping::kNumViews;
+			const bgfx::ViewId last = ShadowMapping::kNumViews + GBuffer::kNumViews + Deferred::kNumViews;
+
+			float gbufferGpu = 0.0f;
+			for (uint16_t ii = 0; ii < stats->numViews; ++ii)
+			{
+				const bgfx::ViewStats& view = stats->viewStats[ii];
+				if (view.view >= first && view.view < last)
+				{
+					gbufferGpu += float(view.gpuTimeEnd - view.gpuTimeBegin) * float(1000.0 / stats->gpuTimerFreq);
+				}
+			}
+			m_gbuffer->m_sdGpu[m_statsLayout].pushSample(gbufferGpu);
+		}
+
+		// Adjust render resolution to the GPU frame time
+		updateResolutionScale(stats);
+
 		// Update common resources before rendering
 		update(_world, _camera);
 
@@ -150,29 +363,40 @@ namespace mge
 		// Render
 		m_shadowmapping->render(_world);
 		m_gbuffer->render(_world);
-		m_tonemapping->render();
+		m_deferred->render(_world);
 		m_skybox->render(_world);
+		m_temporalaa->render();
+		m_tonemapping->render();
 		m_imgui->render(shared_from_this());
 
 		// @todo Renderer
 		// Skybox (Could consider a perez sky model first, then render that to a cubemap buffer for dynamic sky, but still optional to use a custom skybox)
 		// Forward Pass (for custom shader meshes (like water, hair, particles) and for transparent meshes)
-		// Cascaded Shadows Mapping (basically lods for shadow mapping)
 		// Basic IBL (using skybox as irradiance and specular until vxgi is developed)
-		// Basic BPR (Basic brdf model in deferred combine shader)
 		// (Big task, separate branch)VGXI for irradiance and specular (still use skybox as irradiance and specular for sky visibility)
-		// Make sure all buffers are HDR (For tonemapping and bloom works correctly.)
 		// Bloom (Works well with HDR and Foliage)
 		// Tone mapping (uncharted 2 -> tweak to make look good)
 		// Screen Space Ambient Occlusion (HBAO+ or ASSAO)
 
-		// @todo Scene
-		// Automatic Instancing (Instance duplicated meshes that use same material)
-		// Automatic Polygon Reduction (Optional runtime for testing and, precompute based on scale.)
-
 		// End timer
 		m_sd.pushSample(m_sd.end());
 
+		// Remember what this frame was submitted with for its GPU stats
+		const uint32_t layout = m_gbuffer->getLayout();
+		if (layout == m_statsLayout
+			&& m_common->renderWidth == m_statsWidth
+			&& m_common->renderHeight == m_statsHeight)
+		{
+			m_statsStableFrames++;
+		}
+		else
+		{
+			m_statsLayout = layout;
+			m_statsWidth = m_common->renderWidth;
+			m_statsHeight = m_common->renderHeight;
+			m_statsStableFrames = 1;
+		}
+
 		// Update common resources after rendering
 		postUpdate();
 
@@ -186,11 +410,20 @@ namespace mge
 	Renderer::Renderer(std::shared_ptr<Window> _window, bgfx::RendererType::Enum _type)
 		: m_window(_window)
 		, m_world(nullptr)
+		, m_resolutionFrames(0)
+		, m_resolutionGpuTime(0.0f)
+		, m_frameIndex(0)
+		, m_statsLayout(0)
+		, m_statsWidth(0)
+		, m_statsHeight(0)
+		, m_statsStableFrames(0)
 	{
 		// Common 
 		m_common = std::make_unique<CommonResources>();
 		m_common->width = m_window->getWidth();
 		m_common->height = m_window->getHeight();
+		m_common->renderWidth = m_common->width;
+		m_common->renderHeight = m_common->height;
 
 		// Callback
 		m_callback = std::make_unique<BgfxCallback>();
@@ -206,27 +439,37 @@ namespace mge
 		init.resolution.width = m_common->width;
 		init.resolution.height = m_common->height;
 		init.resolution.reset = BGFX_RESET_NONE;
+		init.limits.maxEncoders = uint16_t(getJobSystem().getNumWorkers() + 2); // Workers, caller and API thread
 		bgfx::init(init);
 
 		// Techniques
-		m_shadowmapping = std::make_shared<ShadowMapping>(0, m_common);
-		m_gbuffer = std::make_shared<GBuffer>(1, m_common);
-		m_tonemapping = std::make_shared<ToneMapping>(2, m_common, m_gbuffer);
-		m_skybox = std::make_shared<Skybox>(3, m_common, m_gbuffer);
+		m_shadowmapping = std::make_shared<ShadowMapping>(0, m_common); // Two views per cascade
+		m_gbuffer = std::make_shared<GBuffer>(ShadowMapping::kNumViews, m_common);
+		m_deferred = std::make_shared<Deferred>(ShadowMapping::kNumViews + GBuffer::kNumViews, ShadowMapping::kNumViews + GBuffer::kNumViews + 1, m_common, m_gbuffer, m_shadowmapping);
+		m_skybox = std::make_shared<Skybox>(ShadowMapping::kNumViews + GBuffer::kNumViews + Deferred::kNumViews, m_common, m_gbuffer, m_deferred);
+		m_temporalaa = std::make_shared<TemporalAA>(ShadowMapping::kNumViews + GBuffer::kNumViews + Deferred::kNumViews + 1, m_common, m_gbuffer, m_deferred);
+		m_tonemapping = std::make_shared<ToneMapping>(ShadowMapping::kNumViews + GBuffer::kNumViews + Deferred::kNumViews + 2, m_common, m_gbuffer, m_deferred, m_temporalaa);
 		m_imgui = std::make_shared<Imgui>(255, m_common, m_window);
 
 		// Layouts
 		Vertex::init();
+		PackedVertex::init();
 		VertexPos::init();
 		VertexPosTex::init();
 
 		// Utils
 		bgfx::initBgfxUtils();
+		initTextureStreamer();
+		initTextureResidency();
+		initGeometryArena();
 	}
 
 	Renderer::~Renderer()
 	{
 		// Utils
+		shutdownGeometryArena();
+		shutdownTextureResidency();
+		shutdownTextureStreamer();
 		bgfx::shutdownBgfxUtils();
 
 		// Techniques
@@ -234,6 +477,8 @@ namespace mge
 		m_shadowmapping.reset();
 		m_gbuffer.reset();
 		m_tonemapping.reset();
+		m_temporalaa.reset();
+		m_deferred.reset();
 		m_skybox.reset();
 		m_imgui.reset();
 
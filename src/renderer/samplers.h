@@ -27,6 +27,11 @@ struct Samplers
         DeferredDepth = 11,
 
         SkyboxCubemap = 12,
+        DeferredShadowMap = 12, // Light passes don't use the skybox
+
+        DeferredLights = 13,
+        DeferredLightGrid = 14,
+        DeferredLightIndices = 15,
 
 	};
 };
\ No newline at end of file
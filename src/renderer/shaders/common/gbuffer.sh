@@ -0,0 +1,62 @@
+#ifndef GBUFFER_SH_HEADER_GUARD
+#define GBUFFER_SH_HEADER_GUARD
+
+#include "samplers.sh"
+#include "pbr.sh"
+#include "util.sh"
+
+// Attachments are bound by GBufferAttachment, the compact layout leaves
+// s_texF0Metallic unused and stores metallic with the normal
+SAMPLER2D(s_texDiffuseA,          SAMPLER_DEFERRED_DIFFUSE_A);
+SAMPLER2D(s_texNormal,            SAMPLER_DEFERRED_NORMAL);
+SAMPLER2D(s_texF0Metallic,        SAMPLER_DEFERRED_F0_METALLIC);
+SAMPLER2D(s_texEmissiveOcclusion, SAMPLER_DEFERRED_EMISSIVE_OCCLUSION);
+SAMPLER2D(s_texDepth,             SAMPLER_DEFERRED_DEPTH);
+
+uniform vec4 u_gbufferParams; // x = 1 for the compact layout, 0 for the full layout
+
+float readGBufferDepth(vec2 texcoord)
+{
+    return texture2D(s_texDepth, texcoord).x;
+}
+
+vec3 readGBufferNormal(vec2 texcoord)
+{
+    return unpackNormal(texture2D(s_texNormal, texcoord).xy);
+}
+
+vec4 readGBufferEmissiveOcclusion(vec2 texcoord)
+{
+    return texture2D(s_texEmissiveOcclusion, texcoord);
+}
+
+// only the parameters used by the BRDF are filled in
+PBRMaterial readGBufferMaterial(vec2 texcoord)
+{
+    vec4 diffuseA = texture2D(s_texDiffuseA, texcoord);
+
+    PBRMaterial mat;
+    mat.roughnessSquared = diffuseA.w;
+
+    if (u_gbufferParams.x > 0.0)
+    {
+        // base color is stored instead, derive the reflectances like pbrInitMaterial
+        const vec3 dielectricSpecular = vec3(0.04, 0.04, 0.04);
+
+        mat.metallic = texture2D(s_texNormal, texcoord).z;
+        mat.diffuseReflectance = diffuseA.xyz * (vec3_splat(1.0) - dielectricSpecular) * (1.0 - mat.metallic);
+        mat.fresnelReflectance = mix(dielectricSpecular, diffuseA.xyz, mat.metallic);
+    }
+    else
+    {
+        vec4 F0Metallic = texture2D(s_texF0Metallic, texcoord);
+
+        mat.diffuseReflectance = diffuseA.xyz;
+        mat.fresnelReflectance = F0Metallic.xyz;
+        mat.metallic = F0Metallic.w;
+    }
+
+    return mat;
+}
+
+#endif // GBUFFER_SH_HEADER_GUARD
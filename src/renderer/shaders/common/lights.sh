@@ -1,6 +1,8 @@
 #ifndef LIGHTS_SH_HEADER_GUARD
 #define LIGHTS_SH_HEADER_GUARD
 
+#include "samplers.sh"
+
 uniform vec4 u_ambientLightIrradiance;    // xyz = color/intensity, w = unused
 uniform vec4 u_directionalLightDirection; // xyz = direction (in view space), w = unused
 uniform vec4 u_directionalLightIntensity; // xyz = color/intensity, w = unused
@@ -31,4 +33,76 @@ DirectionalLight getDirectionalLight()
     return light;
 }
 
+// Only define this if you need the point and spot lights of clusters
+#ifdef READ_LIGHT_CLUSTERS
+
+SAMPLER2D(s_lights,       SAMPLER_DEFERRED_LIGHTS);
+SAMPLER2D(s_lightGrid,    SAMPLER_DEFERRED_LIGHT_GRID);
+SAMPLER2D(s_lightIndices, SAMPLER_DEFERRED_LIGHT_INDICES);
+
+uniform vec4 u_clusterParams; // xyz = number of clusters, w = sign of view space depth
+uniform vec4 u_clusterDepth;  // x = slice scale, y = slice bias, z = near, w = far
+
+#define LIGHT_INDICES_WIDTH 1024 // LightClusters::kIndicesWidth
+
+struct LocalLight
+{
+    vec3 position;  // View space
+    float range;
+    vec3 intensity;
+    vec3 direction; // View space
+    float cosOuter;
+    float cosInner;
+};
+
+// first index and number of lights of the cluster holding a view space position
+vec2 getLightCluster(vec3 fragPos)
+{
+    vec4 clip = mul(u_proj, vec4(fragPos, 1.0));
+    vec2 ndc = clip.xy / clip.w;
+    float depth = max(fragPos.z * u_clusterParams.w, u_clusterDepth.z);
+
+    vec3 cluster;
+    cluster.xy = clamp(floor((ndc * 0.5 + 0.5) * u_clusterParams.xy), vec2_splat(0.0), u_clusterParams.xy - 1.0);
+    cluster.z = clamp(floor(log(depth) * u_clusterDepth.x - u_clusterDepth.y), 0.0, u_clusterParams.z - 1.0);
+
+    ivec2 coord = ivec2(int(cluster.x + cluster.y * u_clusterParams.x), int(cluster.z));
+    return texelFetch(s_lightGrid, coord, 0).xy;
+}
+
+LocalLight getLocalLight(int index)
+{
+    int row = index / LIGHT_INDICES_WIDTH;
+    int light = int(texelFetch(s_lightIndices, ivec2(index - row * LIGHT_INDICES_WIDTH, row), 0).x);
+
+    vec4 positionRange = texelFetch(s_lights, ivec2(0, light), 0);
+    vec4 intensityOuter = texelFetch(s_lights, ivec2(1, light), 0);
+    vec4 directionInner = texelFetch(s_lights, ivec2(2, light), 0);
+
+    LocalLight result;
+    result.position = positionRange.xyz;
+    result.range = positionRange.w;
+    result.intensity = intensityOuter.xyz;
+    result.cosOuter = intensityOuter.w;
+    result.direction = directionInner.xyz;
+    result.cosInner = directionInner.w;
+    return result;
+}
+
+// L points from the surface to the light
+float getLocalLightAttenuation(LocalLight light, vec3 L, float distance)
+{
+    // windowed inverse square falloff, "Real Shading in Unreal Engine 4"
+    float ratio = distance / light.range;
+    float window = saturate(1.0 - ratio * ratio * ratio * ratio);
+    float falloff = window * window / (distance * distance + 1.0);
+
+    // point lights have a cone that lets everything through
+    float spot = smoothstep(light.cosOuter, light.cosInner, dot(-L, light.direction));
+
+    return falloff * spot;
+}
+
+#endif
+
 #endif // LIGHTS_SH_HEADER_GUARD
@@ -0,0 +1,20 @@
+#ifndef MOTION_SH_HEADER_GUARD
+#define MOTION_SH_HEADER_GUARD
+
+#include "bgfx_shader.sh"
+
+uniform mat4 u_unjitteredViewProj; // Current camera without temporal AA jitter
+uniform mat4 u_prevViewProj;       // Previous camera without temporal AA jitter
+uniform mat4 u_prevModel;          // Previous model transform, instanced draws use the current one
+
+// texture space motion from the previous clip position to the current one
+vec2 getVelocity(vec4 clipPos, vec4 prevClipPos)
+{
+    vec2 velocity = (clipPos.xy / clipPos.w - prevClipPos.xy / prevClipPos.w) * 0.5;
+#if !BGFX_SHADER_LANGUAGE_GLSL
+    velocity.y = -velocity.y; // y is flipped
+#endif
+    return velocity;
+}
+
+#endif // MOTION_SH_HEADER_GUARD
@@ -0,0 +1,32 @@
+#ifndef PACKING_SH_HEADER_GUARD
+#define PACKING_SH_HEADER_GUARD
+
+#include "bgfx_shader.sh"
+
+// packed vertex positions are quantized relative to the mesh bounds
+uniform vec4 u_vertexBounds[2];
+#define u_vertexBoundsCenter  (u_vertexBounds[0].xyz)
+#define u_vertexBoundsExtents (u_vertexBounds[1].xyz)
+
+vec3 unpackPosition(vec3 position)
+{
+    return u_vertexBoundsCenter + position * u_vertexBoundsExtents;
+}
+
+// octahedral encoded unit vector
+// https://knarkowicz.wordpress.com/2014/04/16/octahedron-normal-vector-encoding/
+vec3 unpackOctahedral(vec2 e)
+{
+    vec3 v = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-v.z, 0.0);
+    v.xy += mix(vec2_splat(t), vec2_splat(-t), step(vec2_splat(0.0), v.xy));
+    return normalize(v);
+}
+
+// -1 where texcoords are mirrored
+float bitangentSign(vec3 normal, vec3 tangent, vec3 bitangent)
+{
+    return step(0.0, dot(cross(normal, tangent), bitangent)) * 2.0 - 1.0;
+}
+
+#endif // PACKING_SH_HEADER_GUARD
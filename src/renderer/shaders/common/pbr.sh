@@ -96,7 +96,11 @@ vec3 pbrNormal(vec2 texcoord)
     {
         // the normal scale can cause problems and serves no real purpose
         // normal compression and BRDF calculations assume unit length
-        return normalize((texture2D(s_texNormal, texcoord).rgb * 2.0) - 1.0); // * u_normalScale;
+        // z is reconstructed, cooked normal maps are two channel BC5
+        vec3 normal;
+        normal.xy = (texture2D(s_texNormal, texcoord).xy * 2.0) - 1.0; // * u_normalScale;
+        normal.z = sqrt(saturate(1.0 - dot(normal.xy, normal.xy)));
+        return normal;
     }
     else
     {
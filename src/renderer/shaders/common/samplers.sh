@@ -19,5 +19,10 @@
 #define SAMPLER_DEFERRED_DEPTH 11
 
 #define SAMPLER_SKYBOX_CUBEMAP 12
+#define SAMPLER_DEFERRED_SHADOW_MAP 12 // Light passes don't use the skybox
+
+#define SAMPLER_DEFERRED_LIGHTS 13
+#define SAMPLER_DEFERRED_LIGHT_GRID 14
+#define SAMPLER_DEFERRED_LIGHT_INDICES 15
 
 #endif // SAMPLERS_SH_HEADER_GUARD
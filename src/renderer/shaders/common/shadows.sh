@@ -0,0 +1,58 @@
+#ifndef SHADOWS_SH_HEADER_GUARD
+#define SHADOWS_SH_HEADER_GUARD
+
+#include "bgfx_shader.sh"
+#include "samplers.sh"
+
+// Cascades are side by side in one atlas, compared against with LEQUAL
+SAMPLER2DSHADOW(s_shadowMap, SAMPLER_DEFERRED_SHADOW_MAP);
+
+uniform mat4 u_shadowMtx[4]; // View space to atlas texture space and depth, per cascade
+uniform vec4 u_shadowSplits; // View distance each cascade ends at, the last one repeats
+uniform vec4 u_shadowBias;   // Depth of one shadow map texel, per cascade
+uniform vec4 u_shadowParams; // x = number of cascades, y = atlas texel width, z = atlas texel height
+
+// 1 where the directional light reaches a view space position, 0 in shadow
+float getDirectionalShadow(vec3 viewPos, float NoL)
+{
+    float depth = abs(viewPos.z);
+
+    float cascade = 0.0;
+    cascade += step(u_shadowSplits.x, depth);
+    cascade += step(u_shadowSplits.y, depth);
+    cascade += step(u_shadowSplits.z, depth);
+    cascade += step(u_shadowSplits.w, depth);
+
+    // past the shadow distance
+    if (cascade >= u_shadowParams.x)
+    {
+        return 1.0;
+    }
+
+    int index = int(cascade);
+    vec4 coord = mul(u_shadowMtx[index], vec4(viewPos, 1.0));
+
+    // grazing surfaces need more bias to not shadow themselves
+    float bias = u_shadowBias[index] * mix(3.0, 1.0, NoL);
+    coord.z -= bias;
+
+    // keep the filter inside the cascade
+    float tileMin = cascade / u_shadowParams.x + u_shadowParams.y;
+    float tileMax = (cascade + 1.0) / u_shadowParams.x - u_shadowParams.y;
+
+    // 3x3 PCF, each tap is bilinearly compared by the sampler
+    float visibility = 0.0;
+    for (int y = -1; y <= 1; ++y)
+    {
+        for (int x = -1; x <= 1; ++x)
+        {
+            vec2 uv = coord.xy + vec2(float(x), float(y)) * u_shadowParams.yz;
+            uv.x = clamp(uv.x, tileMin, tileMax);
+            visibility += shadow2D(s_shadowMap, vec3(uv, coord.z));
+        }
+    }
+
+    return visibility / 9.0;
+}
+
+#endif // SHADOWS_SH_HEADER_GUARD
@@ -49,10 +49,20 @@ float screen2EyeDepth(float depth, float near, float far)
     return eye;
 }
 
+// transform a normal by the cofactor matrix of the model rows r0, r1 and r2,
+// same as u_normalMatrix but computed per vertex for instanced draws
+vec3 transformNormal(vec3 r0, vec3 r1, vec3 r2, vec3 normal)
+{
+    return normal.x * cross(r1, r2)
+         + normal.y * cross(r2, r0)
+         + normal.z * cross(r0, r1);
+}
+
 // convert normal from tangent space to space of normal_ref and tangent_ref
-vec3 convertTangentNormal(vec3 normal_ref, vec3 tangent_ref, vec3 normal)
+// bitangent_sign is -1 where texcoords are mirrored
+vec3 convertTangentNormal(vec3 normal_ref, vec3 tangent_ref, float bitangent_sign, vec3 normal)
 {
-    vec3 bitangent = cross(normal_ref, tangent_ref);
+    vec3 bitangent = cross(normal_ref, tangent_ref) * bitangent_sign;
     mat3 TBN = mtxFromCols(
         normalize(tangent_ref),
         normalize(bitangent),
@@ -1,7 +1,8 @@
-$input v_normal, v_tangent, v_texcoord0
+$input v_normal, v_tangent, v_texcoord0, v_clipPos, v_prevClipPos
 
 #include "common/bgfx_shader.sh"
 #include "common/util.sh"
+#include "common/motion.sh"
 
 #define READ_MATERIAL
 #include "common/pbr.sh"
@@ -11,7 +12,7 @@ void main()
     PBRMaterial mat = pbrMaterial(v_texcoord0);
 
     // Calculate normal
-    vec3 N = convertTangentNormal(v_normal, v_tangent, mat.normal);
+    vec3 N = convertTangentNormal(v_normal, v_tangent.xyz, v_tangent.w, mat.normal);
     N = mul(u_view, vec4(N, 0.0)).xyz;
    
     // Calculate roughness
@@ -22,4 +23,5 @@ void main()
     gl_FragData[1] = vec4(packNormal(N), 0.0, 0.0);
     gl_FragData[2] = vec4(mat.fresnelReflectance, mat.metallic);
     gl_FragData[3] = vec4(mat.emissive, mat.occlusion);
+    gl_FragData[4] = vec4(getVelocity(v_clipPos, v_prevClipPos), 0.0, 0.0);
 }
\ No newline at end of file
@@ -0,0 +1,26 @@
+$input v_normal, v_tangent, v_texcoord0, v_clipPos, v_prevClipPos
+
+#include "common/bgfx_shader.sh"
+#include "common/util.sh"
+#include "common/motion.sh"
+
+#define READ_MATERIAL
+#include "common/pbr.sh"
+
+void main()
+{
+    PBRMaterial mat = pbrMaterial(v_texcoord0);
+
+    // Calculate normal
+    vec3 N = convertTangentNormal(v_normal, v_tangent.xyz, v_tangent.w, mat.normal);
+    N = mul(u_view, vec4(N, 0.0)).xyz;
+   
+    // Calculate roughness
+    mat.roughnessSquared = specularAntiAliasing(N, mat.roughnessSquared);
+
+    // Pack compact G-Buffer, reflectances are derived from base color and metallic when lighting
+    gl_FragData[0] = vec4(mat.albedo.rgb, mat.roughnessSquared);
+    gl_FragData[1] = vec4(packNormal(N), mat.metallic, 0.0);
+    gl_FragData[2] = vec4(mat.emissive, mat.occlusion);
+    gl_FragData[3] = vec4(getVelocity(v_clipPos, v_prevClipPos), 0.0, 0.0);
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "common/bgfx_shader.sh"
+#include "common/samplers.sh"
+#include "common/pbr.sh"
+#define READ_LIGHT_CLUSTERS
+#include "common/lights.sh"
+#include "common/util.sh"
+#include "common/gbuffer.sh"
+
+void main()
+{
+    vec2 texcoord = gl_FragCoord.xy / u_viewRect.zw;
+    float deviceDepth = readGBufferDepth(texcoord);
+
+    // nothing was drawn here, the skybox fills it in later
+    if (deviceDepth >= 1.0)
+    {
+        discard;
+    }
+
+    vec3 N = readGBufferNormal(texcoord);
+
+    // unpack material parameters used by the PBR BRDF function
+    PBRMaterial mat = readGBufferMaterial(texcoord);
+
+    // get fragment position
+    vec4 screen = gl_FragCoord;
+    screen.z = deviceDepth;
+    vec3 fragPos = screen2Eye(screen).xyz;
+
+    // lighting, only the lights of this cluster
+    vec3 radianceOut = vec3_splat(0.0);
+
+    vec3 V = normalize(-fragPos); // view vector
+    float NoV = abs(dot(N, V)) + 1e-5;
+    vec3 msFactor = vec3_splat(1.0);
+
+    vec2 cluster = getLightCluster(fragPos);
+    int first = int(cluster.x);
+    int count = int(cluster.y);
+
+    for (int ii = 0; ii < count; ++ii)
+    {
+        LocalLight light = getLocalLight(first + ii);
+
+        vec3 toLight = light.position - fragPos;
+        float distance = length(toLight);
+        if (distance >= light.range)
+        {
+            continue;
+        }
+
+        vec3 L = toLight / distance;
+        float NoL = saturate(dot(N, L));
+        vec3 radianceIn = light.intensity * getLocalLightAttenuation(light, L, distance);
+        radianceOut += BRDF(V, L, N, NoV, NoL, mat) * msFactor * radianceIn * NoL;
+    }
+
+    gl_FragColor = vec4(radianceOut, 1.0);
+}
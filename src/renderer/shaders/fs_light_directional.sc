@@ -3,12 +3,8 @@
 #include "common/pbr.sh"
 #include "common/lights.sh"
 #include "common/util.sh"
-
-// G-Buffer
-SAMPLER2D(s_texDiffuseA,   SAMPLER_DEFERRED_DIFFUSE_A);
-SAMPLER2D(s_texNormal,     SAMPLER_DEFERRED_NORMAL);
-SAMPLER2D(s_texF0Metallic, SAMPLER_DEFERRED_F0_METALLIC);
-SAMPLER2D(s_texDepth,      SAMPLER_DEFERRED_DEPTH);
+#include "common/gbuffer.sh"
+#include "common/shadows.sh"
 
 uniform vec4 u_lightIndexVec;
 #define u_lightIndex uint(u_lightIndexVec.x)
@@ -16,21 +12,22 @@ uniform vec4 u_lightIndexVec;
 void main()
 {
     vec2 texcoord = gl_FragCoord.xy / u_viewRect.zw;
+    float deviceDepth = readGBufferDepth(texcoord);
+
+    // nothing was drawn here, the skybox fills it in later
+    if (deviceDepth >= 1.0)
+    {
+        discard;
+    }
 
-    vec4 diffuseA = texture2D(s_texDiffuseA, texcoord);
-    vec3 N = unpackNormal(texture2D(s_texNormal, texcoord).xy);
-    vec4 F0Metallic = texture2D(s_texF0Metallic, texcoord);
+    vec3 N = readGBufferNormal(texcoord);
 
     // unpack material parameters used by the PBR BRDF function
-    PBRMaterial mat;
-    mat.diffuseReflectance = diffuseA.xyz;
-    mat.roughnessSquared = diffuseA.w;
-    mat.fresnelReflectance = F0Metallic.xyz;
-    mat.metallic = F0Metallic.w;
+    PBRMaterial mat = readGBufferMaterial(texcoord);
 
     // get fragment position
     vec4 screen = gl_FragCoord;
-    screen.z = texture2D(s_texDepth, texcoord).x;
+    screen.z = deviceDepth;
     vec3 fragPos = screen2Eye(screen).xyz;
 
     // lighting
@@ -45,6 +42,7 @@ void main()
     vec3 L = -light.direction; // light coming *from* the direction
     vec3 radianceIn = light.intensity;
     float NoL = saturate(dot(N, L));
+    radianceIn *= getDirectionalShadow(fragPos, NoL);
     radianceOut += BRDF(V, L, N, NoV, NoL, mat) * msFactor * radianceIn * NoL;
 
     gl_FragColor = vec4(radianceOut, 1.0);
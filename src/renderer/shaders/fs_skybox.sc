@@ -19,7 +19,7 @@ void main()
 	float deviceDepth = texture2D(s_gbufferDepth, v_texcoord0).x;
 	float depth       = toClipSpaceDepth(deviceDepth);
 
-    if (deviceDepth < 0.9999)
+    if (deviceDepth < 1.0)
     {
         discard;
     }
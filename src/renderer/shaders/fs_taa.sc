@@ -0,0 +1,46 @@
+#include "common/bgfx_shader.sh"
+#include "common/bgfx.sh"
+
+SAMPLER2D(s_texColor, 0);
+SAMPLER2D(s_texHistory, 1);
+SAMPLER2D(s_texVelocity, 2);
+
+uniform vec4 u_taaParams; // xy = jitter in texture space, z = weight of the current frame, w = 1 when the history is valid
+uniform vec4 u_taaTexel;  // xy = size of a render resolution texel
+
+void main()
+{
+    vec2 texcoord = gl_FragCoord.xy / u_viewRect.zw;
+
+    // Undo the jitter so the current frame lines up with the history
+    vec2 uv = texcoord + u_taaParams.xy;
+    vec3 current = max(texture2D(s_texColor, uv).rgb, vec3_splat(0.0));
+
+    // Bounds of the current neighbourhood, history outside them is stale
+    vec3 minColor = current;
+    vec3 maxColor = current;
+    for (int y = -1; y <= 1; ++y)
+    {
+        for (int x = -1; x <= 1; ++x)
+        {
+            vec3 color = texture2D(s_texColor, uv + vec2(float(x), float(y)) * u_taaTexel.xy).rgb;
+            minColor = min(minColor, color);
+            maxColor = max(maxColor, color);
+        }
+    }
+
+    // Reproject, pixels that were off screen start over from the current frame
+    vec2 velocity = texture2D(s_texVelocity, uv).xy;
+    vec2 historyUv = texcoord - velocity;
+    vec3 history = clamp(texture2D(s_texHistory, historyUv).rgb, minColor, maxColor);
+
+    float inside = step(0.0, historyUv.x) * step(historyUv.x, 1.0) * step(0.0, historyUv.y) * step(historyUv.y, 1.0);
+    float blend = mix(1.0, u_taaParams.z, inside * u_taaParams.w);
+
+    // Weigh by inverse luminance so bright samples don't flicker
+    float currentWeight = blend / (1.0 + luma(current).x);
+    float historyWeight = (1.0 - blend) / (1.0 + luma(history).x);
+    vec3 result = (current * currentWeight + history * historyWeight) / max(currentWeight + historyWeight, 0.0001);
+
+    gl_FragColor = vec4(result, 1.0);
+}
@@ -3,10 +3,18 @@
 
 SAMPLER2D(s_texColor, 0);
 
+uniform vec4 u_tonemapParams; // x = exposure, y = 1 for HDR input, 0 to show a buffer as is
+
 void main()
 {
 
     vec2 texcoord = gl_FragCoord.xy / u_viewRect.zw;
     vec4 result = texture2D(s_texColor, texcoord);
-    gl_FragColor = result;
+
+    if (u_tonemapParams.y > 0.0)
+    {
+        result.rgb = toReinhard(result.rgb * u_tonemapParams.x);
+    }
+
+    gl_FragColor = vec4(result.rgb, 1.0);
 }
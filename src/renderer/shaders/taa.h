@@ -0,0 +1,11 @@
+#pragma once
+
+#include "generated/glsl/fs_taa.sc.bin.h"
+#include "generated/essl/fs_taa.sc.bin.h"
+#include "generated/spirv/fs_taa.sc.bin.h"
+#if defined(_WIN32)
+#include "generated/dx11/fs_taa.sc.bin.h"
+#endif //  defined(_WIN32)
+#if __APPLE__
+#include "generated/mtl/fs_taa.sc.bin.h"
+#endif // __APPLE__
\ No newline at end of file
@@ -1,15 +1,21 @@
-$input a_position, a_normal, a_tangent, a_texcoord0
-$output v_normal, v_tangent, v_texcoord0
+$input a_position, a_normal, a_tangent, a_bitangent, a_texcoord0
+$output v_normal, v_tangent, v_texcoord0, v_clipPos, v_prevClipPos
 
 #include "common/bgfx_shader.sh"
 #include "common/bgfx.sh"
+#include "common/packing.sh"
+#include "common/motion.sh"
 
 uniform mat3 u_normalMatrix;
 
 void main()
 {
     v_normal = mul(u_normalMatrix, a_normal);
-    v_tangent = mul(u_model[0], vec4(a_tangent, 0.0)).xyz;
+    v_tangent.xyz = mul(u_model[0], vec4(a_tangent, 0.0)).xyz;
+    v_tangent.w = bitangentSign(a_normal, a_tangent, a_bitangent);
     v_texcoord0 = a_texcoord0;
     gl_Position = mul(u_modelViewProj, vec4(a_position, 1.0));
+
+    v_clipPos = mul(u_unjitteredViewProj, mul(u_model[0], vec4(a_position, 1.0)));
+    v_prevClipPos = mul(u_prevViewProj, mul(u_prevModel, vec4(a_position, 1.0)));
 }
\ No newline at end of file
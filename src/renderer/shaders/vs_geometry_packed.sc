@@ -0,0 +1,25 @@
+$input a_position, a_normal, a_texcoord0
+$output v_normal, v_tangent, v_texcoord0, v_clipPos, v_prevClipPos
+
+#include "common/bgfx_shader.sh"
+#include "common/bgfx.sh"
+#include "common/packing.sh"
+#include "common/motion.sh"
+
+uniform mat3 u_normalMatrix;
+
+void main()
+{
+    vec3 position = unpackPosition(a_position.xyz);
+    vec3 normal = unpackOctahedral(a_normal.xy);
+    vec3 tangent = unpackOctahedral(a_normal.zw);
+
+    v_normal = mul(u_normalMatrix, normal);
+    v_tangent.xyz = mul(u_model[0], vec4(tangent, 0.0)).xyz;
+    v_tangent.w = a_position.w;
+    v_texcoord0 = a_texcoord0;
+    gl_Position = mul(u_modelViewProj, vec4(position, 1.0));
+
+    v_clipPos = mul(u_unjitteredViewProj, mul(u_model[0], vec4(position, 1.0)));
+    v_prevClipPos = mul(u_prevViewProj, mul(u_prevModel, vec4(position, 1.0)));
+}
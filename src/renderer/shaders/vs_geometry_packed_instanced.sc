@@ -0,0 +1,29 @@
+$input a_position, a_normal, a_texcoord0, i_data0, i_data1, i_data2, i_data3
+$output v_normal, v_tangent, v_texcoord0, v_clipPos, v_prevClipPos
+
+#include "common/bgfx_shader.sh"
+#include "common/bgfx.sh"
+#include "common/packing.sh"
+#include "common/motion.sh"
+#include "common/util.sh"
+
+void main()
+{
+    mat4 model = mtxFromCols(i_data0, i_data1, i_data2, i_data3);
+
+    vec3 position = unpackPosition(a_position.xyz);
+    vec3 normal = unpackOctahedral(a_normal.xy);
+    vec3 tangent = unpackOctahedral(a_normal.zw);
+
+    v_normal = transformNormal(i_data0.xyz, i_data1.xyz, i_data2.xyz, normal);
+    v_tangent.xyz = mul(model, vec4(tangent, 0.0)).xyz;
+    v_tangent.w = a_position.w;
+    v_texcoord0 = a_texcoord0;
+
+    vec4 worldPos = mul(model, vec4(position, 1.0));
+    gl_Position = mul(u_viewProj, worldPos);
+
+    // instances are only batched while they don't move
+    v_clipPos = mul(u_unjitteredViewProj, worldPos);
+    v_prevClipPos = mul(u_prevViewProj, worldPos);
+}
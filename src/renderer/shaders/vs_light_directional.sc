@@ -4,5 +4,7 @@ $input a_position
 
 void main()
 {
-    gl_Position = mul(u_modelViewProj, vec4(a_position, 1.0));
+    // Fullscreen triangle is already transformed to clip space, the view
+    // transform is only set for unprojecting GBuffer depth
+    gl_Position = vec4(a_position.xy, 1.0, 1.0);
 }
\ No newline at end of file
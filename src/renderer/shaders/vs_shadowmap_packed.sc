@@ -0,0 +1,10 @@
+$input a_position
+
+#include "common/bgfx_shader.sh"
+#include "common/bgfx.sh"
+#include "common/packing.sh"
+
+void main()
+{
+	gl_Position = mul(u_modelViewProj, vec4(unpackPosition(a_position.xyz), 1.0) );
+}
@@ -0,0 +1,13 @@
+$input a_position, i_data0, i_data1, i_data2, i_data3
+
+#include "common/bgfx_shader.sh"
+#include "common/bgfx.sh"
+#include "common/packing.sh"
+
+void main()
+{
+	mat4 model = mtxFromCols(i_data0, i_data1, i_data2, i_data3);
+
+	vec4 worldPos = mul(model, vec4(unpackPosition(a_position.xyz), 1.0) );
+	gl_Position = mul(u_viewProj, worldPos);
+}
@@ -5,15 +5,18 @@
 
 #include "deferred.h"
 #include "gbuffer.h"
+#include "shadow_mapping.h"
 
 #include "../common_resources.h"
 #include "../samplers.h"
 #include "../vertexpos.h"
 #include "../shaders/light_ambient.h"
 #include "../shaders/light_directional.h"
+#include "../shaders/light_clustered.h"
 
 #include "engine/renderer.h"
 #include "engine/settings.h"
+#include "engine/world.h"
 
 #include <bgfx/embedded_shader.h>
 #include <bx/bx.h>
@@ -26,59 +29,31 @@ namespace mge
 		BGFX_EMBEDDED_SHADER(fs_light_ambient),
 		BGFX_EMBEDDED_SHADER(vs_light_directional),
 		BGFX_EMBEDDED_SHADER(fs_light_directional),
+		BGFX_EMBEDDED_SHADER(fs_light_clustered),
 
 		BGFX_EMBEDDED_SHADER_END()
 	};
 
 	void Deferred::createFramebuffer()
-	{
-		bgfx::TextureHandle textures[2];
-		uint8_t attachments = 0;
-
-		const uint64_t samplerFlags = BGFX_SAMPLER_MIN_POINT | BGFX_SAMPLER_MAG_POINT | BGFX_SAMPLER_MIP_POINT |
-			BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP;
-
-		bgfx::TextureFormat::Enum format =
-			hdr ? bgfx::TextureFormat::RGBA16F : bgfx::TextureFormat::BGRA8; // BGRA is often faster (internal GPU format)
-		textures[attachments++] =
-			bgfx::createTexture2D(bgfx::BackbufferRatio::Equal, false, 1, format, BGFX_TEXTURE_RT | samplerFlags);
-
-		if (depth)
-		{
-			bgfx::TextureFormat::Enum depthFormat = findDepthFormat(BGFX_TEXTURE_RT_WRITE_ONLY | samplerFlags);
-			assert(depthFormat != bgfx::TextureFormat::Enum::Count);
-			textures[attachments++] = bgfx::createTexture2D(
-				bgfx::BackbufferRatio::Equal, false, 1, depthFormat, BGFX_TEXTURE_RT_WRITE_ONLY | samplerFlags);
-		}
-
-		bgfx::FrameBufferHandle fb = bgfx::createFrameBuffer(attachments, textures, true);
-	}
-
-	void Deferred::destroyFramebuffer()
-	{
-	}
-
-	void Deferred::createDepthTexture()
 	{
 		const uint64_t flags = BGFX_SAMPLER_MIN_POINT |
-			BGFX_SAMPLER_MAG_POINT |
-			BGFX_SAMPLER_MIP_POINT |
-			BGFX_SAMPLER_U_CLAMP |
-			BGFX_SAMPLER_V_CLAMP;
-
-		m_depth = bgfx::createTexture2D(
-			bgfx::BackbufferRatio::Equal, 
-			false, 
-			1,
-			bgfx::TextureFormat::D32F, 
-			flags | BGFX_TEXTURE_BLIT_DST);
+							   BGFX_SAMPLER_MAG_POINT |
+							   BGFX_SAMPLER_MIP_POINT |
+							   BGFX_SAMPLER_U_CLAMP |
+							   BGFX_SAMPLER_V_CLAMP;
+
+		// Depth is sampled from the GBuffer, lights need no depth attachment
+		bgfx::TextureHandle texture = 
+			bgfx::createTexture2D(m_common->renderWidth, m_common->renderHeight, false, 1, bgfx::TextureFormat::RGBA16F, BGFX_TEXTURE_RT | flags);
+		m_framebuffer = bgfx::createFrameBuffer(1, &texture, true);
 	}
 
-	void Deferred::destroyDepthTexture()
+	void Deferred::destroyFramebuffer()
 	{
-		if (isValid(m_depth))
+		if (isValid(m_framebuffer))
 		{
-			bgfx::destroy(m_depth);
+			// Textures are destroyed with it
+			bgfx::destroy(m_framebuffer);
 		}
 	}
 
@@ -105,14 +80,28 @@ namespace mge
 		}
 	}
 
-	Deferred::Deferred(bgfx::ViewId _view0, bgfx::ViewId _view1, std::shared_ptr<CommonResources> _common, std::shared_ptr<GBuffer> _gbuffer)
+	void Deferred::bindGBuffer()
+	{
+		// Light shaders decode either layout
+		const float params[4] = { m_gbuffer->getLayout() == GBufferLayout::Compact ? 1.0f : 0.0f, 0.0f, 0.0f, 0.0f };
+		bgfx::setUniform(u_gbufferParams, params);
+
+		bgfx::setTexture(Samplers::DeferredDiffuseA, s_texDiffuseA, m_gbuffer->getTexture(GBufferAttachment::DiffuseRoughness));
+		bgfx::setTexture(Samplers::DeferredNormal, s_texNormal, m_gbuffer->getTexture(GBufferAttachment::EncodedNormal));
+		bgfx::setTexture(Samplers::DeferredFresnelMetallic, s_texF0Metallic, m_gbuffer->getTexture(GBufferAttachment::FresnelMetallic));
+		bgfx::setTexture(Samplers::DeferredEmissiveOcclusion, s_texEmissiveOcclusion, m_gbuffer->getTexture(GBufferAttachment::EmissiveOcclusion));
+		bgfx::setTexture(Samplers::DeferredDepth, s_texDepth, m_gbuffer->getTexture(GBufferAttachment::Depth));
+	}
+
+	Deferred::Deferred(bgfx::ViewId _view0, bgfx::ViewId _view1, std::shared_ptr<CommonResources> _common, std::shared_ptr<GBuffer> _gbuffer, std::shared_ptr<ShadowMapping> _shadowmapping)
 		: m_view0(_view0)
 		, m_view1(_view1)
 		, m_common(_common)
 		, m_gbuffer(_gbuffer)
+		, m_shadowmapping(_shadowmapping)
 	{
 		bgfx::setViewName(_view0, "Deferred Shading (Ambient)");
-		bgfx::setViewName(_view1, "Deferred Shading (Directional)");
+		bgfx::setViewName(_view1, "Deferred Shading (Lights)");
 
 		const bgfx::RendererType::Enum type = bgfx::getRendererType();
 
@@ -126,62 +115,126 @@ namespace mge
 			bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_light_directional"),
 			true
 		);
+		m_programClustered = bgfx::createProgram(
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_light_directional"),
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_light_clustered"),
+			true
+		);
 
 		s_texDiffuseA           = bgfx::createUniform("s_texDiffuseA", bgfx::UniformType::Sampler);
 		s_texNormal				= bgfx::createUniform("s_texNormal", bgfx::UniformType::Sampler);
 		s_texF0Metallic			= bgfx::createUniform("s_texF0Metallic", bgfx::UniformType::Sampler);
 		s_texEmissiveOcclusion	= bgfx::createUniform("s_texEmissiveOcclusion", bgfx::UniformType::Sampler);
 		s_texDepth				= bgfx::createUniform("s_texDepth", bgfx::UniformType::Sampler);
+		u_gbufferParams			= bgfx::createUniform("u_gbufferParams", bgfx::UniformType::Vec4);
 
-		// Don't create screen vertex buffer until first render call.
+		u_ambientLightIrradiance	= bgfx::createUniform("u_ambientLightIrradiance", bgfx::UniformType::Vec4);
+		u_directionalLightDirection	= bgfx::createUniform("u_directionalLightDirection", bgfx::UniformType::Vec4);
+		u_directionalLightIntensity	= bgfx::createUniform("u_directionalLightIntensity", bgfx::UniformType::Vec4);
+
+		// Don't create framebuffer and screen vertex buffer until first render call.
+		m_framebuffer.idx = bgfx::kInvalidHandle;
 		m_vbh.idx = bgfx::kInvalidHandle;
 	}
 
 	Deferred::~Deferred()
 	{
+		destroyFramebuffer();
 		destroyScreenBuffer();
 
 		bgfx::destroy(m_programAmbient);
 		bgfx::destroy(m_programDirectional);
+		bgfx::destroy(m_programClustered);
 
 		bgfx::destroy(s_texDiffuseA);
 		bgfx::destroy(s_texNormal);
 		bgfx::destroy(s_texF0Metallic);
 		bgfx::destroy(s_texEmissiveOcclusion);
 		bgfx::destroy(s_texDepth);
+		bgfx::destroy(u_gbufferParams);
+
+		bgfx::destroy(u_ambientLightIrradiance);
+		bgfx::destroy(u_directionalLightDirection);
+		bgfx::destroy(u_directionalLightIntensity);
 	}
 
-	void Deferred::render()
+	bgfx::TextureHandle Deferred::getLightBuffer() const
+	{
+		return bgfx::getTexture(m_framebuffer);
+	}
+
+	bgfx::FrameBufferHandle Deferred::getLightFramebuffer() const
+	{
+		return m_framebuffer;
+	}
+
+	void Deferred::render(std::shared_ptr<World> _world)
 	{
 		// Begin timer
 		m_sd.begin();
 
 		if (m_common->firstFrame)
 		{
-			destroyDepthTexture();
-			createDepthTexture();
-
 			destroyScreenBuffer();
 			createScreenBuffer();
 		}
 
-		// Set view 
-		bgfx::setViewClear(m_view0, BGFX_CLEAR_COLOR);
-		bgfx::setViewRect(m_view0, 0, 0, m_common->width, m_common->height);
+		if (m_common->firstFrame || m_common->renderResized)
+		{
+			destroyFramebuffer();
+			createFramebuffer();
+		}
+
+		const Settings::Renderer& settings = getSettings().renderer;
+
+		// Set view, passes are additive so keep submission order
+		bgfx::setViewClear(m_view0, BGFX_CLEAR_COLOR, 0x000000ff);
+		bgfx::setViewMode(m_view0, bgfx::ViewMode::Sequential);
+		bgfx::setViewRect(m_view0, 0, 0, m_common->renderWidth, m_common->renderHeight);
 		bgfx::setViewFrameBuffer(m_view0, m_framebuffer);
 		bgfx::setViewTransform(m_view0, m_common->view, m_common->proj);
 
-		bgfx::blit(m_view0, m_depth, 0, 0, bgfx::getTexture(m_gbuffer->m_framebuffer, GBufferAttachment::Depth));
+		// Ambient and emissive, sky pixels are discarded and stay black
+		const float ambient[4] = { settings.ambientIntensity, settings.ambientIntensity, settings.ambientIntensity, 0.0f };
+		bgfx::setUniform(u_ambientLightIrradiance, ambient);
 
-		bgfx::setTexture(Samplers::DeferredDiffuseA, s_texDiffuseA, bgfx::getTexture(m_gbuffer->m_framebuffer, GBufferAttachment::DiffuseRoughness));
-		bgfx::setTexture(Samplers::DeferredDiffuseA, s_texNormal, bgfx::getTexture(m_gbuffer->m_framebuffer, GBufferAttachment::EncodedNormal));
-		bgfx::setTexture(Samplers::DeferredDiffuseA, s_texF0Metallic, bgfx::getTexture(m_gbuffer->m_framebuffer, GBufferAttachment::FresnelMetallic));
-		bgfx::setTexture(Samplers::DeferredDiffuseA, s_texEmissiveOcclusion, bgfx::getTexture(m_gbuffer->m_framebuffer, GBufferAttachment::EmissiveOcclusion));
-		bgfx::setTexture(Samplers::DeferredDiffuseA, s_texDepth, m_depth);
+		bindGBuffer();
 
 		bgfx::setVertexBuffer(0, m_vbh);
-		bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_DEPTH_TEST_GREATER | BGFX_STATE_CULL_CW);
-		bgfx::submit(m_view0, m_programAmbient, 0, ~BGFX_DISCARD_BINDINGS);
+		bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
+		bgfx::submit(m_view0, m_programAmbient);
+
+		// Directional light, travels opposite of the world direction which points towards the sun
+		const Vec3 sun = normalize(_world->m_directionalLight);
+		const bx::Vec3 direction = bx::mulXyz0({ -sun.x, -sun.y, -sun.z }, m_common->view);
+		const float directionalDirection[4] = { direction.x, direction.y, direction.z, 0.0f };
+		const float directionalIntensity[4] = { settings.sunIntensity, settings.sunIntensity, settings.sunIntensity, 0.0f };
+		bgfx::setUniform(u_directionalLightDirection, directionalDirection);
+		bgfx::setUniform(u_directionalLightIntensity, directionalIntensity);
+
+		bindGBuffer();
+		m_shadowmapping->bind(Samplers::DeferredShadowMap);
+
+		bgfx::setVertexBuffer(0, m_vbh);
+		bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_BLEND_ADD);
+		bgfx::submit(m_view0, m_programDirectional);
+
+		// Point and spot lights, each pixel loops over the lights of its cluster
+		m_clusters.update(*_world, *m_common);
+
+		bgfx::setViewRect(m_view1, 0, 0, m_common->renderWidth, m_common->renderHeight);
+		bgfx::setViewFrameBuffer(m_view1, m_framebuffer);
+		bgfx::setViewTransform(m_view1, m_common->view, m_common->proj);
+
+		if (m_clusters.getNumVisible() > 0)
+		{
+			bindGBuffer();
+			m_clusters.bind(Samplers::DeferredLights);
+
+			bgfx::setVertexBuffer(0, m_vbh);
+			bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_BLEND_ADD);
+			bgfx::submit(m_view1, m_programClustered);
+		}
 
 		// End timer
 		m_sd.pushSample(m_sd.end());
@@ -7,6 +7,8 @@
 
 #include "engine/sampledata.h"
 
+#include "../light_clusters.h"
+
 #include <bgfx/bgfx.h>
 
 #include <memory>
@@ -14,44 +16,70 @@
 namespace mge
 {
     class Renderer;
+    class World;
 
     struct CommonResources;
     class GBuffer;
+    class ShadowMapping;
 
+    /// Lights the GBuffer into an HDR accumulation buffer, one fullscreen
+    /// triangle per light type: ambient and emissive, the directional light,
+    /// then the clustered point and spot lights added on top.
+    ///
     class Deferred
     {
         void createFramebuffer();
         void destroyFramebuffer();
 
-        void createDepthTexture();
-        void destroyDepthTexture();
-
         void createScreenBuffer();
         void destroyScreenBuffer();
 
+        void bindGBuffer();
+
     public:
-        Deferred(bgfx::ViewId _view0, bgfx::ViewId _view1, std::shared_ptr<CommonResources> _common, std::shared_ptr<GBuffer> _gbuffer);
+        static constexpr uint32_t kNumViews = 2; // Ambient and directional, clustered lights
+
+        Deferred(bgfx::ViewId _view0, bgfx::ViewId _view1, std::shared_ptr<CommonResources> _common, std::shared_ptr<GBuffer> _gbuffer, std::shared_ptr<ShadowMapping> _shadowmapping);
         ~Deferred();
 
-        void render();
+        void render(std::shared_ptr<World> _world);
+
+        /// Get the lit HDR color, read by tone mapping.
+        ///
+        /// @returns RGBA16F texture at render resolution.
+        ///
+        bgfx::TextureHandle getLightBuffer() const;
+
+        /// Get the framebuffer of the light buffer, the skybox fills in the
+        /// pixels lights left empty.
+        ///
+        /// @returns Framebuffer without depth attachment.
+        ///
+        bgfx::FrameBufferHandle getLightFramebuffer() const;
 
     public:
         SampleData m_sd;
+        LightClusters m_clusters;
 
     private:
         bgfx::ViewId m_view0;
         bgfx::ViewId m_view1;
         std::shared_ptr<CommonResources> m_common;
         std::shared_ptr<GBuffer> m_gbuffer;
+        std::shared_ptr<ShadowMapping> m_shadowmapping;
 
         bgfx::ProgramHandle m_programAmbient;
         bgfx::ProgramHandle m_programDirectional;
+        bgfx::ProgramHandle m_programClustered;
         bgfx::UniformHandle s_texDiffuseA;
         bgfx::UniformHandle s_texNormal;
         bgfx::UniformHandle s_texF0Metallic;
         bgfx::UniformHandle s_texEmissiveOcclusion;
         bgfx::UniformHandle s_texDepth;
-        bgfx::TextureHandle m_depth;
+        bgfx::UniformHandle u_gbufferParams;
+        bgfx::UniformHandle u_ambientLightIrradiance;
+        bgfx::UniformHandle u_directionalLightDirection;
+        bgfx::UniformHandle u_directionalLightIntensity;
         bgfx::VertexBufferHandle m_vbh;
         bgfx::FrameBufferHandle m_framebuffer;
     };
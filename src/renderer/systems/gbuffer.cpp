@@ -8,12 +8,16 @@
 #include "../common_resources.h"
 #include "../samplers.h"
 #include "../bgfx_utils.h"
+#include "../frustum.h"
+#include "../parallel_submit.h"
+#include "../geometry_arena.h"
+#include "../texture_residency.h"
+#include "../lod.h"
 
 #include "../shaders/geometry.h"
+#include "../shaders/shadowmap.h"
 
 #include "engine/objects/model.h"
-#include "engine/objects/scene.h"
-#include "engine/components/mesh_component.h"
 #include "engine/world.h"
 #include "engine/mesh.h"
 #include "engine/renderer.h"
@@ -25,20 +29,31 @@
 #include <bx/bx.h>
 #include <bx/math.h>
 
+#include <atomic>
+
 namespace mge
 {
 	static const bgfx::EmbeddedShader s_embeddedShaders[] =
 	{
 		BGFX_EMBEDDED_SHADER(vs_geometry),
+		BGFX_EMBEDDED_SHADER(vs_geometry_instanced),
+		BGFX_EMBEDDED_SHADER(vs_geometry_packed),
+		BGFX_EMBEDDED_SHADER(vs_geometry_packed_instanced),
 		BGFX_EMBEDDED_SHADER(fs_geometry),
+		BGFX_EMBEDDED_SHADER(fs_geometry_compact),
+		BGFX_EMBEDDED_SHADER(vs_shadowmap),
+		BGFX_EMBEDDED_SHADER(vs_shadowmap_instanced),
+		BGFX_EMBEDDED_SHADER(vs_shadowmap_packed),
+		BGFX_EMBEDDED_SHADER(vs_shadowmap_packed_instanced),
+		BGFX_EMBEDDED_SHADER(fs_shadowmap),
 
 		BGFX_EMBEDDED_SHADER_END()
 	};
 
 	void GBuffer::createFramebuffer()
 	{
-		const uint32_t width = m_common->width;
-		const uint32_t height = m_common->height;
+		const uint32_t width = m_common->renderWidth;
+		const uint32_t height = m_common->renderHeight;
 
 		const uint64_t flags = BGFX_SAMPLER_MIN_POINT |
 							   BGFX_SAMPLER_MAG_POINT |
@@ -46,6 +61,20 @@ namespace mge
 							   BGFX_SAMPLER_U_CLAMP |
 							   BGFX_SAMPLER_V_CLAMP;
 
+		if (m_layout == GBufferLayout::Compact)
+		{
+			bgfx::TextureHandle textures[] =
+			{
+				bgfx::createTexture2D(width, height, false, 1, bgfx::TextureFormat::BGRA8,   BGFX_TEXTURE_RT | flags),
+				bgfx::createTexture2D(width, height, false, 1, bgfx::TextureFormat::RGB10A2, BGFX_TEXTURE_RT | flags),
+				bgfx::createTexture2D(width, height, false, 1, bgfx::TextureFormat::BGRA8,   BGFX_TEXTURE_RT | flags),
+				bgfx::createTexture2D(width, height, false, 1, bgfx::TextureFormat::RG16F,   BGFX_TEXTURE_RT | flags),
+				bgfx::createTexture2D(width, height, false, 1, m_compactDepthFormat,         BGFX_TEXTURE_RT | flags)
+			};
+			m_framebuffer = bgfx::createFrameBuffer(BX_COUNTOF(textures), textures, true);
+			return;
+		}
+
 		// @todo D32F format might not be available at all platforms. 
 		// Consider a func for 'getAvailableDepthFormat'
 		bgfx::TextureHandle textures[GBufferAttachment::Count] =
@@ -54,6 +83,7 @@ namespace mge
 			bgfx::createTexture2D(width, height, false, 1, bgfx::TextureFormat::RG16F, BGFX_TEXTURE_RT | flags),
 			bgfx::createTexture2D(width, height, false, 1, bgfx::TextureFormat::BGRA8, BGFX_TEXTURE_RT | flags),
 			bgfx::createTexture2D(width, height, false, 1, bgfx::TextureFormat::BGRA8, BGFX_TEXTURE_RT | flags),
+			bgfx::createTexture2D(width, height, false, 1, bgfx::TextureFormat::RG16F, BGFX_TEXTURE_RT | flags),
 			bgfx::createTexture2D(width, height, false, 1, bgfx::TextureFormat::D32F,  BGFX_TEXTURE_RT | flags)
 		};
 		m_framebuffer = bgfx::createFrameBuffer(GBufferAttachment::Count, textures, true);
@@ -68,15 +98,16 @@ namespace mge
 		}
 	}
 
-	void GBuffer::setUniforms()
+	void GBuffer::setUniforms(bgfx::Encoder* _encoder, const float* _model)
 	{
-		// Normal matrix
+		// Normal matrix, the cofactor matrix of the model. Row vectors are
+		// multiplied from the left, so it is the transposed adjugate.
 		// https://github.com/graphitemaster/normals_revisited#the-details-of-transforming-normals
-		float identity[16];
-		bx::mtxIdentity(identity);
+		float adjugate[16];
+		bx::mtxAdjugate(adjugate, _model);
 
 		float normalMat[16];
-		bx::mtxAdjugate(normalMat, identity);
+		bx::mtxTranspose(normalMat, adjugate);
 
 		float normalMat3[9];
 		for (int i = 0; i < 3; ++i)
@@ -86,12 +117,24 @@ namespace mge
 				normalMat3[i * 3 + j] = normalMat[i * 4 + j];
 			}
 		}
-		bgfx::setUniform(m_normalMatrixUniform, normalMat3);
+		_encoder->setUniform(m_normalMatrixUniform, normalMat3);
+	}
+
+	void GBuffer::setMotionUniforms(bgfx::Encoder* _encoder, const float* _prevModel)
+	{
+		// Velocity is measured without jitter so it only holds motion
+		_encoder->setUniform(m_viewProjUniform, m_common->viewProj);
+		_encoder->setUniform(m_prevViewProjUniform, m_common->prevViewProj);
+
+		if (_prevModel != nullptr)
+		{
+			_encoder->setUniform(m_prevModelUniform, _prevModel);
+		}
 	}
 
-	void GBuffer::setMaterial(std::shared_ptr<Material> _material)
+	void GBuffer::setMaterial(bgfx::Encoder* _encoder, std::shared_ptr<Material> _material)
 	{
-		bgfx::setUniform(m_baseColorFactorUniform, &_material->baseColorFactor);
+		_encoder->setUniform(m_baseColorFactorUniform, &_material->baseColorFactor);
 
 		float factorValues[4] = {
 			_material->metallicFactor, 
@@ -99,7 +142,7 @@ namespace mge
 			_material->normalScale, 
 			_material->occlusionStrength
 		};
-		bgfx::setUniform(m_metRoughNorOccFactorUniform, factorValues);
+		_encoder->setUniform(m_metRoughNorOccFactorUniform, factorValues);
 
 		float emissiveFactor[4] = {
 			_material->emissiveFactor.x,
@@ -107,7 +150,7 @@ namespace mge
 			_material->emissiveFactor.z,
 			0.0f
 		};
-		bgfx::setUniform(m_emissiveFactorUniform, &_material->emissiveFactor);
+		_encoder->setUniform(m_emissiveFactorUniform, &_material->emissiveFactor);
 
 		float hasTexturesValues[4] = { 
 			0.0f, 
@@ -117,92 +160,287 @@ namespace mge
 		};
 
 		const uint32_t hasTexturesMask = 0
-			| ((setTextureOrDefault(Samplers::BaseColor, m_baseColorSampler, _material->baseColorTexture) ? 1 : 0) << 0)
-			| ((setTextureOrDefault(Samplers::Metal, m_metallicSampler, _material->metallicTexture) ? 1 : 0) << 1)
-			| ((setTextureOrDefault(Samplers::Roughness, m_roughnessSampler, _material->roughnessTexture) ? 1 : 0) << 2)
-			| ((setTextureOrDefault(Samplers::Normal, m_normalSampler, _material->normalTexture) ? 1 : 0) << 3)
-			| ((setTextureOrDefault(Samplers::Occlusion, m_occlusionSampler, _material->occlusionTexture) ? 1 : 0) << 4)
-			| ((setTextureOrDefault(Samplers::Emissive, m_emissiveSampler, _material->emissiveTexture) ? 1 : 0) << 5);
+			| ((setTextureOrDefault(_encoder, Samplers::BaseColor, m_baseColorSampler, _material->baseColorTexture) ? 1 : 0) << 0)
+			| ((setTextureOrDefault(_encoder, Samplers::Metal, m_metallicSampler, _material->metallicTexture) ? 1 : 0) << 1)
+			| ((setTextureOrDefault(_encoder, Samplers::Roughness, m_roughnessSampler, _material->roughnessTexture) ? 1 : 0) << 2)
+			| ((setTextureOrDefault(_encoder, Samplers::Normal, m_normalSampler, _material->normalTexture) ? 1 : 0) << 3)
+			| ((setTextureOrDefault(_encoder, Samplers::Occlusion, m_occlusionSampler, _material->occlusionTexture) ? 1 : 0) << 4)
+			| ((setTextureOrDefault(_encoder, Samplers::Emissive, m_emissiveSampler, _material->emissiveTexture) ? 1 : 0) << 5);
 		hasTexturesValues[0] = (float)hasTexturesMask;
 
-		bgfx::setUniform(m_hasTexturesUniform, hasTexturesValues);
+		_encoder->setUniform(m_hasTexturesUniform, hasTexturesValues);
+	}
+
+	void GBuffer::bindMaterial(SubmitState& _state, const std::shared_ptr<Material>& _material)
+	{
+		// Textures and uniforms are kept between draws, see submit flags.
+		if (_material == nullptr || _material.get() == _state.boundMaterial)
+		{
+			return;
+		}
+
+		setMaterial(_state.encoder, _material);
+		_state.boundMaterial = _material.get();
 	}
 
-	bool GBuffer::setTextureOrDefault(uint8_t stage, bgfx::UniformHandle uniform, std::shared_ptr<Texture> texture)
+	bool GBuffer::setTextureOrDefault(bgfx::Encoder* _encoder, uint8_t stage, bgfx::UniformHandle uniform, std::shared_ptr<Texture> texture)
 	{
+		if (texture != nullptr)
+		{
+			getTextureResidency()->touch(texture.get());
+		}
+
 		bool valid = texture != nullptr && bgfx::isValid(texture->m_th);
 		if (valid)
 		{
-			bgfx::setTexture(stage, uniform, texture->m_th);
+			_encoder->setTexture(stage, uniform, texture->m_th);
 		}
 		else
 		{
-			bgfx::setTexture(stage, uniform, m_defaultTexture);
+			_encoder->setTexture(stage, uniform, m_defaultTexture);
 		}
 
 		return valid;
 	}
 
-	void GBuffer::submit(std::shared_ptr<Model> _model)
+	void GBuffer::submit(const RenderProxy& _proxy, const Frustum& _frustum)
 	{
-		float mtx[16];
-		bx::mtxSRT(mtx, _model->getPosition(), _model->getRotation(), _model->getScale());
-
-		if (std::shared_ptr<MeshComponent> meshComp = _model->getComponent<MeshComponent>())
+		if (const std::shared_ptr<Mesh>& mesh = _proxy.mesh)
 		{
-			std::shared_ptr<Mesh> mesh = meshComp->m_mesh;
+			const float* mtx = _proxy.model->getWorldMatrix();
+
+			// Cull
+			if (!_frustum.intersects(_proxy.bounds))
+			{
+				m_numCulled++;
+				return;
+			}
+			m_numSubmitted++;
+
+			const float depth = length(Vec3(mtx[12], mtx[13], mtx[14]) - m_common->cameraPosition);
+			const float lodThreshold = getSettings().renderer.lodThreshold;
 
 			for (auto& submesh : mesh->m_submeshes)
 			{
-				// State
-				uint64_t state = 0
-					| BGFX_STATE_WRITE_RGB
-					| BGFX_STATE_WRITE_A
-					| BGFX_STATE_WRITE_Z
-					| BGFX_STATE_DEPTH_TEST_LESS;
-
-				// Material
-				if (submesh->m_material)
+				const uint8_t lod = selectLod(*submesh, _proxy.bounds, *m_common, lodThreshold);
+				m_batcher.add(mesh, submesh, submesh->m_material, lod, mtx, depth, _proxy.stillFrames == 0 ? _proxy.prevMtx : nullptr);
+			}
+		}
+	}
+
+	void GBuffer::submit(SubmitState& _state, const InstanceBatch& _batch, uint32_t _order, bool _prepass, uint32_t _prepassInstanced)
+	{
+		bgfx::Encoder* encoder = _state.encoder;
+		const GeometryArena* geometry = getGeometryArena();
+		const VertexFormat::Enum format = _batch.mesh->m_vertexFormat;
+
+		// State
+		uint64_t state = 0
+			| BGFX_STATE_WRITE_RGB
+			| BGFX_STATE_WRITE_A;
+
+		// Opaque depth is already written by the prepass, only the visible fragment is shaded
+		const bool blend = _batch.material && _batch.material->blend;
+		if (_prepass && !blend)
+		{
+			state |= BGFX_STATE_DEPTH_TEST_EQUAL;
+		}
+		else
+		{
+			state |= BGFX_STATE_WRITE_Z | BGFX_STATE_DEPTH_TEST_LESS;
+		}
+
+		if (_batch.material)
+		{
+			if (blend)
+			{
+				state |= BGFX_STATE_BLEND_ALPHA;
+			}
+			if (!_batch.material->doubleSided)
+			{
+				state |= BGFX_STATE_CULL_CW;
+			}
+		}
+
+		_state.numInstances += _batch.numInstances;
+
+		// Instanced
+		uint32_t first = 0;
+		if (InstanceBatcher::isInstanced(_batch))
+		{
+			while (first < _batch.numInstances)
+			{
+				bgfx::InstanceDataBuffer idb;
+				const uint32_t num = InstanceBatcher::allocInstanceData(&idb, _batch, first);
+				if (num == 0)
+				{
+					// Out of instance data memory, draw the rest one by one.
+					break;
+				}
+
+				bindMaterial(_state, _batch.material);
+				setMotionUniforms(encoder, nullptr);
+
+				encoder->setState(state);
+				geometry->setVertexBuffer(encoder, *_batch.mesh);
+				geometry->setIndexBuffer(encoder, *_batch.submesh, _batch.lod);
+				encoder->setInstanceDataBuffer(&idb);
+				encoder->submit(m_view, m_programInstanced[m_layout][format], _order, BGFX_DISCARD_ALL & ~BGFX_DISCARD_BINDINGS);
+
+				_state.numDrawCalls++;
+				first += num;
+			}
+		}
+
+		// Instanced and non-instanced shaders transform differently, depth has to come from the same path
+		BX_ASSERT(_prepassInstanced == UINT32_MAX || _prepassInstanced == first, 
+			"GBuffer drew %u instances instanced but the prepass drew %u.", first, _prepassInstanced);
+
+		// Non-instanced
+		for (uint32_t ii = first; ii < _batch.numInstances; ++ii)
+		{
+			bindMaterial(_state, _batch.material);
+			setUniforms(encoder, &_batch.transforms[ii * 16]);
+
+			// Moving instances keep their previous transform, the rest haven't moved
+			const std::vector<float>& prevTransforms = _batch.moving ? _batch.prevTransforms : _batch.transforms;
+			setMotionUniforms(encoder, &prevTransforms[ii * 16]);
+
+			encoder->setState(state);
+			encoder->setTransform(&_batch.transforms[ii * 16]);
+			geometry->setVertexBuffer(encoder, *_batch.mesh);
+			geometry->setIndexBuffer(encoder, *_batch.submesh, _batch.lod);
+			encoder->submit(m_view, m_program[m_layout][format], _order, BGFX_DISCARD_ALL & ~BGFX_DISCARD_BINDINGS);
+
+			_state.numDrawCalls++;
+		}
+	}
+
+	uint32_t GBuffer::submitDepth(bgfx::Encoder* _encoder, const InstanceBatch& _batch, uint32_t _order, uint32_t& _numInstanced)
+	{
+		uint32_t numDrawCalls = 0;
+		const GeometryArena* geometry = getGeometryArena();
+		const VertexFormat::Enum format = _batch.mesh->m_vertexFormat;
+
+		// Culling has to match the GBuffer pass for depth to be equal
+		uint64_t state = 0
+			| BGFX_STATE_WRITE_Z
+			| BGFX_STATE_DEPTH_TEST_LESS;
+
+		if (_batch.material && !_batch.material->doubleSided)
+		{
+			state |= BGFX_STATE_CULL_CW;
+		}
+
+		// Instanced
+		uint32_t first = 0;
+		if (InstanceBatcher::isInstanced(_batch))
+		{
+			while (first < _batch.numInstances)
+			{
+				bgfx::InstanceDataBuffer idb;
+				const uint32_t num = InstanceBatcher::allocInstanceData(&idb, _batch, first);
+				if (num == 0)
 				{
-					setMaterial(submesh->m_material);
-					if (submesh->m_material != nullptr)
-					{
-						if (submesh->m_material->blend)
-						{
-							state |= BGFX_STATE_BLEND_ALPHA;
-						}
-						if (!submesh->m_material->doubleSided)
-						{
-							state |= BGFX_STATE_CULL_CW;
-						}
-					}
+					// Out of instance data memory, draw the rest one by one.
+					break;
 				}
 
-				// Uniforms
-				setUniforms();
+				_encoder->setState(state);
+				geometry->setVertexBuffer(_encoder, *_batch.mesh);
+				geometry->setIndexBuffer(_encoder, *_batch.submesh, _batch.lod);
+				_encoder->setInstanceDataBuffer(&idb);
+				_encoder->submit(m_prepassView, m_depthProgramInstanced[format], _order);
 
-				// Submit
-				bgfx::setState(state);
-				bgfx::setTransform(mtx);
-				bgfx::setVertexBuffer(0, mesh->m_vbh);
-				bgfx::setIndexBuffer(submesh->m_ibh);
-				bgfx::submit(m_view, m_program);
+				numDrawCalls++;
+				first += num;
 			}
 		}
+
+		_numInstanced = first;
+
+		// Non-instanced
+		for (uint32_t ii = first; ii < _batch.numInstances; ++ii)
+		{
+			_encoder->setState(state);
+			_encoder->setTransform(&_batch.transforms[ii * 16]);
+			geometry->setVertexBuffer(_encoder, *_batch.mesh);
+			geometry->setIndexBuffer(_encoder, *_batch.submesh, _batch.lod);
+			_encoder->submit(m_prepassView, m_depthProgram[format], _order);
+
+			numDrawCalls++;
+		}
+
+		return numDrawCalls;
 	}
 
 	GBuffer::GBuffer(bgfx::ViewId _view, std::shared_ptr<CommonResources> _common)
-		: m_view(_view)
+		: m_numSubmitted(0)
+		, m_numCulled(0)
+		, m_numDrawCalls(0)
+		, m_numInstances(0)
+		, m_numPrepassDrawCalls(0)
+		, m_prepassView(_view)
+		, m_view(bgfx::ViewId(_view + 1))
 		, m_common(_common)
+		, m_layout(GBufferLayout::Full)
 	{
-		bgfx::setViewName(_view, "GBuffer Generation");
+		bgfx::setViewName(m_prepassView, "Depth Prepass");
+		bgfx::setViewName(m_view, "GBuffer Generation");
 
 		const bgfx::RendererType::Enum type = bgfx::getRendererType();
 
-		// Programs
-		m_program = bgfx::createProgram(
-			bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_geometry"),
-			bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_geometry"),
+		// Programs, one set per layout
+		static const char* s_fragmentShaders[GBufferLayout::Count] = { "fs_geometry", "fs_geometry_compact" };
+		for (uint32_t ii = 0; ii < GBufferLayout::Count; ++ii)
+		{
+			m_program[ii][VertexFormat::Full] = bgfx::createProgram(
+				bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_geometry"),
+				bgfx::createEmbeddedShader(s_embeddedShaders, type, s_fragmentShaders[ii]),
+				true
+			);
+
+			m_programInstanced[ii][VertexFormat::Full] = bgfx::createProgram(
+				bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_geometry_instanced"),
+				bgfx::createEmbeddedShader(s_embeddedShaders, type, s_fragmentShaders[ii]),
+				true
+			);
+
+			m_program[ii][VertexFormat::Packed] = bgfx::createProgram(
+				bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_geometry_packed"),
+				bgfx::createEmbeddedShader(s_embeddedShaders, type, s_fragmentShaders[ii]),
+				true
+			);
+
+			m_programInstanced[ii][VertexFormat::Packed] = bgfx::createProgram(
+				bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_geometry_packed_instanced"),
+				bgfx::createEmbeddedShader(s_embeddedShaders, type, s_fragmentShaders[ii]),
+				true
+			);
+		}
+
+		// Depth only, positions are computed the same way as in the geometry shaders
+		m_depthProgram[VertexFormat::Full] = bgfx::createProgram(
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_shadowmap"),
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_shadowmap"),
+			true
+		);
+
+		m_depthProgramInstanced[VertexFormat::Full] = bgfx::createProgram(
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_shadowmap_instanced"),
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_shadowmap"),
+			true
+		);
+
+		m_depthProgram[VertexFormat::Packed] = bgfx::createProgram(
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_shadowmap_packed"),
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_shadowmap"),
+			true
+		);
+
+		m_depthProgramInstanced[VertexFormat::Packed] = bgfx::createProgram(
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_shadowmap_packed_instanced"),
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_shadowmap"),
 			true
 		);
 
@@ -213,6 +451,9 @@ namespace mge
 		m_metRoughNorOccFactorUniform = bgfx::createUniform("u_metallicRoughnessNormalOcclusionFactor", bgfx::UniformType::Vec4);
 		m_emissiveFactorUniform		  = bgfx::createUniform("u_emissiveFactorVec", bgfx::UniformType::Vec4);
 		m_hasTexturesUniform		  = bgfx::createUniform("u_hasTextures", bgfx::UniformType::Vec4);
+		m_viewProjUniform			  = bgfx::createUniform("u_unjitteredViewProj", bgfx::UniformType::Mat4);
+		m_prevViewProjUniform		  = bgfx::createUniform("u_prevViewProj", bgfx::UniformType::Mat4);
+		m_prevModelUniform			  = bgfx::createUniform("u_prevModel", bgfx::UniformType::Mat4);
 
 		// Samplers
 		m_baseColorSampler = bgfx::createUniform("s_texBaseColor", bgfx::UniformType::Sampler);
@@ -222,6 +463,14 @@ namespace mge
 		m_occlusionSampler = bgfx::createUniform("s_texOcclusion", bgfx::UniformType::Sampler);
 		m_emissiveSampler  = bgfx::createUniform("s_texEmissive", bgfx::UniformType::Sampler);
 
+		// Compact layout needs a 10 bit normal target, depth drops to 24 bits where it can be sampled
+		const bgfx::Caps* caps = bgfx::getCaps();
+		const uint16_t rtFormat = BGFX_CAPS_FORMAT_TEXTURE_2D | BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER;
+		m_compactSupported = (caps->formats[bgfx::TextureFormat::RGB10A2] & rtFormat) == rtFormat;
+		m_compactDepthFormat = (caps->formats[bgfx::TextureFormat::D24] & rtFormat) == rtFormat 
+			? bgfx::TextureFormat::D24 
+			: bgfx::TextureFormat::D32F;
+
 		// Don't create framebuffer until first render call.
 		m_framebuffer.idx = bgfx::kInvalidHandle;
 	}
@@ -230,12 +479,24 @@ namespace mge
 	{
 		destroyFramebuffer();
 
-		bgfx::destroy(m_program);
+		for (uint32_t ii = 0; ii < VertexFormat::Count; ++ii)
+		{
+			for (uint32_t jj = 0; jj < GBufferLayout::Count; ++jj)
+			{
+				bgfx::destroy(m_program[jj][ii]);
+				bgfx::destroy(m_programInstanced[jj][ii]);
+			}
+			bgfx::destroy(m_depthProgram[ii]);
+			bgfx::destroy(m_depthProgramInstanced[ii]);
+		}
 		bgfx::destroy(m_normalMatrixUniform);
 		bgfx::destroy(m_baseColorFactorUniform);
 		bgfx::destroy(m_metRoughNorOccFactorUniform);
 		bgfx::destroy(m_emissiveFactorUniform);
 		bgfx::destroy(m_hasTexturesUniform);
+		bgfx::destroy(m_viewProjUniform);
+		bgfx::destroy(m_prevViewProjUniform);
+		bgfx::destroy(m_prevModelUniform);
 
 		bgfx::destroy(m_baseColorSampler);
 		bgfx::destroy(m_metallicSampler);
@@ -246,40 +507,148 @@ namespace mge
 		bgfx::destroy(m_defaultTexture);
 	}
 
+	GBufferLayout::Enum GBuffer::getLayout() const
+	{
+		return m_layout;
+	}
+
+	bgfx::TextureHandle GBuffer::getTexture(GBufferAttachment::Enum _attachment) const
+	{
+		if (m_layout == GBufferLayout::Compact)
+		{
+			// Fresnel metallic has no target, metallic is read from the normal target
+			static const uint8_t s_compactAttachments[GBufferAttachment::Count] = { 0, 1, 1, 2, 3, 4 };
+			return bgfx::getTexture(m_framebuffer, s_compactAttachments[_attachment]);
+		}
+
+		return bgfx::getTexture(m_framebuffer, uint8_t(_attachment));
+	}
+
 	void GBuffer::render(std::shared_ptr<World> _world)
 	{
 		// Begin timer
 		m_sd.begin();
 
-		// Recreate gbuffer upon reset. 
-		if (m_common->firstFrame)
+		// Recreate gbuffer upon reset, render resolution or layout change. 
+		const GBufferLayout::Enum layout = getSettings().renderer.compactGBuffer && m_compactSupported 
+			? GBufferLayout::Compact 
+			: GBufferLayout::Full;
+
+		if (m_common->firstFrame || m_common->renderResized || m_layout != layout)
 		{
+			m_layout = layout;
+
 			destroyFramebuffer();
 			createFramebuffer();
 		}
 
-		// Set view 
+		const bool prepass = getSettings().renderer.depthPrepass;
+
+		// Set views, the prepass clears when it runs. Black leaves zero velocity where nothing is drawn
 		bgfx::setViewFrameBuffer(m_view, m_framebuffer);
-		bgfx::setViewRect(m_view, 0, 0, m_common->width, m_common->height);
-		bgfx::setViewClear(m_view, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, 0x303030ff, 1.0f, 0);
+		bgfx::setViewRect(m_view, 0, 0, m_common->renderWidth, m_common->renderHeight);
+		bgfx::setViewClear(m_view, prepass ? BGFX_CLEAR_NONE : BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, 0x000000ff, 1.0f, 0);
+		bgfx::setViewMode(m_view, bgfx::ViewMode::DepthAscending); // Queue order, encoders finish in any order
 		bgfx::setViewTransform(m_view, m_common->view, m_common->proj);
 
-		// Submit
-		for (auto& entity : _world->m_objects)
+		if (prepass)
+		{
+			bgfx::setViewFrameBuffer(m_prepassView, m_framebuffer);
+			bgfx::setViewRect(m_prepassView, 0, 0, m_common->renderWidth, m_common->renderHeight);
+			bgfx::setViewClear(m_prepassView, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, 0x000000ff, 1.0f, 0);
+			bgfx::setViewMode(m_prepassView, bgfx::ViewMode::DepthAscending);
+			bgfx::setViewTransform(m_prepassView, m_common->view, m_common->proj);
+			bgfx::touch(m_prepassView);
+		}
+
+		// Camera frustum
+		float viewProj[16];
+		bx::mtxMul(viewProj, m_common->view, m_common->proj);
+
+		Frustum frustum;
+		frustum.build(viewProj, bgfx::getCaps()->homogeneousDepth);
+
+		// Batch
+		m_numSubmitted = 0;
+		m_numCulled = 0;
+		m_batcher.begin();
+
+		for (const RenderProxy& proxy : _world->m_renderProxies)
+		{
+			submit(proxy, frustum);
+		}
+
+		// Sort
+		m_queue.begin();
+		m_prepassQueue.begin();
+		for (uint32_t ii = 0; ii < m_batcher.getNumBatches(); ++ii)
 		{
-			if (std::shared_ptr<Scene> scene = std::dynamic_pointer_cast<Scene>(entity))
+			const InstanceBatch& batch = m_batcher.getBatch(ii);
+
+			uint8_t layer = InstanceBatcher::isInstanced(batch) ? 0 : 1;
+			if (batch.material && batch.material->blend)
 			{
-				for (auto& pair : scene->m_models)
-				{
-					submit(pair.second);
-				}
+				layer |= RenderQueue::kLayerTranslucent;
 			}
-
-			if (std::shared_ptr<Model> model = std::dynamic_pointer_cast<Model>(entity))
+			else if (prepass)
 			{
-				submit(model);
+				// Front to back only, state changes are cheap without a material
+				m_prepassQueue.push(RenderQueue::makeKey(m_prepassView, layer, 0, 0, batch.depth), ii);
 			}
+
+			const uint64_t key = RenderQueue::makeKey(m_view, layer,
+				m_queue.getMaterialId(batch.material.get()),
+				m_queue.getMeshId(batch.mesh.get()),
+				batch.depth);
+			m_queue.push(key, ii);
 		}
+		m_queue.sort();
+		m_prepassQueue.sort();
+
+		// Filled by the prepass, unknown for batches it doesn't draw
+		m_prepassInstanced.assign(m_batcher.getNumBatches(), UINT32_MAX);
+
+		// Submit depth
+		std::atomic<uint32_t> numPrepassDrawCalls(0);
+
+		parallelSubmit(m_prepassQueue.getNumItems(), [&](bgfx::Encoder* _encoder, uint32_t _begin, uint32_t _end)
+		{
+			uint32_t chunkDrawCalls = 0;
+
+			for (uint32_t ii = _begin; ii < _end; ++ii)
+			{
+				const uint32_t idx = m_prepassQueue.getValue(ii);
+				chunkDrawCalls += submitDepth(_encoder, m_batcher.getBatch(idx), ii, m_prepassInstanced[idx]);
+			}
+
+			numPrepassDrawCalls += chunkDrawCalls;
+		});
+
+		m_numPrepassDrawCalls = numPrepassDrawCalls;
+
+		// Submit
+		std::atomic<uint32_t> numDrawCalls(0);
+		std::atomic<uint32_t> numInstances(0);
+
+		parallelSubmit(m_queue.getNumItems(), [&](bgfx::Encoder* _encoder, uint32_t _begin, uint32_t _end)
+		{
+			SubmitState state = { _encoder, nullptr, 0, 0 };
+
+			for (uint32_t ii = _begin; ii < _end; ++ii)
+			{
+				const uint32_t idx = m_queue.getValue(ii);
+				submit(state, m_batcher.getBatch(idx), ii, prepass, m_prepassInstanced[idx]);
+			}
+
+			// Don't leak material bindings into the next view
+			_encoder->discard();
+
+			numDrawCalls += state.numDrawCalls;
+			numInstances += state.numInstances;
+		});
+
+		m_numDrawCalls = numDrawCalls;
+		m_numInstances = numInstances;
 
 		// End timer
 		m_sd.pushSample(m_sd.end());
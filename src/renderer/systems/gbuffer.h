@@ -6,6 +6,10 @@
 #pragma once
 
 #include "engine/sampledata.h"
+#include "engine/vertex.h"
+
+#include "../instancing.h"
+#include "../render_queue.h"
 
 #include <bgfx/bgfx.h>
 
@@ -13,15 +17,31 @@
 
 namespace mge
 {
+    struct GBufferLayout
+    {
+        enum Enum
+        {
+            Full,    // Every attachment has its own target, 24 bytes per pixel
+            Compact, // Base color instead of diffuse and Fresnel, metallic stored with the normal, 20 bytes per pixel
+
+            Count
+        };
+    };
+
+    /// Compact layout targets: base color + roughness squared (BGRA8), encoded
+    /// normal + metallic (RGB10A2), emissive + occlusion (BGRA8), velocity
+    /// (RG16F) and depth (D24 when supported). Use GBuffer::getTexture to look
+    /// attachments up in either.
+    ///
     struct GBufferAttachment 
     {
-        // @todo Consider computing Fresnel reflectance in shader instead of storing it
         enum Enum
         {
             DiffuseRoughness,  // .rgb = Diffuse color, .a = Roughness squared (remapped roughness)
             EncodedNormal,     // .rg  = Encoded normal (compressed normal vector)
             FresnelMetallic,   // .rgb = Fresnel reflectance at normal incidence, .a = metallic factor
             EmissiveOcclusion, // .rgb = Emissive radiance, .a = Ambient occlusion multiplier
+            Velocity,          // .rg  = Texture space motion since the previous frame, without jitter
             Depth,             // .r   = Depth value
 
             Count
@@ -30,11 +50,13 @@ namespace mge
 
     class World;
     class Model;
+    struct RenderProxy;
     class Scene;
     class Material;
     class Texture;
 
 	struct CommonResources;
+	struct Frustum;
 
 	class GBuffer
 	{
@@ -45,32 +67,82 @@ namespace mge
         void createFramebuffer();
         void destroyFramebuffer();
 
-        void setUniforms();
-        void setMaterial(std::shared_ptr<Material> _material);
-        bool setTextureOrDefault(uint8_t stage, bgfx::UniformHandle uniform, std::shared_ptr<Texture> texture);
-        void submit(std::shared_ptr<Model> _model);
+        struct SubmitState
+        {
+            bgfx::Encoder* encoder;
+            const Material* boundMaterial;
+            uint32_t numDrawCalls;
+            uint32_t numInstances;
+        };
+
+        void setUniforms(bgfx::Encoder* _encoder, const float* _model);
+        void setMotionUniforms(bgfx::Encoder* _encoder, const float* _prevModel);
+        void setMaterial(bgfx::Encoder* _encoder, std::shared_ptr<Material> _material);
+        void bindMaterial(SubmitState& _state, const std::shared_ptr<Material>& _material);
+        bool setTextureOrDefault(bgfx::Encoder* _encoder, uint8_t stage, bgfx::UniformHandle uniform, std::shared_ptr<Texture> texture);
+        void submit(const RenderProxy& _proxy, const Frustum& _frustum);
+        void submit(SubmitState& _state, const InstanceBatch& _batch, uint32_t _order, bool _prepass, uint32_t _prepassInstanced);
+        uint32_t submitDepth(bgfx::Encoder* _encoder, const InstanceBatch& _batch, uint32_t _order, uint32_t& _numInstanced);
 
 	public:
+        static constexpr uint32_t kNumViews = 2; // Depth prepass and GBuffer generation
+
+        /// Uses views _view to _view + kNumViews - 1.
+        ///
 		GBuffer(bgfx::ViewId _view, std::shared_ptr<CommonResources> _common);
 		~GBuffer();
 
 		void render(std::shared_ptr<World> _world);
 
+        /// Get the layout of the current framebuffer.
+        ///
+        /// @returns Layout, compact falls back to full when not supported.
+        ///
+        GBufferLayout::Enum getLayout() const;
+
+        /// Get the texture holding an attachment in the current layout.
+        ///
+        /// @param[in] _attachment Attachment, Fresnel metallic is the normal target in the compact layout.
+        ///
+        /// @returns Texture of the framebuffer.
+        ///
+        bgfx::TextureHandle getTexture(GBufferAttachment::Enum _attachment) const;
+
     public:
         SampleData m_sd;
+        SampleData m_sdGpu[GBufferLayout::Count]; // GPU time of GBuffer and lighting views, per layout
+        uint32_t m_numSubmitted;
+        uint32_t m_numCulled;
+        uint32_t m_numDrawCalls;
+        uint32_t m_numInstances;
+        uint32_t m_numPrepassDrawCalls;
 
 	private:
+		bgfx::ViewId m_prepassView;
 		bgfx::ViewId m_view;
         std::shared_ptr<CommonResources> m_common;
-
+        InstanceBatcher m_batcher;
+        RenderQueue m_queue;
+        RenderQueue m_prepassQueue;
+        std::vector<uint32_t> m_prepassInstanced; // Instances drawn instanced by the prepass, per batch
+
+        GBufferLayout::Enum m_layout;
+        bool m_compactSupported;
+        bgfx::TextureFormat::Enum m_compactDepthFormat;
         bgfx::FrameBufferHandle m_framebuffer;
-		bgfx::ProgramHandle m_program;
+		bgfx::ProgramHandle m_program[GBufferLayout::Count][VertexFormat::Count];
+		bgfx::ProgramHandle m_programInstanced[GBufferLayout::Count][VertexFormat::Count];
+		bgfx::ProgramHandle m_depthProgram[VertexFormat::Count];
+		bgfx::ProgramHandle m_depthProgramInstanced[VertexFormat::Count];
         bgfx::TextureHandle m_defaultTexture;
         bgfx::UniformHandle m_normalMatrixUniform;
         bgfx::UniformHandle m_baseColorFactorUniform;
         bgfx::UniformHandle m_metRoughNorOccFactorUniform;
         bgfx::UniformHandle m_emissiveFactorUniform;
         bgfx::UniformHandle m_hasTexturesUniform;
+        bgfx::UniformHandle m_viewProjUniform;
+        bgfx::UniformHandle m_prevViewProjUniform;
+        bgfx::UniformHandle m_prevModelUniform;
         bgfx::UniformHandle m_baseColorSampler;
         bgfx::UniformHandle m_metallicSampler;
         bgfx::UniformHandle m_roughnessSampler;
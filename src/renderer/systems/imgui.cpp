@@ -7,14 +7,27 @@
 
 #include "../imgui/imgui.h"
 #include "../common_resources.h"
+#include "../texture_streamer.h"
+#include "../texture_residency.h"
+#include "../geometry_arena.h"
 
 #include "engine/window.h"
 #include "engine/settings.h"
+#include "engine/transform.h"
+#include "engine/component.h"
+#include "engine/world.h"
+#include "engine/job_system.h"
 
 #include "shadow_mapping.h"
 #include "gbuffer.h"
+#include "deferred.h"
 #include "skybox.h"
 #include "tone_mapping.h"
+#include "temporal_aa.h"
+
+#include <bx/bx.h>
+
+#include <stdio.h>
 
 namespace mge
 {
@@ -142,8 +155,59 @@ namespace mge
 				{
 					Settings::Scene& scene = settings.scene;
 					// display scene triangles vertex buffers etc
-					// display scene hiarchy? how many objects vs rendered objects
-					// instancing etc?
+					// display scene hiarchy?
+
+					ImGui::Checkbox("Parallel Update", &scene.parallelUpdate);
+
+					if (ImGui::TreeNodeEx("Transforms", ImGuiTreeNodeFlags_Leaf, "%-35s: %u updated",
+						"Transforms", getTransformStorage().getNumUpdated()))
+					{
+						ImGui::TreePop();
+					}
+
+					uint32_t numComponents = 0;
+					for (uint32_t ii = 0; ii < getNumComponentTypes(); ++ii)
+					{
+						numComponents += getComponentPool(ComponentTypeId(ii))->getNumComponents();
+					}
+
+					if (ImGui::TreeNodeEx("Components", ImGuiTreeNodeFlags_Leaf, "%-35s: %u in %u pools",
+						"Components", numComponents, getNumComponentTypes()))
+					{
+						ImGui::TreePop();
+					}
+
+					std::shared_ptr<GBuffer> gbuffer = _renderer->m_gbuffer;
+					if (ImGui::TreeNodeEx("Models (GBuffer)", ImGuiTreeNodeFlags_Leaf, "%-35s: %u submitted, %u culled",
+						"Models (GBuffer)", gbuffer->m_numSubmitted, gbuffer->m_numCulled))
+					{
+						ImGui::TreePop();
+					}
+
+					std::shared_ptr<ShadowMapping> shadowmap = _renderer->m_shadowmapping;
+					if (ImGui::TreeNodeEx("Models (Shadow Mapping)", ImGuiTreeNodeFlags_Leaf, "%-35s: %u submitted, %u culled",
+						"Models (Shadow Mapping)", shadowmap->m_numSubmitted, shadowmap->m_numCulled))
+					{
+						ImGui::TreePop();
+					}
+
+					if (ImGui::TreeNodeEx("Draw Calls (GBuffer)", ImGuiTreeNodeFlags_Leaf, "%-35s: %u draws, %u instances",
+						"Draw Calls (GBuffer)", gbuffer->m_numDrawCalls, gbuffer->m_numInstances))
+					{
+						ImGui::TreePop();
+					}
+
+					if (ImGui::TreeNodeEx("Draw Calls (Depth Prepass)", ImGuiTreeNodeFlags_Leaf, "%-35s: %u draws",
+						"Draw Calls (Depth Prepass)", gbuffer->m_numPrepassDrawCalls))
+					{
+						ImGui::TreePop();
+					}
+
+					if (ImGui::TreeNodeEx("Draw Calls (Shadow Mapping)", ImGuiTreeNodeFlags_Leaf, "%-35s: %u draws, %u instances",
+						"Draw Calls (Shadow Mapping)", shadowmap->m_numDrawCalls, shadowmap->m_numInstances))
+					{
+						ImGui::TreePop();
+					}
 				}
 
 				// Camera
@@ -160,11 +224,122 @@ namespace mge
 					
 					// actual render system settings
 					// probe res, shadow map size, etc
+
+					ImGui::Checkbox("Automatic Instancing", &renderer.instancing);
+					ImGui::Checkbox("Parallel Submit", &renderer.parallelSubmit);
+					ImGui::Checkbox("Depth Prepass", &renderer.depthPrepass);
+					ImGui::Checkbox("Compact GBuffer", &renderer.compactGBuffer);
+					ImGui::Checkbox("Dynamic Resolution", &renderer.dynamicResolution);
+					ImGui::SliderFloat("GPU Frame Budget (ms)", &renderer.gpuFrameBudget, 4.0f, 50.0f);
+					ImGui::SliderFloat("Min Resolution Scale", &renderer.minResolutionScale, 0.25f, 1.0f);
+					ImGui::SliderFloat("Max Resolution Scale", &renderer.maxResolutionScale, 0.25f, 1.0f);
+					ImGui::Checkbox("Temporal AA", &renderer.temporalAA);
+					ImGui::SliderFloat("Temporal Blend", &renderer.temporalBlend, 0.01f, 1.0f);
+
+					if (ImGui::TreeNodeEx("Render Resolution", ImGuiTreeNodeFlags_Leaf, "%-35s: %ux%u (%.0f%%)",
+						"Render Resolution", m_common->renderWidth, m_common->renderHeight, m_common->resolutionScale * 100.0f))
+					{
+						ImGui::TreePop();
+					}
+
+					ImGui::SliderFloat("Light Distance", &renderer.lightDistance, 10.0f, 1000.0f);
+					ImGui::SliderFloat("Sun Intensity", &renderer.sunIntensity, 0.0f, 20.0f);
+					ImGui::SliderFloat("Ambient Intensity", &renderer.ambientIntensity, 0.0f, 2.0f);
+					ImGui::SliderFloat("Exposure", &renderer.exposure, 0.1f, 8.0f);
+
+					const LightClusters& clusters = _renderer->m_deferred->m_clusters;
+					if (ImGui::TreeNodeEx("Light Clusters", ImGuiTreeNodeFlags_Leaf, "%-35s: %u / %u lights, %u indices, %u max per cluster",
+						"Light Clusters", clusters.getNumVisible(), clusters.getNumLights(), clusters.getNumIndices(), clusters.getMaxPerCluster()))
+					{
+						ImGui::TreePop();
+					}
+
+					ImGui::SliderFloat("LOD Threshold (px)", &renderer.lodThreshold, 0.0f, 8.0f);
+					ImGui::SliderFloat("Shadow LOD Bias", &renderer.shadowLodBias, 1.0f, 16.0f);
+
+					static const char* s_shadowMapResNames[] = { "256", "512", "1024", "2048", "4096" };
+					int shadowMapRes = 0;
+					while (shadowMapRes < 4 && (256u << shadowMapRes) < renderer.shadowMapRes)
+					{
+						shadowMapRes++;
+					}
+					if (ImGui::Combo("Shadow Map Resolution", &shadowMapRes, s_shadowMapResNames, BX_COUNTOF(s_shadowMapResNames)))
+					{
+						renderer.shadowMapRes = 256u << shadowMapRes;
+					}
+
+					int shadowCascades = int(renderer.shadowCascades);
+					if (ImGui::SliderInt("Shadow Cascades", &shadowCascades, 1, int(ShadowMapping::kMaxCascades)))
+					{
+						renderer.shadowCascades = uint32_t(shadowCascades);
+					}
+
+					ImGui::SliderFloat("Shadow Distance", &renderer.shadowDistance, 10.0f, 1000.0f);
+					ImGui::SliderFloat("Shadow Split Lambda", &renderer.shadowSplitLambda, 0.0f, 1.0f);
+					ImGui::Checkbox("Shadow Caching", &renderer.shadowCaching);
+
+					std::shared_ptr<ShadowMapping> shadowmap = _renderer->m_shadowmapping;
+					for (uint32_t ii = 0; ii < shadowmap->m_numCascades; ++ii)
+					{
+						const ShadowCascade& cascade = shadowmap->m_cascades[ii];
+
+						char label[32];
+						snprintf(label, sizeof(label), "Shadow Cascade %u", ii);
+						if (ImGui::TreeNodeEx(label, ImGuiTreeNodeFlags_Leaf, "%-35s: %.1f - %.1f m, %.3f m texels, %u models%s",
+							label, cascade.splitNear, cascade.splitFar, cascade.texelSize, cascade.numSubmitted, cascade.staticCached ? " (static cached)" : ""))
+						{
+							ImGui::TreePop();
+						}
+					}
+
+					int uploadBudgetKb = int(renderer.textureUploadBudget >> 10);
+					if (ImGui::SliderInt("Texture Upload Budget (KB)", &uploadBudgetKb, 256, 65536))
+					{
+						renderer.textureUploadBudget = uint32_t(uploadBudgetKb) << 10;
+					}
+
+					TextureStreamer* streamer = getTextureStreamer();
+					if (ImGui::TreeNodeEx("Texture Streaming", ImGuiTreeNodeFlags_Leaf, "%-35s: %u pending, %u uploaded (%u KB)",
+						"Texture Streaming", streamer->getNumPending(), streamer->getNumUploaded(), streamer->getUploadedSize() >> 10))
+					{
+						ImGui::TreePop();
+					}
+
+					int textureBudgetMb = int(renderer.textureBudget);
+					if (ImGui::SliderInt("Texture Budget (MB)", &textureBudgetMb, 64, 8192))
+					{
+						renderer.textureBudget = uint32_t(textureBudgetMb);
+					}
+
+					TextureResidency* residency = getTextureResidency();
+					if (ImGui::TreeNodeEx("Texture Residency", ImGuiTreeNodeFlags_Leaf, "%-35s: %u / %u MB, %u resident, %u evicted",
+						"Texture Residency", uint32_t(residency->getResidentSize() >> 20), renderer.textureBudget, residency->getNumResident(), residency->getNumEvicted()))
+					{
+						ImGui::TreePop();
+					}
+
+					GeometryArena* geometry = getGeometryArena();
+					uint32_t usedVertices, vertexCapacity, usedIndices, indexSize, indexCapacity;
+					geometry->getVertexUsage(usedVertices, vertexCapacity);
+					geometry->getIndexUsage(usedIndices, indexSize, indexCapacity);
+					if (ImGui::TreeNodeEx("Geometry Arena", ImGuiTreeNodeFlags_Leaf, "%-35s: %u / %u vertices, %u / %u indices (%u KB), %u buffers",
+						"Geometry Arena", usedVertices, vertexCapacity, usedIndices, indexCapacity, indexSize >> 10, geometry->getNumPages()))
+					{
+						ImGui::TreePop();
+					}
 				}
 
 				// Profiling
 				if (ImGui::CollapsingHeader("Profiling", ImGuiTreeNodeFlags_DefaultOpen))
 				{
+					if (ImGui::TreeNodeEx("Game Update", ImGuiTreeNodeFlags_Leaf, "%-35s: %.2f ms (%u workers)",
+						"Game Update", _renderer->m_world->m_sdGame.getAverage(), getJobSystem().getNumWorkers()))
+					{
+						ImGui::TreePop();
+					}
+
+					ImGui::Separator();
+
 					std::shared_ptr<ShadowMapping> shadowmap = _renderer->m_shadowmapping;
 					if (ImGui::TreeNodeEx("Shadow Mapping", ImGuiTreeNodeFlags_Leaf, "%-35s: %.2f ms",
 						"Shadow Mapping", shadowmap->m_sd.getAverage()))
@@ -179,6 +354,32 @@ namespace mge
 						ImGui::TreePop();
 					}
 
+					std::shared_ptr<Deferred> deferred = _renderer->m_deferred;
+					if (ImGui::TreeNodeEx("Deferred Shading", ImGuiTreeNodeFlags_Leaf, "%-35s: %.2f ms",
+						"Deferred Shading", deferred->m_sd.getAverage()))
+					{
+						ImGui::TreePop();
+					}
+
+					if (ImGui::TreeNodeEx("GBuffer + Lighting GPU (Full)", ImGuiTreeNodeFlags_Leaf, "%-35s: %.2f ms%s",
+						"GBuffer + Lighting GPU (Full)", gbuffer->m_sdGpu[GBufferLayout::Full].getAverage(), gbuffer->getLayout() == GBufferLayout::Full ? " (active)" : ""))
+					{
+						ImGui::TreePop();
+					}
+
+					if (ImGui::TreeNodeEx("GBuffer + Lighting GPU (Compact)", ImGuiTreeNodeFlags_Leaf, "%-35s: %.2f ms%s",
+						"GBuffer + Lighting GPU (Compact)", gbuffer->m_sdGpu[GBufferLayout::Compact].getAverage(), gbuffer->getLayout() == GBufferLayout::Compact ? " (active)" : ""))
+					{
+						ImGui::TreePop();
+					}
+
+					std::shared_ptr<TemporalAA> temporalaa = _renderer->m_temporalaa;
+					if (ImGui::TreeNodeEx("Temporal AA", ImGuiTreeNodeFlags_Leaf, "%-35s: %.2f ms",
+						"Temporal AA", temporalaa->m_sd.getAverage()))
+					{
+						ImGui::TreePop();
+					}
+
 					std::shared_ptr<Skybox> skybox = _renderer->m_skybox;
 					if (ImGui::TreeNodeEx("Skybox", ImGuiTreeNodeFlags_Leaf, "%-35s: %.2f ms",
 						"Skybox", skybox->m_sd.getAverage()))
@@ -225,6 +426,7 @@ namespace mge
 						"Normal",
 						"FresnelMetallic",
 						"EmissiveOcclusion",
+						"Velocity",
 						"Depth"
 					};
 
@@ -9,88 +9,486 @@
 #include "engine/world.h"
 #include "engine/mesh.h"
 #include "engine/objects/model.h"
-#include "engine/objects/scene.h"
-#include "engine/components/mesh_component.h"
 
 #include "../common_resources.h"
+#include "../frustum.h"
+#include "../parallel_submit.h"
+#include "../geometry_arena.h"
+#include "../lod.h"
 #include "../shaders/shadowmap.h"
 
 #include "../bgfx_utils.h"
 #include <bgfx/embedded_shader.h>
+#include <bx/bx.h>
 #include <bx/math.h>
 
+#include <atomic>
+#include <stdio.h>
+
 namespace mge
 {
 	static const bgfx::EmbeddedShader s_embeddedShaders[] =
 	{
 		BGFX_EMBEDDED_SHADER(vs_shadowmap),
+		BGFX_EMBEDDED_SHADER(vs_shadowmap_instanced),
+		BGFX_EMBEDDED_SHADER(vs_shadowmap_packed),
+		BGFX_EMBEDDED_SHADER(vs_shadowmap_packed_instanced),
 		BGFX_EMBEDDED_SHADER(fs_shadowmap),
 
 		BGFX_EMBEDDED_SHADER_END()
 	};
 
-	void ShadowMapping::createFramebuffer()
+	void ShadowMapping::createFramebuffer(uint32_t _resolution, uint32_t _numCascades)
 	{
-		const Settings& settings = getSettings();
+		// Cascades side by side in one atlas
+		const uint16_t width = uint16_t(_resolution * _numCascades);
+		const uint16_t height = uint16_t(_resolution);
 
-		m_framebuffer = bgfx::createFrameBuffer(
-			settings.renderer.shadowMapRes,
-			settings.renderer.shadowMapRes,
+		bgfx::TextureHandle shadowMap = bgfx::createTexture2D(
+			width,
+			height,
+			false,
+			1,
 			bgfx::TextureFormat::D16,
-			BGFX_TEXTURE_RT | BGFX_SAMPLER_COMPARE_LEQUAL);
+			BGFX_TEXTURE_RT | BGFX_TEXTURE_BLIT_DST | BGFX_SAMPLER_COMPARE_LEQUAL);
+		m_framebuffer = bgfx::createFrameBuffer(1, &shadowMap, true);
+
+		// Static casters are copied into the shadow map before dynamic ones are drawn
+		if (bgfx::getCaps()->supported & BGFX_CAPS_TEXTURE_BLIT)
+		{
+			m_staticFramebuffer = bgfx::createFrameBuffer(width, height, bgfx::TextureFormat::D16, BGFX_TEXTURE_RT);
+		}
+
+		for (uint32_t ii = 0; ii < kMaxCascades; ++ii)
+		{
+			m_staticValid[ii] = false;
+		}
+
+		m_resolution = _resolution;
+		m_numCascades = _numCascades;
 	}
 
 	void ShadowMapping::destroyFramebuffer()
 	{
+		// Textures are destroyed with them
 		if (isValid(m_framebuffer))
 		{
-			// Textures are destroyed with it
 			bgfx::destroy(m_framebuffer);
+			m_framebuffer.idx = bgfx::kInvalidHandle;
+		}
+
+		if (isValid(m_staticFramebuffer))
+		{
+			bgfx::destroy(m_staticFramebuffer);
+			m_staticFramebuffer.idx = bgfx::kInvalidHandle;
 		}
 	}
 
-	void ShadowMapping::submit(std::shared_ptr<Model> _model)
+	void ShadowMapping::submit(const RenderProxy& _proxy, const Frustum& _frustum, Casters::Enum _casters)
 	{
-		float mtx[16];
-		bx::mtxSRT(mtx, _model->getPosition(), _model->getRotation(), _model->getScale());
+		if (_casters != Casters::All && _proxy.isStatic != (_casters == Casters::Static))
+		{
+			return;
+		}
 
-		if (std::shared_ptr<MeshComponent> meshComp = _model->getComponent<MeshComponent>())
+		if (const std::shared_ptr<Mesh>& mesh = _proxy.mesh)
 		{
-			std::shared_ptr<Mesh> mesh = meshComp->m_mesh;
+			const float* mtx = _proxy.model->getWorldMatrix();
+
+			// Cull
+			if (!_frustum.intersects(_proxy.bounds))
+			{
+				m_numCulled++;
+				return;
+			}
+			m_numSubmitted++;
+
+			const float depth = length(Vec3(mtx[12], mtx[13], mtx[14]) - m_lightPosition);
+
+			// Shadows are blurred and seen at an angle, coarser levels hold up
+			const Settings& settings = getSettings();
+			const float lodThreshold = settings.renderer.lodThreshold * settings.renderer.shadowLodBias;
 
 			for (auto& submesh : mesh->m_submeshes)
 			{
-				bgfx::setTransform(mtx);
-				bgfx::setVertexBuffer(0, mesh->m_vbh);
-				bgfx::setIndexBuffer(submesh->m_ibh);
-				bgfx::submit(m_view, m_program);
+				// Material is irrelevant for depth only rendering
+				const uint8_t lod = selectLod(*submesh, _proxy.bounds, *m_common, lodThreshold);
+				m_batcher.add(mesh, submesh, nullptr, lod, mtx, depth);
 			}
 		}
 	}
 
+	uint32_t ShadowMapping::submit(bgfx::Encoder* _encoder, const InstanceBatch& _batch, bgfx::ViewId _view, uint32_t _order)
+	{
+		uint32_t numDrawCalls = 0;
+		const GeometryArena* geometry = getGeometryArena();
+		const VertexFormat::Enum format = _batch.mesh->m_vertexFormat;
+
+		// Instanced
+		uint32_t first = 0;
+		if (_batch.numInstances > 1 && InstanceBatcher::isEnabled())
+		{
+			while (first < _batch.numInstances)
+			{
+				bgfx::InstanceDataBuffer idb;
+				const uint32_t num = InstanceBatcher::allocInstanceData(&idb, _batch, first);
+				if (num == 0)
+				{
+					// Out of instance data memory, draw the rest one by one.
+					break;
+				}
+
+				_encoder->setState(m_state);
+				geometry->setVertexBuffer(_encoder, *_batch.mesh);
+				geometry->setIndexBuffer(_encoder, *_batch.submesh, _batch.lod);
+				_encoder->setInstanceDataBuffer(&idb);
+				_encoder->submit(_view, m_programInstanced[format], _order);
+
+				numDrawCalls++;
+				first += num;
+			}
+		}
+
+		// Non-instanced
+		for (uint32_t ii = first; ii < _batch.numInstances; ++ii)
+		{
+			_encoder->setState(m_state);
+			_encoder->setTransform(&_batch.transforms[ii * 16]);
+			geometry->setVertexBuffer(_encoder, *_batch.mesh);
+			geometry->setIndexBuffer(_encoder, *_batch.submesh, _batch.lod);
+			_encoder->submit(_view, m_program[format], _order);
+
+			numDrawCalls++;
+		}
+
+		return numDrawCalls;
+	}
+
 	ShadowMapping::ShadowMapping(bgfx::ViewId _view, std::shared_ptr<CommonResources> _common)
-		: m_view(_view)
+		: m_cascades()
+		, m_numCascades(0)
+		, m_resolution(0)
+		, m_numStaticUpdates(0)
+		, m_numSubmitted(0)
+		, m_numCulled(0)
+		, m_numDrawCalls(0)
+		, m_numInstances(0)
+		, m_view(_view)
 		, m_common(_common)
+		, m_state(0
+			| BGFX_STATE_WRITE_Z
+			| BGFX_STATE_DEPTH_TEST_LESS
+			| BGFX_STATE_CULL_CCW
+			| BGFX_STATE_MSAA)
 	{
-		bgfx::setViewName(_view, "Shadow Mapping");
+		for (uint32_t ii = 0; ii < kMaxCascades; ++ii)
+		{
+			char name[32];
+			snprintf(name, sizeof(name), "Static Shadow Cascade %u", ii);
+			bgfx::setViewName(bgfx::ViewId(_view + ii), name);
+
+			snprintf(name, sizeof(name), "Shadow Cascade %u", ii);
+			bgfx::setViewName(bgfx::ViewId(_view + kMaxCascades + ii), name);
+		}
 
 		const bgfx::RendererType::Enum type = bgfx::getRendererType();
 
-		m_program = bgfx::createProgram(
+		m_program[VertexFormat::Full] = bgfx::createProgram(
 			bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_shadowmap"), 
 			bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_shadowmap"), 
 			true
 		);
 
+		m_programInstanced[VertexFormat::Full] = bgfx::createProgram(
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_shadowmap_instanced"), 
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_shadowmap"), 
+			true
+		);
+
+		m_program[VertexFormat::Packed] = bgfx::createProgram(
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_shadowmap_packed"), 
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_shadowmap"), 
+			true
+		);
+
+		m_programInstanced[VertexFormat::Packed] = bgfx::createProgram(
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_shadowmap_packed_instanced"), 
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_shadowmap"), 
+			true
+		);
+
+		s_shadowMap = bgfx::createUniform("s_shadowMap", bgfx::UniformType::Sampler);
+		u_shadowMtx = bgfx::createUniform("u_shadowMtx", bgfx::UniformType::Mat4, kMaxCascades);
+		u_shadowSplits = bgfx::createUniform("u_shadowSplits", bgfx::UniformType::Vec4);
+		u_shadowBias = bgfx::createUniform("u_shadowBias", bgfx::UniformType::Vec4);
+		u_shadowParams = bgfx::createUniform("u_shadowParams", bgfx::UniformType::Vec4);
+
 		// Don't create framebuffer until first render call.
 		m_framebuffer.idx = bgfx::kInvalidHandle;
+		m_staticFramebuffer.idx = bgfx::kInvalidHandle;
+
+		for (uint32_t ii = 0; ii < kMaxCascades; ++ii)
+		{
+			m_staticVersion[ii] = 0;
+			m_staticValid[ii] = false;
+		}
 	}
 
 	ShadowMapping::~ShadowMapping()
 	{
 		destroyFramebuffer();
 
-		bgfx::destroy(m_program);
+		for (uint32_t ii = 0; ii < VertexFormat::Count; ++ii)
+		{
+			bgfx::destroy(m_program[ii]);
+			bgfx::destroy(m_programInstanced[ii]);
+		}
+
+		bgfx::destroy(s_shadowMap);
+		bgfx::destroy(u_shadowMtx);
+		bgfx::destroy(u_shadowSplits);
+		bgfx::destroy(u_shadowBias);
+		bgfx::destroy(u_shadowParams);
+	}
+
+	bgfx::TextureHandle ShadowMapping::getShadowMap() const
+	{
+		return bgfx::getTexture(m_framebuffer);
+	}
+
+	void ShadowMapping::bind(uint8_t _stage) const
+	{
+		const bgfx::Caps* caps = bgfx::getCaps();
+
+		float invView[16];
+		bx::mtxInverse(invView, m_common->view);
+
+		// Light clip space to the tile of each cascade in the atlas
+		const float sy = caps->originBottomLeft ? 0.5f : -0.5f;
+		const float sz = caps->homogeneousDepth ? 0.5f : 1.0f;
+		const float tz = caps->homogeneousDepth ? 0.5f : 0.0f;
+
+		float shadowMtx[kMaxCascades][16];
+		float splits[4];
+		float bias[4];
+		for (uint32_t ii = 0; ii < kMaxCascades; ++ii)
+		{
+			// Unused cascades repeat the last one, so shaders never select them
+			const ShadowCascade& cascade = m_cascades[bx::min(ii, m_numCascades - 1)];
+
+			const float tile[16] =
+			{
+				0.5f / float(m_numCascades), 0.0f, 0.0f, 0.0f,
+				0.0f, sy,   0.0f, 0.0f,
+				0.0f, 0.0f, sz,   0.0f,
+				(float(ii) + 0.5f) / float(m_numCascades), 0.5f, tz, 1.0f,
+			};
+
+			float viewToLight[16];
+			bx::mtxMul(viewToLight, invView, cascade.viewProj);
+			bx::mtxMul(shadowMtx[ii], viewToLight, tile);
+
+			splits[ii] = cascade.splitFar;
+			bias[ii] = cascade.depthBias;
+		}
+
+		const float params[4] = 
+		{ 
+			float(m_numCascades), 
+			1.0f / float(m_resolution * m_numCascades), 
+			1.0f / float(m_resolution), 
+			0.0f 
+		};
+
+		bgfx::setTexture(_stage, s_shadowMap, getShadowMap());
+		bgfx::setUniform(u_shadowMtx, shadowMtx, kMaxCascades);
+		bgfx::setUniform(u_shadowSplits, splits);
+		bgfx::setUniform(u_shadowBias, bias);
+		bgfx::setUniform(u_shadowParams, params);
+	}
+
+	void ShadowMapping::updateCascades(const Vec3& _lightDir)
+	{
+		const Settings& settings = getSettings();
+		const bgfx::Caps* caps = bgfx::getCaps();
+
+		// Practical split scheme, Zhang et al. "Parallel-Split Shadow Maps"
+		const float nearPlane = m_common->cameraNear;
+		const float farPlane = bx::max(bx::min(m_common->cameraFar, settings.renderer.shadowDistance), nearPlane + 0.01f);
+		const float lambda = bx::clamp(settings.renderer.shadowSplitLambda, 0.0f, 1.0f);
+
+		float splits[kMaxCascades + 1];
+		splits[0] = nearPlane;
+		for (uint32_t ii = 1; ii <= m_numCascades; ++ii)
+		{
+			const float fraction = float(ii) / float(m_numCascades);
+			const float logSplit = nearPlane * bx::pow(farPlane / nearPlane, fraction);
+			const float uniformSplit = nearPlane + (farPlane - nearPlane) * fraction;
+			splits[ii] = bx::lerp(uniformSplit, logSplit, lambda);
+		}
+
+		// Camera frustum corners at the near and far plane in world space
+		float viewProj[16];
+		float invViewProj[16];
+		bx::mtxMul(viewProj, m_common->view, m_common->proj);
+		bx::mtxInverse(invViewProj, viewProj);
+
+		const float ndcNear = caps->homogeneousDepth ? -1.0f : 0.0f;
+
+		Vec3 nearCorners[4];
+		Vec3 farCorners[4];
+		for (uint32_t ii = 0; ii < 4; ++ii)
+		{
+			const float x = (ii & 1) ? 1.0f : -1.0f;
+			const float y = (ii & 2) ? 1.0f : -1.0f;
+
+			const bx::Vec3 nearCorner = bx::mulH({ x, y, ndcNear }, invViewProj);
+			const bx::Vec3 farCorner = bx::mulH({ x, y, 1.0f }, invViewProj);
+			nearCorners[ii] = Vec3(nearCorner.x, nearCorner.y, nearCorner.z);
+			farCorners[ii] = Vec3(farCorner.x, farCorner.y, farCorner.z);
+		}
+
+		// Avoid a degenerate light view when the light is straight above
+		const Vec3 up = bx::abs(_lightDir.y) > 0.99f ? Vec3(0.0f, 0.0f, 1.0f) : Vec3(0.0f, 1.0f, 0.0f);
+
+		// Light space rotation, for snapping
+		float lightRotation[16];
+		float invLightRotation[16];
+		bx::mtxLookAt(lightRotation, { 0.0f, 0.0f, 0.0f }, { -_lightDir.x, -_lightDir.y, -_lightDir.z }, { up.x, up.y, up.z }, bx::Handedness::Right);
+		bx::mtxTranspose(invLightRotation, lightRotation);
+
+		// Casters this far behind a cascade towards the light still cast into it
+		const float casterDistance = settings.renderer.shadowDistance;
+
+		for (uint32_t ii = 0; ii < m_numCascades; ++ii)
+		{
+			ShadowCascade& cascade = m_cascades[ii];
+			cascade.splitNear = splits[ii];
+			cascade.splitFar = splits[ii + 1];
+
+			// Corners are linear in view depth between the near and far plane
+			const float t0 = (cascade.splitNear - nearPlane) / (m_common->cameraFar - nearPlane);
+			const float t1 = (cascade.splitFar - nearPlane) / (m_common->cameraFar - nearPlane);
+
+			Vec3 corners[8];
+			Vec3 center(0.0f, 0.0f, 0.0f);
+			for (uint32_t jj = 0; jj < 4; ++jj)
+			{
+				corners[jj + 0] = nearCorners[jj] + (farCorners[jj] - nearCorners[jj]) * t0;
+				corners[jj + 4] = nearCorners[jj] + (farCorners[jj] - nearCorners[jj]) * t1;
+				center = center + corners[jj + 0] + corners[jj + 4];
+			}
+			center = center * (1.0f / 8.0f);
+
+			// Bounding sphere keeps the projection size fixed as the camera
+			// turns, rounded so it does not change with float noise either.
+			float radius = 0.0f;
+			for (uint32_t jj = 0; jj < 8; ++jj)
+			{
+				radius = bx::max(radius, length(corners[jj] - center));
+			}
+			radius = bx::ceil(radius * 16.0f) / 16.0f;
+
+			// Move the center in whole texels of light space, so edges do not
+			// shimmer and the cascade stays put for the static cache.
+			const float texelSize = 2.0f * radius / float(m_resolution);
+
+			bx::Vec3 lightCenter = bx::mul({ center.x, center.y, center.z }, lightRotation);
+			lightCenter.x = bx::floor(lightCenter.x / texelSize) * texelSize;
+			lightCenter.y = bx::floor(lightCenter.y / texelSize) * texelSize;
+			lightCenter.z = bx::floor(lightCenter.z / texelSize) * texelSize;
+
+			const bx::Vec3 snapped = bx::mul(lightCenter, invLightRotation);
+			center = Vec3(snapped.x, snapped.y, snapped.z);
+
+			const Vec3 eye = center + _lightDir * (radius + casterDistance);
+			m_lightEyes[ii] = eye;
+
+			float* lightView = m_lightViews[ii];
+			float* lightProj = m_lightProjs[ii];
+			bx::mtxLookAt(lightView, { eye.x, eye.y, eye.z }, { center.x, center.y, center.z }, { up.x, up.y, up.z }, bx::Handedness::Right);
+			bx::mtxOrtho(lightProj, -radius, radius, -radius, radius, 0.0f, 2.0f * radius + casterDistance, 0.0f, caps->homogeneousDepth, bx::Handedness::Right);
+
+			bx::mtxMul(cascade.viewProj, lightView, lightProj);
+			cascade.texelSize = texelSize;
+			cascade.depthBias = texelSize / (2.0f * radius + casterDistance);
+		}
+	}
+
+	bool ShadowMapping::isStaticCached(std::shared_ptr<World> _world, uint32_t _cascade) const
+	{
+		return m_staticValid[_cascade]
+			&& m_staticVersion[_cascade] == _world->m_staticVersion
+			&& bx::memCmp(m_staticViewProj[_cascade], m_cascades[_cascade].viewProj, sizeof(float) * 16) == 0;
+	}
+
+	void ShadowMapping::renderCascade(std::shared_ptr<World> _world, uint32_t _cascade, bgfx::ViewId _view, bgfx::FrameBufferHandle _framebuffer, Casters::Enum _casters)
+	{
+		const bgfx::ViewId view = _view;
+		const bgfx::Caps* caps = bgfx::getCaps();
+
+		ShadowCascade& cascade = m_cascades[_cascade];
+		m_lightPosition = m_lightEyes[_cascade];
+
+		// Cascade frustum, extended towards the light
+		Frustum frustum;
+		frustum.build(cascade.viewProj, caps->homogeneousDepth);
+
+		// Set view, dynamic casters are drawn over the copied static ones
+		bgfx::setViewFrameBuffer(view, _framebuffer);
+		bgfx::setViewRect(view, uint16_t(_cascade * m_resolution), 0, uint16_t(m_resolution), uint16_t(m_resolution));
+		bgfx::setViewClear(view, _casters == Casters::Dynamic ? BGFX_CLEAR_NONE : BGFX_CLEAR_DEPTH, 0x303030ff, 1.0f, 0);
+		bgfx::setViewMode(view, bgfx::ViewMode::DepthAscending); // Queue order, encoders finish in any order
+		bgfx::setViewTransform(view, m_lightViews[_cascade], m_lightProjs[_cascade]);
+		bgfx::touch(view);
+
+		// Batch
+		const uint32_t numSubmitted = m_numSubmitted;
+		m_batcher.begin();
+
+		for (const RenderProxy& proxy : _world->m_renderProxies)
+		{
+			submit(proxy, frustum, _casters);
+		}
+
+		cascade.numSubmitted += m_numSubmitted - numSubmitted;
+
+		// Sort
+		const bool instancing = InstanceBatcher::isEnabled();
+
+		m_queue.begin();
+		for (uint32_t ii = 0; ii < m_batcher.getNumBatches(); ++ii)
+		{
+			const InstanceBatch& batch = m_batcher.getBatch(ii);
+
+			const uint8_t layer = (instancing && batch.numInstances > 1) ? 0 : 1;
+			const uint64_t key = RenderQueue::makeKey(view, layer, 0, m_queue.getMeshId(batch.mesh.get()), batch.depth);
+			m_queue.push(key, ii);
+		}
+		m_queue.sort();
+
+		// Submit
+		std::atomic<uint32_t> numDrawCalls(0);
+		std::atomic<uint32_t> numInstances(0);
+
+		parallelSubmit(m_queue.getNumItems(), [&](bgfx::Encoder* _encoder, uint32_t _begin, uint32_t _end)
+		{
+			uint32_t chunkDrawCalls = 0;
+			uint32_t chunkInstances = 0;
+
+			for (uint32_t ii = _begin; ii < _end; ++ii)
+			{
+				const InstanceBatch& batch = m_batcher.getBatch(m_queue.getValue(ii));
+				chunkDrawCalls += submit(_encoder, batch, view, ii);
+				chunkInstances += batch.numInstances;
+			}
+
+			numDrawCalls += chunkDrawCalls;
+			numInstances += chunkInstances;
+		});
+
+		m_numDrawCalls += numDrawCalls;
+		m_numInstances += numInstances;
 	}
 
 	void ShadowMapping::render(std::shared_ptr<World> _world)
@@ -98,54 +496,76 @@ namespace mge
 		// Begin timer
 		m_sd.begin();
 
-		//
-		if (m_common->firstFrame)
+		// Atlas has to fit the largest texture the device supports
+		const Settings& settings = getSettings();
+		const bgfx::Caps* caps = bgfx::getCaps();
+
+		const uint32_t numCascades = bx::clamp(settings.renderer.shadowCascades, 1u, kMaxCascades);
+		// Half resolution shadows when dynamic resolution is scaled down far, one step so the cache isn't redrawn often
+		const uint32_t shadowMapRes = m_common->resolutionScale < 0.7f 
+			? bx::max(settings.renderer.shadowMapRes / 2, 256u) 
+			: settings.renderer.shadowMapRes;
+		const uint32_t resolution = bx::min(shadowMapRes, caps->limits.maxTextureSize / numCascades);
+
+		if (m_common->firstFrame
+			|| m_resolution != resolution
+			|| m_numCascades != numCascades)
 		{
 			destroyFramebuffer();
-			createFramebuffer();
+			createFramebuffer(resolution, numCascades);
 		}
 
-		// Light View Proj
-		const Vec3 lightDir = _world->m_directionalLight;
-		float lightView[16];
-		float lightProj[16];
+		updateCascades(normalize(_world->m_directionalLight));
 
-		const bx::Vec3 at = { 0.0f,  0.0f,   0.0f };
-		const bx::Vec3 eye = { lightDir.x, lightDir.y, lightDir.z };
-		bx::mtxLookAt(lightView, eye, at);
+		m_numSubmitted = 0;
+		m_numCulled = 0;
+		m_numDrawCalls = 0;
+		m_numInstances = 0;
+		m_numStaticUpdates = 0;
 
-		const bgfx::Caps* caps = bgfx::getCaps();
-		const float area = 30.0f;
-		bx::mtxOrtho(lightProj, -area, area, -area, area, -100.0f, 100.0f, 0.0f, caps->homogeneousDepth, bx::Handedness::Right);
-
-		// Set view 
-		bgfx::setViewFrameBuffer(m_view, m_framebuffer);
-		bgfx::setViewRect(m_view, 0, 0, m_common->width, m_common->height);
-		bgfx::setViewClear(m_view, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, 0x303030ff, 1.0f, 0);
-		bgfx::setViewTransform(m_view, lightView, lightProj);
-		bgfx::setState(
-			m_view,
-			0
-			| BGFX_STATE_WRITE_Z
-			| BGFX_STATE_DEPTH_TEST_LESS
-			| BGFX_STATE_CULL_CCW
-			| BGFX_STATE_MSAA);
+		const bool caching = settings.renderer.shadowCaching && isValid(m_staticFramebuffer);
 
-		// Submit
-		for (auto& entity : _world->m_objects)
+		for (uint32_t ii = 0; ii < m_numCascades; ++ii)
 		{
-			if (std::shared_ptr<Scene> scene = std::dynamic_pointer_cast<Scene>(entity))
+			ShadowCascade& cascade = m_cascades[ii];
+			cascade.numSubmitted = 0;
+			cascade.staticCached = false;
+
+			const bgfx::ViewId staticView = bgfx::ViewId(m_view + ii);
+			const bgfx::ViewId view = bgfx::ViewId(m_view + kMaxCascades + ii);
+
+			if (!caching)
 			{
-				for (auto& pair : scene->m_models)
-				{
-					submit(pair.second);
-				}
+				// The cache is not kept up to date while disabled
+				m_staticValid[ii] = false;
+
+				renderCascade(_world, ii, view, m_framebuffer, Casters::All);
+				continue;
+			}
+
+			// Static views all come before the first shadow view, so
+			// redrawn cascades are in the cache before it is copied.
+			if (isStaticCached(_world, ii))
+			{
+				cascade.staticCached = true;
 			}
+			else
+			{
+				renderCascade(_world, ii, staticView, m_staticFramebuffer, Casters::Static);
 
-			if (std::shared_ptr<Model> model = std::dynamic_pointer_cast<Model>(entity))
+				bx::memCopy(m_staticViewProj[ii], cascade.viewProj, sizeof(float) * 16);
+				m_staticVersion[ii] = _world->m_staticVersion;
+				m_staticValid[ii] = true;
+				m_numStaticUpdates++;
+			}
+
+			if (ii == 0)
 			{
-				submit(model);
+				bgfx::blit(view, getShadowMap(), 0, 0, bgfx::getTexture(m_staticFramebuffer), 0, 0,
+					uint16_t(m_resolution * m_numCascades), uint16_t(m_resolution));
 			}
+
+			renderCascade(_world, ii, view, m_framebuffer, Casters::Dynamic);
 		}
 
 		// End timer
@@ -6,6 +6,11 @@
 #pragma once
 
 #include "engine/sampledata.h"
+#include "engine/vertex.h"
+#include "engine/math.h"
+
+#include "../instancing.h"
+#include "../render_queue.h"
 
 #include <bgfx/bgfx.h>
 
@@ -16,31 +21,101 @@ namespace mge
     class Renderer;
     class World;
     class Model;
+    struct RenderProxy;
 
     struct CommonResources;
+    struct Frustum;
+
+    /// Light space of one slice of the view frustum, stored side by side in
+    /// the shadow map.
+    ///
+    struct ShadowCascade
+    {
+        float viewProj[16]; // World to light clip space
+        float splitNear; // View distance the cascade starts at
+        float splitFar; // View distance the cascade ends at
+        float texelSize; // World units covered by one shadow map texel
+        float depthBias; // Shadow map depth covered by one texel
+        uint32_t numSubmitted;
+        bool staticCached; // Static casters were reused from the cache this frame
+    };
 
     class ShadowMapping
     {
-        void createFramebuffer();
+        struct Casters
+        {
+            enum Enum
+            {
+                All,
+                Static,
+                Dynamic,
+            };
+        };
+
+        void createFramebuffer(uint32_t _resolution, uint32_t _numCascades);
         void destroyFramebuffer();
 
-        void submit(std::shared_ptr<Model> _model);
+        void updateCascades(const Vec3& _lightDir);
+        bool isStaticCached(std::shared_ptr<World> _world, uint32_t _cascade) const;
+        void renderCascade(std::shared_ptr<World> _world, uint32_t _cascade, bgfx::ViewId _view, bgfx::FrameBufferHandle _framebuffer, Casters::Enum _casters);
+
+        void submit(const RenderProxy& _proxy, const Frustum& _frustum, Casters::Enum _casters);
+        uint32_t submit(bgfx::Encoder* _encoder, const InstanceBatch& _batch, bgfx::ViewId _view, uint32_t _order);
 
     public:
+        static constexpr uint32_t kMaxCascades = 4;
+        static constexpr uint32_t kNumViews = kMaxCascades * 2; // Static cache and shadow map per cascade
+
+        /// Uses views _view to _view + kNumViews - 1.
+        ///
         ShadowMapping(bgfx::ViewId _view, std::shared_ptr<CommonResources> _common);
         ~ShadowMapping();
 
         void render(std::shared_ptr<World> _world);
 
+        bgfx::TextureHandle getShadowMap() const;
+
+        /// Bind the shadow map and cascade uniforms for the next draw, cascades
+        /// are transformed from the view space of the camera.
+        ///
+        /// @param[in] _stage Texture stage of the shadow map.
+        ///
+        void bind(uint8_t _stage) const;
+
     public:
         SampleData m_sd;
+        ShadowCascade m_cascades[kMaxCascades];
+        uint32_t m_numCascades;
+        uint32_t m_resolution; // Of each cascade
+        uint32_t m_numStaticUpdates; // Cascades whose static casters were redrawn this frame
+        uint32_t m_numSubmitted;
+        uint32_t m_numCulled;
+        uint32_t m_numDrawCalls;
+        uint32_t m_numInstances;
 
     private:
         bgfx::ViewId m_view;
         std::shared_ptr<CommonResources> m_common;
+        InstanceBatcher m_batcher;
+        RenderQueue m_queue;
+        Vec3 m_lightPosition;
+        Vec3 m_lightEyes[kMaxCascades];
+        float m_lightViews[kMaxCascades][16];
+        float m_lightProjs[kMaxCascades][16];
 
-        bgfx::ProgramHandle m_program;
+        bgfx::ProgramHandle m_program[VertexFormat::Count];
+        bgfx::ProgramHandle m_programInstanced[VertexFormat::Count];
         bgfx::FrameBufferHandle m_framebuffer;
+        bgfx::FrameBufferHandle m_staticFramebuffer; // Depth of static casters only
+        bgfx::UniformHandle s_shadowMap;
+        bgfx::UniformHandle u_shadowMtx;
+        bgfx::UniformHandle u_shadowSplits;
+        bgfx::UniformHandle u_shadowBias;
+        bgfx::UniformHandle u_shadowParams;
+        float m_staticViewProj[kMaxCascades][16];
+        uint32_t m_staticVersion[kMaxCascades];
+        bool m_staticValid[kMaxCascades];
+        uint64_t m_state;
     };
 
 } // namespace mge
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include "skybox.h"
 #include "gbuffer.h"
+#include "deferred.h"
 
 #include "engine/world.h"
 #include "engine/texture.h"
@@ -12,6 +13,7 @@
 #include "../samplers.h"
 #include "../vertexpostex.h"
 #include "../common_resources.h"
+#include "../texture_residency.h"
 #include "../shaders/skybox.h"
 
 #include <bgfx/embedded_shader.h>
@@ -79,10 +81,11 @@ namespace mge
 		}
 	}
 
-	Skybox::Skybox(bgfx::ViewId _view, std::shared_ptr<CommonResources> _common, std::shared_ptr<GBuffer> _gbuffer)
+	Skybox::Skybox(bgfx::ViewId _view, std::shared_ptr<CommonResources> _common, std::shared_ptr<GBuffer> _gbuffer, std::shared_ptr<Deferred> _deferred)
 		: m_view(_view)
 		, m_common(_common)
 		, m_gbuffer(_gbuffer)
+		, m_deferred(_deferred)
 	{
 		bgfx::setViewName(_view, "Skybox");
 
@@ -113,11 +116,25 @@ namespace mge
 		// Begin timer
 		m_sd.begin();
 
+		// Environment maps are streamed in
+		std::shared_ptr<Texture> cubemap = _world->m_environment[Environment::Skybox];
+		if (cubemap != nullptr)
+		{
+			getTextureResidency()->touch(cubemap.get());
+		}
+
+		if (cubemap == nullptr || !bgfx::isValid(cubemap->m_th))
+		{
+			m_sd.pushSample(m_sd.end());
+			return;
+		}
+
 		float proj[16];
 		bx::mtxOrtho(proj, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 100.0f, 0.0f, bgfx::getCaps()->homogeneousDepth, bx::Handedness::Left);
 
-		bgfx::setViewFrameBuffer(m_view, BGFX_INVALID_HANDLE); // Render on top of previous
-		bgfx::setViewRect(m_view, 0, 0, m_common->width, m_common->height);
+		// Into the HDR light buffer, so temporal AA and tone mapping see the sky behind edges
+		bgfx::setViewFrameBuffer(m_view, m_deferred->getLightFramebuffer());
+		bgfx::setViewRect(m_view, 0, 0, m_common->renderWidth, m_common->renderHeight);
 		bgfx::setViewTransform(m_view, nullptr, proj);
 
 		float cameraMtx[16];
@@ -144,11 +161,10 @@ namespace mge
 		cameraMtx[15] = 1.0f;
 		bgfx::setUniform(u_cameraMtx, cameraMtx);
 
-		bgfx::setTexture(Samplers::DeferredDepth, s_gbufferDepth, bgfx::getTexture(m_gbuffer->m_framebuffer, GBufferAttachment::Depth));
-		bgfx::setTexture(Samplers::SkyboxCubemap, s_skyboxCubemap, _world->m_environment[Environment::Skybox]->m_th);
+		bgfx::setTexture(Samplers::DeferredDepth, s_gbufferDepth, m_gbuffer->getTexture(GBufferAttachment::Depth));
+		bgfx::setTexture(Samplers::SkyboxCubemap, s_skyboxCubemap, cubemap->m_th);
 		bgfx::setState(0
-			| BGFX_STATE_WRITE_RGB
-			| BGFX_STATE_DEPTH_TEST_EQUAL);
+			| BGFX_STATE_WRITE_RGB);
 		setScreenQuad();
 		bgfx::submit(m_view, m_program);
 
@@ -17,6 +17,7 @@ namespace mge
 
     struct CommonResources;
     class GBuffer;
+    class Deferred;
 
     class Skybox
     {
@@ -25,7 +26,7 @@ namespace mge
         void setScreenQuad();
 
     public:
-        Skybox(bgfx::ViewId _view, std::shared_ptr<CommonResources> _common, std::shared_ptr<GBuffer> _gbuffer);
+        Skybox(bgfx::ViewId _view, std::shared_ptr<CommonResources> _common, std::shared_ptr<GBuffer> _gbuffer, std::shared_ptr<Deferred> _deferred);
         ~Skybox();
 
         void render(std::shared_ptr<World> _world);
@@ -37,6 +38,7 @@ namespace mge
         bgfx::ViewId m_view;
         std::shared_ptr<CommonResources> m_common;
         std::shared_ptr<GBuffer> m_gbuffer;
+        std::shared_ptr<Deferred> m_deferred;
 
         bgfx::ProgramHandle m_program;
         bgfx::UniformHandle u_cameraMtx;
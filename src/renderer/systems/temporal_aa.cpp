@@ -0,0 +1,197 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#include "temporal_aa.h"
+#include "gbuffer.h"
+#include "deferred.h"
+
+#include "../common_resources.h"
+#include "../vertexpos.h"
+#include "../shaders/tonemap.h"
+#include "../shaders/taa.h"
+
+#include "engine/renderer.h"
+#include "engine/settings.h"
+
+#include <bgfx/embedded_shader.h>
+#include <bx/bx.h>
+
+namespace mge
+{
+	static const bgfx::EmbeddedShader s_embeddedShaders[] =
+	{
+		BGFX_EMBEDDED_SHADER(vs_tonemap),
+		BGFX_EMBEDDED_SHADER(fs_taa),
+
+		BGFX_EMBEDDED_SHADER_END()
+	};
+
+	void TemporalAA::createFramebuffers()
+	{
+		const uint64_t flags = BGFX_SAMPLER_U_CLAMP |
+							   BGFX_SAMPLER_V_CLAMP;
+
+		// History is reprojected between pixels, so it's sampled bilinearly
+		for (uint32_t ii = 0; ii < 2; ++ii)
+		{
+			bgfx::TextureHandle texture =
+				bgfx::createTexture2D(m_common->width, m_common->height, false, 1, bgfx::TextureFormat::RGBA16F, BGFX_TEXTURE_RT | flags);
+			m_history[ii] = bgfx::createFrameBuffer(1, &texture, true);
+		}
+
+		m_width = m_common->width;
+		m_height = m_common->height;
+		m_historyValid = false;
+	}
+
+	void TemporalAA::destroyFramebuffers()
+	{
+		for (uint32_t ii = 0; ii < 2; ++ii)
+		{
+			if (isValid(m_history[ii]))
+			{
+				// Textures are destroyed with it
+				bgfx::destroy(m_history[ii]);
+				m_history[ii].idx = bgfx::kInvalidHandle;
+			}
+		}
+	}
+
+	void TemporalAA::createScreenBuffer()
+	{
+		constexpr float b = -1.0f;
+		constexpr float t =  3.0f;
+		constexpr float l = -1.0f;
+		constexpr float r =  3.0f;
+
+		const VertexPos vertices[3] = {
+			{Vec3(l, b, 0.0f)},
+			{Vec3(r, b, 0.0f)},
+			{Vec3(l, t, 0.0f)}};
+
+		m_vbh = bgfx::createVertexBuffer(bgfx::copy(&vertices, sizeof(vertices)), VertexPos::ms_layout);
+	}
+
+	void TemporalAA::destroyScreenBuffer()
+	{
+		if (isValid(m_vbh))
+		{
+			bgfx::destroy(m_vbh);
+		}
+	}
+
+	TemporalAA::TemporalAA(bgfx::ViewId _view, std::shared_ptr<CommonResources> _common, std::shared_ptr<GBuffer> _gbuffer, std::shared_ptr<Deferred> _deferred)
+		: m_view(_view)
+		, m_common(_common)
+		, m_gbuffer(_gbuffer)
+		, m_deferred(_deferred)
+		, m_current(0)
+		, m_width(0)
+		, m_height(0)
+		, m_historyValid(false)
+	{
+		bgfx::setViewName(_view, "Temporal AA");
+
+		const bgfx::RendererType::Enum type = bgfx::getRendererType();
+
+		m_program = bgfx::createProgram(
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_tonemap"),
+			bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_taa"),
+			true
+		);
+		s_texColor = bgfx::createUniform("s_texColor", bgfx::UniformType::Sampler);
+		s_texHistory = bgfx::createUniform("s_texHistory", bgfx::UniformType::Sampler);
+		s_texVelocity = bgfx::createUniform("s_texVelocity", bgfx::UniformType::Sampler);
+		u_taaParams = bgfx::createUniform("u_taaParams", bgfx::UniformType::Vec4);
+		u_taaTexel = bgfx::createUniform("u_taaTexel", bgfx::UniformType::Vec4);
+
+		// Don't create buffers until first render call.
+		m_vbh.idx = bgfx::kInvalidHandle;
+		m_history[0].idx = bgfx::kInvalidHandle;
+		m_history[1].idx = bgfx::kInvalidHandle;
+	}
+
+	TemporalAA::~TemporalAA()
+	{
+		destroyFramebuffers();
+		destroyScreenBuffer();
+
+		bgfx::destroy(m_program);
+		bgfx::destroy(s_texColor);
+		bgfx::destroy(s_texHistory);
+		bgfx::destroy(s_texVelocity);
+		bgfx::destroy(u_taaParams);
+		bgfx::destroy(u_taaTexel);
+	}
+
+	bgfx::TextureHandle TemporalAA::getOutput() const
+	{
+		return bgfx::getTexture(m_history[m_current]);
+	}
+
+	void TemporalAA::render()
+	{
+		// Begin timer
+		m_sd.begin();
+
+		const Settings::Renderer& settings = getSettings().renderer;
+
+		if (!settings.temporalAA)
+		{
+			// Start over once enabled again
+			m_historyValid = false;
+			m_sd.pushSample(m_sd.end());
+			return;
+		}
+
+		if (m_common->firstFrame)
+		{
+			destroyScreenBuffer();
+			createScreenBuffer();
+		}
+
+		if (m_common->firstFrame || m_width != m_common->width || m_height != m_common->height)
+		{
+			destroyFramebuffers();
+			createFramebuffers();
+		}
+
+		const uint32_t previous = m_current;
+		m_current ^= 1;
+
+		// Set view
+		bgfx::setViewClear(m_view, BGFX_CLEAR_NONE);
+		bgfx::setViewRect(m_view, 0, 0, m_common->width, m_common->height);
+		bgfx::setViewFrameBuffer(m_view, m_history[m_current]);
+
+		// Jitter from NDC to texture space, y points down unless the origin is bottom left
+		const bgfx::Caps* caps = bgfx::getCaps();
+		const float params[4] =
+		{
+			m_common->jitter[0] * 0.5f,
+			m_common->jitter[1] * (caps->originBottomLeft ? 0.5f : -0.5f),
+			bx::clamp(settings.temporalBlend, 0.01f, 1.0f),
+			m_historyValid ? 1.0f : 0.0f
+		};
+		bgfx::setUniform(u_taaParams, params);
+
+		const float texel[4] = { 1.0f / float(m_common->renderWidth), 1.0f / float(m_common->renderHeight), 0.0f, 0.0f };
+		bgfx::setUniform(u_taaTexel, texel);
+
+		// Bilinear, the light buffer is at render resolution
+		bgfx::setTexture(0, s_texColor, m_deferred->getLightBuffer(), BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP);
+		bgfx::setTexture(1, s_texHistory, bgfx::getTexture(m_history[previous]));
+		bgfx::setTexture(2, s_texVelocity, m_gbuffer->getTexture(GBufferAttachment::Velocity));
+
+		bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_CULL_CW);
+		bgfx::setVertexBuffer(0, m_vbh);
+		bgfx::submit(m_view, m_program);
+
+		m_historyValid = true;
+
+		// End timer
+		m_sd.pushSample(m_sd.end());
+	}
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#pragma once
+
+#include "engine/sampledata.h"
+
+#include <bgfx/bgfx.h>
+
+#include <memory>
+
+namespace mge
+{
+    class Renderer;
+
+    struct CommonResources;
+    class GBuffer;
+    class Deferred;
+
+    /// Accumulates the jittered HDR light buffer over frames at window
+    /// resolution. History is reprojected with the GBuffer velocity and
+    /// clamped to the current neighbourhood, so a scaled down render
+    /// resolution is reconstructed rather than just stretched.
+    ///
+    class TemporalAA
+    {
+        void createFramebuffers();
+        void destroyFramebuffers();
+
+        void createScreenBuffer();
+        void destroyScreenBuffer();
+
+    public:
+        TemporalAA(bgfx::ViewId _view, std::shared_ptr<CommonResources> _common, std::shared_ptr<GBuffer> _gbuffer, std::shared_ptr<Deferred> _deferred);
+        ~TemporalAA();
+
+        void render();
+
+        /// Get the resolved HDR color, read by tone mapping.
+        ///
+        /// @returns RGBA16F texture at window resolution.
+        ///
+        bgfx::TextureHandle getOutput() const;
+
+    public:
+        SampleData m_sd;
+
+    private:
+        bgfx::ViewId m_view;
+        std::shared_ptr<CommonResources> m_common;
+        std::shared_ptr<GBuffer> m_gbuffer;
+        std::shared_ptr<Deferred> m_deferred;
+
+        bgfx::ProgramHandle m_program;
+        bgfx::UniformHandle s_texColor;
+        bgfx::UniformHandle s_texHistory;
+        bgfx::UniformHandle s_texVelocity;
+        bgfx::UniformHandle u_taaParams;
+        bgfx::UniformHandle u_taaTexel;
+        bgfx::VertexBufferHandle m_vbh;
+        bgfx::FrameBufferHandle m_history[2]; // Ping-pong, one is read while the other is written
+        uint32_t m_current; // Written last, the output
+        uint16_t m_width;
+        uint16_t m_height;
+        bool m_historyValid;
+    };
+
+} // namespace mge
\ No newline at end of file
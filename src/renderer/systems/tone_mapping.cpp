@@ -5,6 +5,8 @@
 
 #include "tone_mapping.h"
 #include "gbuffer.h"
+#include "deferred.h"
+#include "temporal_aa.h"
 
 #include "../common_resources.h"
 #include "../vertexpos.h"
@@ -49,10 +51,12 @@ namespace mge
 		}
 	}
 
-	ToneMapping::ToneMapping(bgfx::ViewId _view, std::shared_ptr<CommonResources> _common, std::shared_ptr<GBuffer> _gbuffer)
+	ToneMapping::ToneMapping(bgfx::ViewId _view, std::shared_ptr<CommonResources> _common, std::shared_ptr<GBuffer> _gbuffer, std::shared_ptr<Deferred> _deferred, std::shared_ptr<TemporalAA> _temporalaa)
 		: m_view(_view)
 		, m_common(_common)
 		, m_gbuffer(_gbuffer)
+		, m_deferred(_deferred)
+		, m_temporalaa(_temporalaa)
 	{
 		bgfx::setViewName(_view, "Tone Mapping");
 
@@ -64,6 +68,7 @@ namespace mge
 			true
 		);
 		m_sampler = bgfx::createUniform("s_texColor", bgfx::UniformType::Sampler);
+		m_paramsUniform = bgfx::createUniform("u_tonemapParams", bgfx::UniformType::Vec4);
 
 		// Don't create screen vertex buffer until first render call.
 		m_vbh.idx = bgfx::kInvalidHandle;
@@ -75,6 +80,7 @@ namespace mge
 
 		bgfx::destroy(m_program);
 		bgfx::destroy(m_sampler);
+		bgfx::destroy(m_paramsUniform);
 	}
 
 	void ToneMapping::render()
@@ -96,15 +102,25 @@ namespace mge
 		// Submit
 		Settings::Debugging& settings = getSettings().debugging;
 
-		if (settings.buffer == Settings::Debugging::None)
+		if (settings.buffer == Settings::Debugging::None && getSettings().renderer.temporalAA)
 		{
-			bgfx::setTexture(0, m_sampler, bgfx::getTexture(m_gbuffer->m_framebuffer, 0));
+			// Already resolved to the back buffer resolution
+			bgfx::setTexture(0, m_sampler, m_temporalaa->getOutput());
+		}
+		else if (settings.buffer == Settings::Debugging::None)
+		{
+			// Bilinear upscale from render resolution to the back buffer
+			bgfx::setTexture(0, m_sampler, m_deferred->getLightBuffer(), BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP);
 		}
 		else
 		{
-			bgfx::setTexture(0, m_sampler, bgfx::getTexture(m_gbuffer->m_framebuffer, uint8_t(settings.buffer) - 1));
+			bgfx::setTexture(0, m_sampler, m_gbuffer->getTexture(GBufferAttachment::Enum(settings.buffer - 1)));
 		}
 
+		// Debug buffers are shown as stored
+		const float params[4] = { getSettings().renderer.exposure, settings.buffer == Settings::Debugging::None ? 1.0f : 0.0f, 0.0f, 0.0f };
+		bgfx::setUniform(m_paramsUniform, params);
+
 		bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_CULL_CW);
 		bgfx::setVertexBuffer(0, m_vbh);
 		bgfx::submit(m_view, m_program);
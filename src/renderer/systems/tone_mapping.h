@@ -17,6 +17,8 @@ namespace mge
 
     struct CommonResources;
     class GBuffer;
+    class Deferred;
+    class TemporalAA;
 
     class ToneMapping
     {
@@ -24,7 +26,7 @@ namespace mge
         void destroyScreenBuffer();
 
     public:
-        ToneMapping(bgfx::ViewId _view, std::shared_ptr<CommonResources> _common, std::shared_ptr<GBuffer> _gbuffer);
+        ToneMapping(bgfx::ViewId _view, std::shared_ptr<CommonResources> _common, std::shared_ptr<GBuffer> _gbuffer, std::shared_ptr<Deferred> _deferred, std::shared_ptr<TemporalAA> _temporalaa);
         ~ToneMapping();
 
         void render();
@@ -36,9 +38,12 @@ namespace mge
         bgfx::ViewId m_view;
         std::shared_ptr<CommonResources> m_common;
         std::shared_ptr<GBuffer> m_gbuffer;
+        std::shared_ptr<Deferred> m_deferred;
+        std::shared_ptr<TemporalAA> m_temporalaa;
 
         bgfx::ProgramHandle m_program;
         bgfx::UniformHandle m_sampler;
+        bgfx::UniformHandle m_paramsUniform;
         bgfx::VertexBufferHandle m_vbh;
     };
 
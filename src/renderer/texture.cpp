@@ -6,17 +6,30 @@
 #include "engine/texture.h"
 
 #include "bgfx_utils.h"
+#include "texture_residency.h"
 
 namespace mge
 {
     Texture::Texture(const char* _filePath)
         : m_filepath(_filePath)
+        , m_th(BGFX_INVALID_HANDLE)
+        , m_residency(Residency::Evicted)
+        , m_lastUsed(0)
+        , m_size(0)
+        , m_fullSize(0)
+        , m_numMips(0)
+        , m_skipMips(0)
     {
-        m_th = bgfx::loadTexture(_filePath);
     }
 
     Texture::Texture()
         : m_th(BGFX_INVALID_HANDLE)
+        , m_residency(Residency::Evicted)
+        , m_lastUsed(0)
+        , m_size(0)
+        , m_fullSize(0)
+        , m_numMips(0)
+        , m_skipMips(0)
     {
         // @todo Implement...
     }
@@ -38,7 +51,16 @@ namespace mge
     {
         if (_filepath)
         {
-            return std::make_shared<Texture>(_filepath);
+            if (TextureResidency* residency = getTextureResidency())
+            {
+                return residency->load(_filepath);
+            }
+
+            // No renderer to stream with, load now
+            std::shared_ptr<Texture> texture = std::make_shared<Texture>(_filepath);
+            texture->m_th = bgfx::loadTexture(_filepath);
+            texture->m_residency = isValid(texture->m_th) ? Texture::Residency::Resident : Texture::Residency::Failed;
+            return texture;
         }
         else
         {
@@ -0,0 +1,392 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#include "texture_cooker.h"
+
+#include <bimg/bimg.h>
+#include <bimg/decode.h>
+#include <bimg/encode.h>
+#include <bx/allocator.h>
+#include <bx/file.h>
+#include <bx/math.h>
+
+#include <filesystem>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+
+namespace mge
+{
+	static constexpr const char* kTextureCachePath = "cache/textures/";
+	static constexpr const char* kTextureCacheIndex = "cache/textures/index.txt";
+	static constexpr uint64_t kTextureCookVersion = 1; // Bump when the cooked output changes
+
+	struct CookedTexture
+	{
+		uint64_t hash;
+		uint64_t size; // Of source file
+		int64_t time; // Last write time of source file
+	};
+
+	// Source path to cooked texture, so loading does not have to hash the source
+	struct TextureCacheIndex
+	{
+		TextureCacheIndex()
+			: loaded(false)
+		{
+		}
+
+		std::unordered_map<std::string, CookedTexture> entries;
+		std::mutex mutex;
+		bool loaded;
+	};
+
+	static TextureCacheIndex s_index;
+
+	static uint64_t hashData(const void* _data, uint64_t _size, uint64_t _seed)
+	{
+		// FNV-1a
+		const uint8_t* data = (const uint8_t*)_data;
+
+		uint64_t hash = 0xcbf29ce484222325ull ^ _seed;
+		for (uint64_t ii = 0; ii < _size; ++ii)
+		{
+			hash ^= data[ii];
+			hash *= 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	static std::string getCookedPath(uint64_t _hash)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "%016llx.ktx", (unsigned long long)_hash);
+		return std::string(kTextureCachePath) + name;
+	}
+
+	static bool getFileStamp(const char* _filepath, uint64_t& _size, int64_t& _time)
+	{
+		std::error_code ec;
+		_size = std::filesystem::file_size(_filepath, ec);
+		if (ec)
+		{
+			return false;
+		}
+
+		_time = (int64_t)std::filesystem::last_write_time(_filepath, ec).time_since_epoch().count();
+		return !ec;
+	}
+
+	static void loadIndex()
+	{
+		if (s_index.loaded)
+		{
+			return;
+		}
+		s_index.loaded = true;
+
+		FILE* file = nullptr;
+		fopen_s(&file, kTextureCacheIndex, "r");
+		if (file == nullptr)
+		{
+			return;
+		}
+
+		// hash size time path
+		unsigned long long hash, size;
+		long long time;
+		char path[1024];
+		while (fscanf(file, "%llx %llu %lld ", &hash, &size, &time) == 3 && fgets(path, sizeof(path), file) != nullptr)
+		{
+			path[strcspn(path, "\r\n")] = '\0';
+			s_index.entries[path] = { hash, size, time };
+		}
+
+		fclose(file);
+	}
+
+	static void saveIndex()
+	{
+		FILE* file = nullptr;
+		fopen_s(&file, kTextureCacheIndex, "w");
+		if (file == nullptr)
+		{
+			return;
+		}
+
+		for (const auto& [path, entry] : s_index.entries)
+		{
+			fprintf(file, "%016llx %llu %lld %s\n", (unsigned long long)entry.hash, (unsigned long long)entry.size, (long long)entry.time, path.c_str());
+		}
+
+		fclose(file);
+	}
+
+	static void downsample(float* _dst, const float* _src, uint32_t _width, uint32_t _height, bool _normalMap)
+	{
+		const uint32_t width = bx::max(_width / 2, 1u);
+		const uint32_t height = bx::max(_height / 2, 1u);
+
+		for (uint32_t yy = 0; yy < height; ++yy)
+		{
+			const uint32_t y0 = bx::min(yy * 2, _height - 1);
+			const uint32_t y1 = bx::min(yy * 2 + 1, _height - 1);
+
+			for (uint32_t xx = 0; xx < width; ++xx)
+			{
+				const uint32_t x0 = bx::min(xx * 2, _width - 1);
+				const uint32_t x1 = bx::min(xx * 2 + 1, _width - 1);
+
+				const float* a = &_src[(y0 * _width + x0) * 4];
+				const float* b = &_src[(y0 * _width + x1) * 4];
+				const float* c = &_src[(y1 * _width + x0) * 4];
+				const float* d = &_src[(y1 * _width + x1) * 4];
+
+				float* dst = &_dst[(yy * width + xx) * 4];
+				for (uint32_t ii = 0; ii < 4; ++ii)
+				{
+					dst[ii] = (a[ii] + b[ii] + c[ii] + d[ii]) * 0.25f;
+				}
+
+				// Averaged normals are shorter than unit length
+				if (_normalMap)
+				{
+					bx::Vec3 normal = bx::normalize(bx::Vec3{ dst[0] * 2.0f - 1.0f, dst[1] * 2.0f - 1.0f, dst[2] * 2.0f - 1.0f });
+					dst[0] = normal.x * 0.5f + 0.5f;
+					dst[1] = normal.y * 0.5f + 0.5f;
+					dst[2] = normal.z * 0.5f + 0.5f;
+				}
+			}
+		}
+	}
+
+	static bimg::ImageContainer* encode(bx::AllocatorI* _allocator, const bimg::ImageContainer& _image, TextureUsage::Enum _usage, bool _highQuality)
+	{
+		bimg::TextureFormat::Enum format = bimg::TextureFormat::BC1;
+		switch (_usage)
+		{
+		case TextureUsage::Color:      format = _highQuality ? bimg::TextureFormat::BC7 : bimg::TextureFormat::BC1; break;
+		case TextureUsage::ColorAlpha: format = _highQuality ? bimg::TextureFormat::BC7 : bimg::TextureFormat::BC3; break;
+		case TextureUsage::Linear:     format = bimg::TextureFormat::BC4; break;
+		case TextureUsage::Normal:     format = bimg::TextureFormat::BC5; break;
+		default: break;
+		}
+
+		const bool gamma = _usage == TextureUsage::Color || _usage == TextureUsage::ColorAlpha;
+		const bimg::Quality::Enum quality = _highQuality ? bimg::Quality::Highest : bimg::Quality::Default;
+
+		uint32_t width = _image.m_width;
+		uint32_t height = _image.m_height;
+
+		uint8_t numMips = 1;
+		while ((bx::max(width, height) >> numMips) > 0)
+		{
+			numMips++;
+		}
+
+		bimg::ImageContainer* output = bimg::imageAlloc(_allocator, format, uint16_t(width), uint16_t(height), 1, 1, false, true);
+
+		// Mips are filtered in linear space
+		std::vector<float> level((const float*)_image.m_data, (const float*)_image.m_data + width * height * 4);
+		if (gamma)
+		{
+			for (uint32_t ii = 0; ii < width * height; ++ii)
+			{
+				level[ii * 4 + 0] = bx::toLinear(level[ii * 4 + 0]);
+				level[ii * 4 + 1] = bx::toLinear(level[ii * 4 + 1]);
+				level[ii * 4 + 2] = bx::toLinear(level[ii * 4 + 2]);
+			}
+		}
+
+		std::vector<float> next;
+		std::vector<float> blocks;
+
+		bx::Error err;
+		for (uint8_t lod = 0; lod < numMips && err.isOk(); ++lod)
+		{
+			bimg::ImageMip mip;
+			bimg::imageGetRawData(*output, 0, lod, output->m_data, output->m_size, mip);
+
+			// Edge texels are repeated to fill partial blocks
+			const uint32_t blockWidth = (width + 3) & ~3u;
+			const uint32_t blockHeight = (height + 3) & ~3u;
+
+			blocks.resize(blockWidth * blockHeight * 4);
+			for (uint32_t yy = 0; yy < blockHeight; ++yy)
+			{
+				for (uint32_t xx = 0; xx < blockWidth; ++xx)
+				{
+					const float* src = &level[(bx::min(yy, height - 1) * width + bx::min(xx, width - 1)) * 4];
+					float* dst = &blocks[(yy * blockWidth + xx) * 4];
+
+					for (uint32_t ii = 0; ii < 4; ++ii)
+					{
+						dst[ii] = gamma && ii < 3 ? bx::toGamma(src[ii]) : src[ii];
+					}
+				}
+			}
+
+			bimg::imageEncodeFromRgba32f(_allocator, const_cast<uint8_t*>(mip.m_data), blocks.data(), blockWidth, blockHeight, 1, format, quality, &err);
+
+			if (lod + 1 < numMips)
+			{
+				next.resize(bx::max(width / 2, 1u) * bx::max(height / 2, 1u) * 4);
+				downsample(next.data(), level.data(), width, height, _usage == TextureUsage::Normal);
+				level.swap(next);
+
+				width = bx::max(width / 2, 1u);
+				height = bx::max(height / 2, 1u);
+			}
+		}
+
+		if (!err.isOk())
+		{
+			bimg::imageFree(output);
+			return nullptr;
+		}
+
+		return output;
+	}
+
+	bool cookTexture(const char* _filepath, TextureUsage::Enum _usage, bool _highQuality)
+	{
+		uint64_t size;
+		int64_t time;
+		if (!getFileStamp(_filepath, size, time))
+		{
+			BX_TRACE("Failed to open: %s.", _filepath);
+			return false;
+		}
+
+		bx::DefaultAllocator allocator;
+		bx::FileReader reader;
+		if (!bx::open(&reader, _filepath))
+		{
+			BX_TRACE("Failed to open: %s.", _filepath);
+			return false;
+		}
+
+		std::vector<uint8_t> data((size_t)bx::getSize(&reader));
+
+		bx::Error err;
+		bx::read(&reader, data.data(), (int32_t)data.size(), &err);
+		bx::close(&reader);
+
+		if (!err.isOk())
+		{
+			return false;
+		}
+
+		// Settings that change the output are part of the key
+		const uint64_t seed = kTextureCookVersion | (uint64_t(_usage) << 8) | (uint64_t(_highQuality) << 16);
+		const uint64_t hash = hashData(data.data(), data.size(), seed);
+		const std::string cookedPath = getCookedPath(hash);
+
+		std::error_code ec;
+		if (!std::filesystem::exists(cookedPath, ec))
+		{
+			bimg::ImageContainer* image = bimg::imageParse(&allocator, data.data(), (uint32_t)data.size());
+			if (image == nullptr)
+			{
+				BX_TRACE("Failed to parse: %s.", _filepath);
+				return false;
+			}
+
+			// Environment maps and volumes are not cooked, neither are already compressed images
+			if (image->m_cubeMap || image->m_depth > 1 || bimg::isCompressed(image->m_format))
+			{
+				bimg::imageFree(image);
+				return false;
+			}
+
+			bimg::ImageContainer* rgba = bimg::imageConvert(&allocator, bimg::TextureFormat::RGBA32F, *image, false);
+			bimg::imageFree(image);
+
+			if (rgba == nullptr)
+			{
+				return false;
+			}
+
+			bimg::ImageContainer* output = encode(&allocator, *rgba, _usage, _highQuality);
+			bimg::imageFree(rgba);
+
+			if (output == nullptr)
+			{
+				BX_TRACE("Failed to encode: %s.", _filepath);
+				return false;
+			}
+
+			// Written next to the cache and renamed, so a cooked texture is never partial
+			std::filesystem::create_directories(kTextureCachePath, ec);
+
+			const std::string tempPath = cookedPath + ".tmp";
+
+			bx::FileWriter writer;
+			if (bx::open(&writer, tempPath.c_str(), false, &err))
+			{
+				bimg::imageWriteKtx(&writer, *output, output->m_data, output->m_size, &err);
+				bx::close(&writer);
+			}
+			bimg::imageFree(output);
+
+			if (!err.isOk())
+			{
+				std::filesystem::remove(tempPath, ec);
+				return false;
+			}
+
+			std::filesystem::rename(tempPath, cookedPath, ec);
+			if (ec)
+			{
+				return false;
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(s_index.mutex);
+		loadIndex();
+
+		s_index.entries[_filepath] = { hash, size, time };
+		saveIndex();
+
+		return true;
+	}
+
+	std::string findCookedTexture(const char* _filepath)
+	{
+		CookedTexture entry;
+		{
+			std::lock_guard<std::mutex> lock(s_index.mutex);
+			loadIndex();
+
+			auto it = s_index.entries.find(_filepath);
+			if (it == s_index.entries.end())
+			{
+				return std::string();
+			}
+			entry = it->second;
+		}
+
+		// Source changed since it was cooked
+		uint64_t size;
+		int64_t time;
+		if (!getFileStamp(_filepath, size, time) || size != entry.size || time != entry.time)
+		{
+			return std::string();
+		}
+
+		std::string cookedPath = getCookedPath(entry.hash);
+
+		std::error_code ec;
+		if (!std::filesystem::exists(cookedPath, ec))
+		{
+			return std::string();
+		}
+
+		return cookedPath;
+	}
+
+} // namespace mge
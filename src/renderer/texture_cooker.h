@@ -0,0 +1,49 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#pragma once
+
+#include <string>
+
+namespace mge
+{
+	/// How a texture is sampled, decides the compressed format it is cooked to.
+	/// 
+	struct TextureUsage
+	{
+		enum Enum
+		{
+			Color,      //!< BC1, or BC7 if high quality
+			ColorAlpha, //!< BC3, or BC7 if high quality
+			Linear,     //!< BC4, single channel masks
+			Normal,     //!< BC5, z is reconstructed in the shader
+
+			Count
+		};
+	};
+
+	/// Cook a texture to a GPU compressed KTX with a full mip chain.
+	/// 
+	/// @param[in] _filepath Path of source image.
+	/// @param[in] _usage How the texture is sampled.
+	/// @param[in] _highQuality Use BC7 for color textures and the slowest encoder settings.
+	/// 
+	/// @remark Cooked textures are cached on disk by content hash, so cooking an 
+	/// unchanged or duplicated image again is only a hash of the file. Thread safe.
+	/// 
+	/// @returns True if a cooked texture exists for the source image.
+	/// 
+	bool cookTexture(const char* _filepath, TextureUsage::Enum _usage, bool _highQuality);
+
+	/// Find the cooked version of a texture.
+	/// 
+	/// @param[in] _filepath Path of source image.
+	/// 
+	/// @returns Path of cooked texture, empty if the texture was not cooked or 
+	/// the source has changed since. Thread safe.
+	/// 
+	std::string findCookedTexture(const char* _filepath);
+
+} // namespace mge
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#include "texture_residency.h"
+#include "texture_streamer.h"
+
+#include <algorithm>
+
+namespace mge
+{
+	static constexpr uint8_t kMaxSkipMips = 4;
+	static constexpr uint64_t kRestorePercent = 90; // Dropped mips are restored below this much of the budget
+
+	static TextureResidency* s_residency = nullptr;
+
+	TextureResidency::TextureResidency()
+		: m_frame(1)
+		, m_residentSize(0)
+		, m_numResident(0)
+		, m_numEvicted(0)
+	{
+	}
+
+	TextureResidency::~TextureResidency()
+	{
+	}
+
+	void TextureResidency::evict(Texture* _texture)
+	{
+		bgfx::destroy(_texture->m_th);
+		_texture->m_th = BGFX_INVALID_HANDLE;
+		_texture->m_residency = Texture::Residency::Evicted;
+		_texture->m_size = 0;
+		_texture->m_skipMips = 0;
+
+		m_numEvicted++;
+	}
+
+	std::shared_ptr<Texture> TextureResidency::load(const char* _filepath)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		std::weak_ptr<Texture>& entry = m_textures[_filepath];
+		if (std::shared_ptr<Texture> texture = entry.lock())
+		{
+			return texture;
+		}
+
+		std::shared_ptr<Texture> texture = std::make_shared<Texture>(_filepath);
+		entry = texture;
+
+		getTextureStreamer()->request(texture);
+		return texture;
+	}
+
+	void TextureResidency::update(uint64_t _budget)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		TextureStreamer* streamer = getTextureStreamer();
+
+		// Textures bound during the frame that was just rendered
+		const uint32_t lastFrame = m_frame;
+		m_frame++;
+
+		auto isInUse = [lastFrame](const std::shared_ptr<Texture>& _texture)
+		{
+			return _texture->m_lastUsed.load(std::memory_order_relaxed) >= lastFrame;
+		};
+
+		// Gather, textures are removed once released everywhere else
+		m_residentSize = 0;
+		for (auto it = m_textures.begin(); it != m_textures.end();)
+		{
+			std::shared_ptr<Texture> texture = it->second.lock();
+			if (texture == nullptr)
+			{
+				it = m_textures.erase(it);
+				continue;
+			}
+
+			switch (texture->m_residency)
+			{
+			case Texture::Residency::Resident:
+				m_resident.push_back(texture);
+				m_residentSize += texture->m_size;
+				break;
+
+			case Texture::Residency::Pending:
+				m_residentSize += texture->m_size; // Previous version is kept until replaced
+				break;
+
+			case Texture::Residency::Evicted:
+				m_evicted.push_back(texture);
+				break;
+
+			default:
+				break;
+			}
+
+			++it;
+		}
+
+		m_numResident = (uint32_t)m_resident.size();
+
+		// Evict least recently used, textures in use are kept
+		std::sort(m_resident.begin(), m_resident.end(), [](const std::shared_ptr<Texture>& _a, const std::shared_ptr<Texture>& _b)
+			{
+				return _a->m_lastUsed.load(std::memory_order_relaxed) < _b->m_lastUsed.load(std::memory_order_relaxed);
+			});
+
+		for (std::shared_ptr<Texture>& texture : m_resident)
+		{
+			if (m_residentSize <= _budget || isInUse(texture))
+			{
+				break;
+			}
+
+			m_residentSize -= texture->m_size;
+			m_numResident--;
+			evict(texture.get());
+		}
+
+		if (m_residentSize > _budget)
+		{
+			// Textures in use are over budget, drop the top mip of the largest ones
+			std::sort(m_resident.begin(), m_resident.end(), [](const std::shared_ptr<Texture>& _a, const std::shared_ptr<Texture>& _b)
+				{
+					return _a->m_size > _b->m_size;
+				});
+
+			for (std::shared_ptr<Texture>& texture : m_resident)
+			{
+				if (m_residentSize <= _budget)
+				{
+					break;
+				}
+
+				if (texture->m_residency != Texture::Residency::Resident
+					|| texture->m_skipMips >= kMaxSkipMips
+					|| texture->m_skipMips + 1 >= texture->m_numMips)
+				{
+					continue;
+				}
+
+				m_residentSize -= texture->m_size - texture->m_size / 4;
+				streamer->request(texture, texture->m_skipMips + 1);
+			}
+		}
+		else
+		{
+			// Restore dropped mips of textures in use when there is room again
+			for (std::shared_ptr<Texture>& texture : m_resident)
+			{
+				if (texture->m_residency != Texture::Residency::Resident
+					|| texture->m_skipMips == 0
+					|| !isInUse(texture))
+				{
+					continue;
+				}
+
+				const uint64_t size = std::min<uint64_t>(uint64_t(texture->m_size) * 4, texture->m_fullSize);
+				if (m_residentSize + size - texture->m_size > _budget * kRestorePercent / 100)
+				{
+					continue;
+				}
+
+				m_residentSize += size - texture->m_size;
+				streamer->request(texture, texture->m_skipMips - 1);
+			}
+		}
+
+		// Stream evicted textures back in when used again, at lower resolution if there is no room
+		for (std::shared_ptr<Texture>& texture : m_evicted)
+		{
+			if (!isInUse(texture))
+			{
+				continue;
+			}
+
+			uint8_t skipMips = 0;
+			uint64_t size = texture->m_fullSize;
+			while (m_residentSize + size > _budget
+				&& skipMips < kMaxSkipMips
+				&& skipMips + 1 < texture->m_numMips)
+			{
+				skipMips++;
+				size /= 4;
+			}
+
+			m_residentSize += size;
+			streamer->request(texture, skipMips);
+		}
+
+		m_resident.clear();
+		m_evicted.clear();
+	}
+
+	uint64_t TextureResidency::getResidentSize() const
+	{
+		return m_residentSize;
+	}
+
+	uint32_t TextureResidency::getNumResident() const
+	{
+		return m_numResident;
+	}
+
+	uint32_t TextureResidency::getNumEvicted() const
+	{
+		return m_numEvicted;
+	}
+
+	void initTextureResidency()
+	{
+		s_residency = new TextureResidency();
+	}
+
+	void shutdownTextureResidency()
+	{
+		delete s_residency;
+		s_residency = nullptr;
+	}
+
+	TextureResidency* getTextureResidency()
+	{
+		return s_residency;
+	}
+
+} // namespace mge
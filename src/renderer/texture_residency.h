@@ -0,0 +1,91 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#pragma once
+
+#include "engine/texture.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mge
+{
+	/// Keeps streamed textures within a GPU memory budget.
+	/// 
+	/// Textures are shared by path. Render passes mark textures as used when 
+	/// they are bound, and once per frame the least recently used textures are 
+	/// evicted until the resident size is within budget. If the textures in use 
+	/// alone are over budget their top mips are dropped instead. Evicted 
+	/// textures are streamed back in when they are used again.
+	/// 
+	class TextureResidency
+	{
+		void evict(Texture* _texture);
+
+	public:
+		TextureResidency();
+		~TextureResidency();
+
+		/// Get or start loading a texture.
+		/// 
+		/// @param[in] _filepath Path of texture file.
+		/// 
+		/// @returns Shared Texture.
+		/// 
+		std::shared_ptr<Texture> load(const char* _filepath);
+
+		/// Evict and stream textures. Called once per frame after streamed 
+		/// textures have been uploaded.
+		/// 
+		/// @param[in] _budget Max bytes of texture memory.
+		/// 
+		void update(uint64_t _budget);
+
+		/// Mark a texture as used this frame, thread safe.
+		/// 
+		/// @param[in] _texture Bound texture.
+		/// 
+		void touch(Texture* _texture)
+		{
+			_texture->m_lastUsed.store(m_frame, std::memory_order_relaxed);
+		}
+
+		/// Get bytes of texture memory in use.
+		/// 
+		uint64_t getResidentSize() const;
+
+		/// Get number of textures in GPU memory.
+		/// 
+		uint32_t getNumResident() const;
+
+		/// Get number of textures evicted since the renderer was created.
+		/// 
+		uint32_t getNumEvicted() const;
+
+	private:
+		std::unordered_map<std::string, std::weak_ptr<Texture>> m_textures;
+		std::vector<std::shared_ptr<Texture>> m_resident;
+		std::vector<std::shared_ptr<Texture>> m_evicted;
+		std::mutex m_mutex;
+
+		uint32_t m_frame;
+		uint64_t m_residentSize;
+		uint32_t m_numResident;
+		uint32_t m_numEvicted;
+	};
+
+	void initTextureResidency();
+	void shutdownTextureResidency();
+
+	/// Get the texture residency manager.
+	/// 
+	/// @returns Texture residency manager, nullptr if no renderer has been created.
+	/// 
+	TextureResidency* getTextureResidency();
+
+} // namespace mge
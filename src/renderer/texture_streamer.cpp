@@ -0,0 +1,237 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#include "texture_streamer.h"
+#include "texture_residency.h"
+#include "texture_cooker.h"
+#include "bgfx_utils.h"
+
+#include "engine/texture.h"
+#include "engine/settings.h"
+
+#include <bimg/decode.h>
+#include <bx/file.h>
+
+namespace mge
+{
+	static TextureStreamer* s_streamer = nullptr;
+
+	TextureStreamer::TextureStreamer(uint32_t _numThreads)
+		: m_numPending(0)
+		, m_numUploaded(0)
+		, m_uploadedSize(0)
+		, m_shutdown(false)
+	{
+		for (uint32_t ii = 0; ii < bx::max(_numThreads, 1u); ++ii)
+		{
+			m_threads.emplace_back(&TextureStreamer::decode, this);
+		}
+	}
+
+	TextureStreamer::~TextureStreamer()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_requestMutex);
+			m_shutdown = true;
+		}
+		m_requestCv.notify_all();
+
+		for (std::thread& thread : m_threads)
+		{
+			thread.join();
+		}
+
+		// Images that were never uploaded
+		for (Request& request : m_decoded)
+		{
+			if (request.image != nullptr)
+			{
+				bimg::imageFree(request.image);
+			}
+		}
+	}
+
+	void TextureStreamer::decode()
+	{
+		bx::FileReader reader;
+
+		while (true)
+		{
+			Request request;
+			{
+				std::unique_lock<std::mutex> lock(m_requestMutex);
+				m_requestCv.wait(lock, [this]() { return m_shutdown || !m_requests.empty(); });
+
+				if (m_shutdown)
+				{
+					return;
+				}
+
+				request = std::move(m_requests.front());
+				m_requests.pop_front();
+			}
+
+			// Skip textures that were released while queued
+			if (!request.texture.expired())
+			{
+				// Cooked textures are compressed and have mips
+				const std::string cookedPath = findCookedTexture(request.filepath.c_str());
+				const char* filepath = cookedPath.empty() ? request.filepath.c_str() : cookedPath.c_str();
+
+				if (bx::open(&reader, filepath))
+				{
+					const uint32_t size = (uint32_t)bx::getSize(&reader);
+					void* data = bx::alloc(&m_allocator, size);
+
+					bx::Error err;
+					bx::read(&reader, data, size, &err);
+					bx::close(&reader);
+
+					if (err.isOk())
+					{
+						request.image = bimg::imageParse(&m_allocator, data, size);
+					}
+					bx::free(&m_allocator, data);
+				}
+				else
+				{
+					BX_TRACE("Failed to open: %s.", filepath);
+				}
+			}
+
+			std::lock_guard<std::mutex> lock(m_decodedMutex);
+			m_decoded.push_back(std::move(request));
+		}
+	}
+
+	void TextureStreamer::request(std::shared_ptr<Texture> _texture, uint8_t _skipMips, uint64_t _flags)
+	{
+		m_numPending++;
+		_texture->m_residency = Texture::Residency::Pending;
+
+		{
+			std::lock_guard<std::mutex> lock(m_requestMutex);
+			m_requests.push_back({ _texture, _texture->m_filepath, _flags, _skipMips, nullptr });
+		}
+		m_requestCv.notify_one();
+	}
+
+	void TextureStreamer::update(uint32_t _budget)
+	{
+		m_numUploaded = 0;
+		m_uploadedSize = 0;
+
+		while (true)
+		{
+			Request request;
+			{
+				std::lock_guard<std::mutex> lock(m_decodedMutex);
+				if (m_decoded.empty())
+				{
+					break;
+				}
+
+				// Always make progress, even if a single image is over budget
+				Request& front = m_decoded.front();
+				const uint32_t size = front.image != nullptr ? front.image->m_size : 0;
+				if (m_numUploaded != 0 && m_uploadedSize + size > _budget)
+				{
+					break;
+				}
+
+				request = std::move(front);
+				m_decoded.pop_front();
+			}
+
+			m_numPending--;
+
+			std::shared_ptr<Texture> texture = request.texture.lock();
+			if (texture == nullptr)
+			{
+				if (request.image != nullptr)
+				{
+					bimg::imageFree(request.image);
+				}
+				continue;
+			}
+
+			if (request.image == nullptr)
+			{
+				texture->m_residency = bgfx::isValid(texture->m_th) ? Texture::Residency::Resident : Texture::Residency::Failed;
+				continue;
+			}
+
+			m_uploadedSize += request.image->m_size;
+			m_numUploaded++;
+
+			bgfx::TextureInfo fullInfo;
+			bgfx::calcTextureSize(
+				fullInfo
+				, uint16_t(request.image->m_width)
+				, uint16_t(request.image->m_height)
+				, uint16_t(request.image->m_depth)
+				, request.image->m_cubeMap
+				, 1 < request.image->m_numMips
+				, request.image->m_numLayers
+				, bgfx::TextureFormat::Enum(request.image->m_format)
+			);
+			const uint8_t numMips = !request.image->m_cubeMap && 1 == request.image->m_depth 
+				? request.image->m_numMips 
+				: 1; // Only 2D textures can drop mips
+
+			// Replaces a lower or higher resolution version
+			if (bgfx::isValid(texture->m_th))
+			{
+				bgfx::destroy(texture->m_th);
+			}
+
+			bgfx::TextureInfo info;
+			texture->m_th = bgfx::createTexture(request.image, request.flags, request.filepath.c_str(), request.skipMips, &info);
+			texture->m_residency = bgfx::isValid(texture->m_th) ? Texture::Residency::Resident : Texture::Residency::Failed;
+			texture->m_size = info.storageSize;
+			texture->m_fullSize = fullInfo.storageSize;
+			texture->m_numMips = numMips;
+			texture->m_skipMips = numMips > 1 ? bx::min<uint8_t>(request.skipMips, numMips - 1) : 0;
+
+			// Not evicted before it has been drawn
+			if (TextureResidency* residency = getTextureResidency())
+			{
+				residency->touch(texture.get());
+			}
+		}
+	}
+
+	uint32_t TextureStreamer::getNumPending() const
+	{
+		return m_numPending;
+	}
+
+	uint32_t TextureStreamer::getNumUploaded() const
+	{
+		return m_numUploaded;
+	}
+
+	uint32_t TextureStreamer::getUploadedSize() const
+	{
+		return m_uploadedSize;
+	}
+
+	void initTextureStreamer()
+	{
+		s_streamer = new TextureStreamer(getSettings().renderer.textureDecodeThreads);
+	}
+
+	void shutdownTextureStreamer()
+	{
+		delete s_streamer;
+		s_streamer = nullptr;
+	}
+
+	TextureStreamer* getTextureStreamer()
+	{
+		return s_streamer;
+	}
+
+} // namespace mge
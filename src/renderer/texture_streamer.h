@@ -0,0 +1,103 @@
+/*
+ * Copyright 2025 Marcus Nesse Madland. All rights reserved.
+ * License: https://github.com/marcusnessemadland/mge/blob/main/LICENSE
+ */
+
+#pragma once
+
+#include <bgfx/bgfx.h>
+#include <bimg/bimg.h>
+#include <bx/allocator.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mge
+{
+	class Texture;
+
+	/// Asynchronous texture loader.
+	/// 
+	/// Files are read and decoded on a pool of decode threads. Decoded images 
+	/// are uploaded on the API thread in `update`, limited by a per-frame byte 
+	/// budget. Until then the texture handle stays invalid, which renders with 
+	/// the default texture.
+	/// 
+	class TextureStreamer
+	{
+		struct Request
+		{
+			std::weak_ptr<Texture> texture;
+			std::string filepath;
+			uint64_t flags;
+			uint8_t skipMips;
+			bimg::ImageContainer* image; // Null until decoded
+		};
+
+		void decode();
+
+	public:
+		TextureStreamer(uint32_t _numThreads);
+		~TextureStreamer();
+
+		/// Queue a texture for loading.
+		/// 
+		/// @param[in] _texture Texture to load, filepath must be set.
+		/// @param[in] _skipMips Number of top mips to leave out.
+		/// @param[in] _flags Texture creation flags.
+		/// 
+		/// @remark The current handle of the texture is kept until the new one is uploaded.
+		/// 
+		void request(std::shared_ptr<Texture> _texture, uint8_t _skipMips = 0, uint64_t _flags = BGFX_TEXTURE_NONE | BGFX_SAMPLER_NONE);
+
+		/// Create textures for decoded images. Must be called on the API thread.
+		/// 
+		/// @param[in] _budget Max bytes to upload, at least one texture is uploaded.
+		/// 
+		void update(uint32_t _budget);
+
+		/// Get number of textures that are not uploaded yet.
+		/// 
+		uint32_t getNumPending() const;
+
+		/// Get number of textures uploaded in the last update.
+		/// 
+		uint32_t getNumUploaded() const;
+
+		/// Get number of bytes uploaded in the last update.
+		/// 
+		uint32_t getUploadedSize() const;
+
+	private:
+		bx::DefaultAllocator m_allocator;
+		std::vector<std::thread> m_threads;
+
+		std::deque<Request> m_requests;
+		std::mutex m_requestMutex;
+		std::condition_variable m_requestCv;
+
+		std::deque<Request> m_decoded;
+		std::mutex m_decodedMutex;
+
+		std::atomic<uint32_t> m_numPending;
+		uint32_t m_numUploaded;
+		uint32_t m_uploadedSize;
+		bool m_shutdown;
+	};
+
+	void initTextureStreamer();
+	void shutdownTextureStreamer();
+
+	/// Get the texture streamer.
+	/// 
+	/// @returns Texture streamer, nullptr if no renderer has been created.
+	/// 
+	TextureStreamer* getTextureStreamer();
+
+} // namespace mge
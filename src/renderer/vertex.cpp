@@ -5,8 +5,50 @@
 
 #include "engine/vertex.h"
 
+#include <bx/math.h>
+
 namespace mge
 {
+	static constexpr float kMaxPackedExtent = 1024.0f; // Largest mesh size packed, positions have 16 bits of precision
+	static constexpr float kMaxPackedTexcoord = 4.0f; // Largest texcoord packed, half floats lose precision above
+
+	static int16_t packSnorm16(float _value)
+	{
+		return (int16_t)bx::round(clampf(_value, -1.0f, 1.0f) * 32767.0f);
+	}
+
+	static uint8_t packUnorm8(float _value)
+	{
+		return (uint8_t)bx::round(clampf(_value, 0.0f, 1.0f) * 255.0f);
+	}
+
+	// Octahedral encoding, "A Survey of Efficient Representations for Independent Unit Vectors"
+	static void packOctahedral(int16_t* _dst, Vec3 _v)
+	{
+		const float l1 = fabsf(_v.x) + fabsf(_v.y) + fabsf(_v.z);
+		if (l1 == 0.0f)
+		{
+			_dst[0] = 0;
+			_dst[1] = 0;
+			return;
+		}
+
+		float x = _v.x / l1;
+		float y = _v.y / l1;
+
+		// Fold the lower hemisphere over the diagonals
+		if (_v.z < 0.0f)
+		{
+			const float foldX = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+			const float foldY = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+			x = foldX;
+			y = foldY;
+		}
+
+		_dst[0] = packSnorm16(x);
+		_dst[1] = packSnorm16(y);
+	}
+
 	void Vertex::init()
 	{
 		ms_layout
@@ -24,5 +66,86 @@ namespace mge
 
 	bgfx::VertexLayout Vertex::ms_layout;
 
-} // namespace mge
+	void PackedVertex::init()
+	{
+		ms_layout
+			.begin()
+			.add(bgfx::Attrib::Position, 4, bgfx::AttribType::Int16, true)
+			.add(bgfx::Attrib::Normal, 4, bgfx::AttribType::Int16, true)
+			.add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Half)
+			.add(bgfx::Attrib::Weight, 4, bgfx::AttribType::Uint8, true)
+			.add(bgfx::Attrib::Indices, 4, bgfx::AttribType::Uint8)
+			.add(bgfx::Attrib::TexCoord1, 2, bgfx::AttribType::Half)
+			.end();
+	};
 
+	bgfx::VertexLayout PackedVertex::ms_layout;
+
+	void packVertices(PackedVertex* _dst, const Vertex* _src, uint32_t _numVertices, const Aabb& _bounds)
+	{
+		const Vec3 center = aabb_center(_bounds);
+		const Vec3 extents = aabb_extents(_bounds);
+		const Vec3 invExtents(
+			extents.x > 0.0f ? 1.0f / extents.x : 0.0f,
+			extents.y > 0.0f ? 1.0f / extents.y : 0.0f,
+			extents.z > 0.0f ? 1.0f / extents.z : 0.0f);
+
+		for (uint32_t ii = 0; ii < _numVertices; ++ii)
+		{
+			const Vertex& src = _src[ii];
+			PackedVertex& dst = _dst[ii];
+
+			// Mirrored texcoords flip the bitangent
+			const float bitangentSign = dot(cross(src.normal, src.tangent), src.bitangent) < 0.0f ? -1.0f : 1.0f;
+
+			dst.position[0] = packSnorm16((src.position.x - center.x) * invExtents.x);
+			dst.position[1] = packSnorm16((src.position.y - center.y) * invExtents.y);
+			dst.position[2] = packSnorm16((src.position.z - center.z) * invExtents.z);
+			dst.position[3] = packSnorm16(bitangentSign);
+
+			packOctahedral(&dst.normal[0], src.normal);
+			packOctahedral(&dst.normal[2], src.tangent);
+
+			dst.texcoord[0] = bx::halfFromFloat(src.texcoord.x);
+			dst.texcoord[1] = bx::halfFromFloat(src.texcoord.y);
+
+			for (uint32_t jj = 0; jj < 4; ++jj)
+			{
+				dst.weights[jj] = packUnorm8(src.weights[jj]);
+				dst.indices[jj] = src.indices[jj];
+			}
+
+			dst.displacement[0] = bx::halfFromFloat(src.displacement);
+			dst.displacement[1] = 0;
+		}
+	}
+
+	VertexFormat::Enum chooseVertexFormat(const Vertex* _vertices, uint32_t _numVertices)
+	{
+		if (_numVertices == 0)
+		{
+			return VertexFormat::Full;
+		}
+
+		Aabb bounds(_vertices[0].position, _vertices[0].position);
+		for (uint32_t ii = 0; ii < _numVertices; ++ii)
+		{
+			const Vertex& vertex = _vertices[ii];
+			if (fabsf(vertex.texcoord.x) > kMaxPackedTexcoord || fabsf(vertex.texcoord.y) > kMaxPackedTexcoord)
+			{
+				return VertexFormat::Full;
+			}
+
+			bounds = aabb_expand(bounds, vertex.position);
+		}
+
+		const Vec3 size = bounds.max - bounds.min;
+		if (maxf(size.x, maxf(size.y, size.z)) > kMaxPackedExtent)
+		{
+			return VertexFormat::Full;
+		}
+
+		return VertexFormat::Packed;
+	}
+
+} // namespace mge
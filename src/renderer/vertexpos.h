@@ -19,6 +19,7 @@ namespace mge
 		friend class Renderer;
 		friend class Deferred;
 		friend class ToneMapping;
+		friend class TemporalAA;
 
 		static void init();
 